@@ -76,17 +76,36 @@ function(BuildFFmpeg SOURCE_DIR BUILD_DIR INSTALL_DIR)
   # Platform-specific configuration and hardware acceleration
   set(HW_ACCEL_FLAGS)
   
-  message(STATUS "Linux detected - using CPU decoding only")
-  # Note: Hardware acceleration disabled for maximum compatibility
-  # VAAPI support requires libva-dev which may not be installed
-  # CPU decoding is sufficient for most use cases
+  if(NOT FFMPEG_HWACCEL)
+    message(STATUS "Linux detected - using CPU decoding only")
+    # Note: Hardware acceleration disabled by default for maximum compatibility
+    # Enable backends with -DFFMPEG_HWACCEL="vaapi;nvdec;qsv" (each requires its SDK/headers installed)
+  endif()
+  
+  foreach(HWACCEL IN LISTS FFMPEG_HWACCEL)
+    if(HWACCEL STREQUAL "vaapi")
+      # Requires libva-dev (libva, libva-drm)
+      message(STATUS "Enabling VAAPI hardware decoding")
+      list(APPEND HW_ACCEL_FLAGS --enable-vaapi)
+    elseif(HWACCEL STREQUAL "nvdec")
+      # Requires nv-codec-headers (ffnvcodec), CUDA driver is loaded at runtime
+      message(STATUS "Enabling NVDEC hardware decoding")
+      list(APPEND HW_ACCEL_FLAGS --enable-ffnvcodec --enable-cuda --enable-cuvid --enable-nvdec)
+    elseif(HWACCEL STREQUAL "qsv")
+      # Requires libvpl-dev (oneVPL dispatcher)
+      message(STATUS "Enabling Intel QSV hardware decoding")
+      list(APPEND HW_ACCEL_FLAGS --enable-libvpl)
+    else()
+      message(FATAL_ERROR "Unknown FFMPEG_HWACCEL backend '${HWACCEL}' - supported on Linux: vaapi, nvdec, qsv")
+    endif()
+  endforeach()
   
   # Threading optimizations
   set(THREADING_FLAGS --enable-pthreads)
   
   # Create hash from all parameters that affect the build
   # This ensures rebuild when configuration changes
-  string(SHA256 CONFIG_HASH "${SOURCE_DIR};${CMAKE_C_COMPILER};${CMAKE_CXX_COMPILER};${CMAKE_BUILD_TYPE};${CMAKE_SYSTEM_PROCESSOR};${OPT_CFLAGS};${SIMD_FLAGS}")
+  string(SHA256 CONFIG_HASH "${SOURCE_DIR};${CMAKE_C_COMPILER};${CMAKE_CXX_COMPILER};${CMAKE_BUILD_TYPE};${CMAKE_SYSTEM_PROCESSOR};${OPT_CFLAGS};${SIMD_FLAGS};${HW_ACCEL_FLAGS}")
   set(CHECKPOINT_NAME ${BUILD_DIR}/ffmpeg_build_${CONFIG_HASH})
   
   # Check if already built with this exact configuration
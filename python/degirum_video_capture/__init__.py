@@ -49,6 +49,9 @@ __version__ = _get_version()
 # Import from the C++ module
 from ._video_capture import (
     VideoCapture,
+    VideoCaptureGroup,
+    SharedFramePublisher,
+    SharedFrameSubscriber,
     CAP_PROP_POS_MSEC,
     CAP_PROP_POS_FRAMES,
     CAP_PROP_POS_AVI_RATIO,
@@ -57,10 +60,29 @@ from ._video_capture import (
     CAP_PROP_FPS,
     CAP_PROP_FOURCC,
     CAP_PROP_FRAME_COUNT,
+    CAP_PROP_RECONNECT_COUNT,
+    CAP_PROP_PACKETS_READ,
+    CAP_PROP_BYTES_READ,
+    CAP_PROP_FRAMES_DECODED,
+    CAP_PROP_FRAMES_DROPPED,
+    CAP_PROP_FRAMES_CONVERTED,
+    CAP_PROP_DEMUX_MSEC,
+    CAP_PROP_DECODE_MSEC,
+    CAP_PROP_CONVERT_MSEC,
+    allocation_count,
 )
 
+# asyncio interface, implemented in Python on top of try_read() / notify_when_ready()
+from . import _async
+
+VideoCapture.read_async = _async.read_async
+VideoCapture.frames = _async.frames
+
 __all__ = [
     'VideoCapture',
+    'VideoCaptureGroup',
+    'SharedFramePublisher',
+    'SharedFrameSubscriber',
     'CAP_PROP_POS_MSEC',
     'CAP_PROP_POS_FRAMES',
     'CAP_PROP_POS_AVI_RATIO',
@@ -69,4 +91,14 @@ __all__ = [
     'CAP_PROP_FPS',
     'CAP_PROP_FOURCC',
     'CAP_PROP_FRAME_COUNT',
+    'CAP_PROP_RECONNECT_COUNT',
+    'CAP_PROP_PACKETS_READ',
+    'CAP_PROP_BYTES_READ',
+    'CAP_PROP_FRAMES_DECODED',
+    'CAP_PROP_FRAMES_DROPPED',
+    'CAP_PROP_FRAMES_CONVERTED',
+    'CAP_PROP_DEMUX_MSEC',
+    'CAP_PROP_DECODE_MSEC',
+    'CAP_PROP_CONVERT_MSEC',
+    'allocation_count',
 ]
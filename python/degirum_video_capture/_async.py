@@ -0,0 +1,63 @@
+"""
+asyncio interface of VideoCapture
+
+Reads are woken by the prefetch thread through the event loop's own self-pipe
+(loop.call_soon_threadsafe), so many streams share one loop without a thread per stream.
+"""
+
+import asyncio
+
+
+def _wake(future):
+    """Complete a pending wait, unless it was cancelled meanwhile"""
+    if not future.done():
+        future.set_result(None)
+
+
+def _notifier(loop, future):
+    """Ready callback for the prefetch thread, scheduling _wake() on the loop"""
+
+    def notify():
+        try:
+            loop.call_soon_threadsafe(_wake, future)
+        except RuntimeError:
+            pass  # loop closed while the wait was pending
+
+    return notify
+
+
+async def read_async(self):
+    """Read the next frame without blocking the event loop
+
+    Open the capture with prefetch (or latest_frame / convert_threads) so the frame is decoded
+    ahead on the prefetch thread; without prefetch the read runs in the loop's default executor.
+
+    Returns:
+        tuple: (success: bool, frame), same as read()
+    """
+    loop = asyncio.get_running_loop()
+    if self.prefetch == 0:
+        return await loop.run_in_executor(None, self.read)
+
+    while True:
+        status, frame = self.try_read()
+        if status != 0:
+            return status > 0, frame
+
+        # A frame queued between try_read() and arming makes notify_when_ready() return False
+        future = loop.create_future()
+        if self.notify_when_ready(_notifier(loop, future)):
+            await future
+
+
+async def frames(self):
+    """Asynchronous iterator over the remaining frames: async for frame in capture.frames()
+
+    Yields:
+        frame: same as returned by read_async(), until the end of video
+    """
+    while True:
+        success, frame = await read_async(self)
+        if not success:
+            return
+        yield frame
@@ -7,7 +7,17 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 #include "../src/VideoCapture.h"
+#include "../src/VideoCaptureGroup.h"
+#include "../src/SharedFrameRing.h"
 #include "../src/opencv_enums.h"
+#include "../src/dlpack.h"
+#include <array>
+#include <cstdlib>
+
+extern "C"
+{
+#include <libavutil/pixdesc.h>
+}
 
 #define NUM_CHANNELS 3 // BGR24 format has 3 channels
 
@@ -15,41 +25,613 @@ namespace py = pybind11;
 
 namespace DG
 {
+    /// numpy dtype of frames of a layout
+    /// @param format Frame layout of a capture or shared ring
+    /// @return uint8 for image frames, otherwise the tensor element type
+    py::dtype output_dtype(const SharedFrameFormat &format)
+    {
+        const TensorDataType dtype = static_cast<TensorDataType>(format.tensor_dtype);
+        if (format.isTensor() && dtype == TensorDataType::Float32)
+            return py::dtype::of<float>();
+        if (format.isTensor() && dtype == TensorDataType::Float16)
+            return py::dtype("float16");
+        return py::dtype::of<uint8_t>();
+    }
+
+    /// Check if frames of a layout have 3-channel packed pixels (BGR24/RGB24 frames and NHWC tensors)
+    bool output_is_packed(const SharedFrameFormat &format)
+    {
+        if (format.isTensor())
+            return static_cast<TensorLayout>(format.tensor_layout) == TensorLayout::NHWC;
+        return format.pixel_format == AV_PIX_FMT_BGR24 || format.pixel_format == AV_PIX_FMT_RGB24;
+    }
+
+    /// Shape of one frame of a layout when stored in one array
+    /// @param format Frame layout of a capture or shared ring
+    /// @return (3, height, width) for NCHW tensors, (height, width, 3) for packed pixels,
+    ///         (height, width) for GRAY8 and (height * 3/2, width) for NV12/YUV420P (OpenCV layout)
+    std::vector<ssize_t> output_shape(const SharedFrameFormat &format)
+    {
+        const ssize_t height = format.height;
+        const ssize_t width = format.width;
+        if (output_is_packed(format))
+            return {height, width, NUM_CHANNELS};
+        if (format.isTensor())
+            return {NUM_CHANNELS, height, width};
+        return {format.rows, width};
+    }
+
+    /// Byte strides of one frame of a layout when stored in one array
+    /// @param format Frame layout of a capture or shared ring
+    /// @param linesize Distance in bytes between rows (rows of one channel plane for NCHW)
+    /// @return Strides matching output_shape(), with NCHW channel planes format.height rows apart
+    std::vector<ssize_t> output_strides(const SharedFrameFormat &format, ssize_t linesize)
+    {
+        const ssize_t elem_size = format.isTensor() ? static_cast<ssize_t>(tensorElementSize(static_cast<TensorDataType>(format.tensor_dtype))) : 1;
+        if (output_is_packed(format))
+            return {linesize, NUM_CHANNELS * elem_size, elem_size};
+        if (format.isTensor())
+            return {linesize * format.height, linesize, elem_size};
+        return {linesize, 1};
+    }
+
+    py::dtype output_dtype(const VideoCapture &cap) { return output_dtype(SharedFrameFormat::of(cap)); }
+    std::vector<ssize_t> output_shape(const VideoCapture &cap) { return output_shape(SharedFrameFormat::of(cap)); }
+    std::vector<ssize_t> output_strides(const VideoCapture &cap, ssize_t linesize) { return output_strides(SharedFrameFormat::of(cap), linesize); }
+
+    /// Empty AVFrame shells recycled between reads: a shell is handed to the frame's Python object and comes back
+    /// when that object is released, so steady-state reads allocate no FFmpeg objects
+    class FrameShellPool
+    {
+    public:
+        /// Take an empty frame shell, allocated only when none is free
+        /// @return Shell to give back with release(), nullptr if out of memory
+        AVFrame *acquire()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_free.empty())
+                {
+                    AVFrame *frame = m_free.back();
+                    m_free.pop_back();
+                    return frame;
+                }
+            }
+            return allocFrame();
+        }
+
+        /// Give a frame shell back, dropping its buffer references
+        /// @param frame Shell taken with acquire() (may be nullptr); may be called from any thread (DLPack deleters)
+        void release(AVFrame *frame)
+        {
+            if (!frame)
+                return;
+            av_frame_unref(frame);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_free.size() < MAX_FREE)
+                m_free.push_back(frame);
+            else
+                av_frame_free(&frame);
+        }
+
+        /// Pool shared by all captures, never destroyed since arrays may outlive the module at interpreter exit
+        static FrameShellPool &instance()
+        {
+            static FrameShellPool *pool = new FrameShellPool();
+            return *pool;
+        }
+
+    private:
+        static constexpr size_t MAX_FREE = 256; //!< Free shells kept, more are freed (e.g. after a large read_all)
+        std::mutex m_mutex;                     //!< Protects m_free
+        std::vector<AVFrame *> m_free;          //!< Shells holding no buffers
+    };
+
+    /// Capsule owning a frame shell until the numpy arrays referencing its data are garbage collected,
+    /// at which point its buffer is returned to the capture's pool and the shell to the FrameShellPool
+    py::capsule frame_capsule(AVFrame *src)
+    {
+        return py::capsule(src, [](void *p)
+                           { FrameShellPool::instance().release(reinterpret_cast<AVFrame *>(p)); });
+    }
+
+    /// Convert an image frame (main output or rendition) to numpy arrays with zero-copy, shape taken from the frame itself
+    ///
+    /// @param src Frame in an output pixel format (BGR24, RGB24, GRAY8, NV12, YUV420P), ownership is transferred to the returned array(s)
+    /// @return py::array (height, width, 3) for BGR24/RGB24 and (height, width) for GRAY8, or for NV12/YUV420P a tuple of plane
+    ///         arrays (y, uv) / (y, u, v), since decoded frames passed through keep their planes in separate buffers
+    py::object image_to_numpy(AVFrame *src)
+    {
+        auto capsule = frame_capsule(src);
+
+        // Planar YUV: one array per plane, all keeping the frame alive through the same capsule
+        const AVPixelFormat format = static_cast<AVPixelFormat>(src->format);
+        if (av_pix_fmt_count_planes(format) > 1)
+        {
+            const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(format);
+            const ssize_t chroma_width = (src->width + (1 << desc->log2_chroma_w) - 1) >> desc->log2_chroma_w;
+            const ssize_t chroma_height = (src->height + (1 << desc->log2_chroma_h) - 1) >> desc->log2_chroma_h;
+            const py::dtype dtype = py::dtype::of<uint8_t>();
+
+            py::array y(dtype, {static_cast<ssize_t>(src->height), static_cast<ssize_t>(src->width)},
+                        {static_cast<ssize_t>(src->linesize[0]), static_cast<ssize_t>(1)}, src->data[0], capsule);
+            if (format == AV_PIX_FMT_NV12)
+            {
+                py::array uv(dtype, {chroma_height, chroma_width, static_cast<ssize_t>(2)},
+                             {static_cast<ssize_t>(src->linesize[1]), static_cast<ssize_t>(2), static_cast<ssize_t>(1)}, src->data[1], capsule);
+                return py::make_tuple(y, uv);
+            }
+            py::array u(dtype, {chroma_height, chroma_width}, {static_cast<ssize_t>(src->linesize[1]), static_cast<ssize_t>(1)}, src->data[1], capsule);
+            py::array v(dtype, {chroma_height, chroma_width}, {static_cast<ssize_t>(src->linesize[2]), static_cast<ssize_t>(1)}, src->data[2], capsule);
+            return py::make_tuple(y, u, v);
+        }
+
+        const ssize_t height = src->height;
+        const ssize_t width = src->width;
+        const ssize_t linesize = src->linesize[0];
+        if (format == AV_PIX_FMT_GRAY8)
+            return py::array(py::dtype::of<uint8_t>(), {height, width}, {linesize, static_cast<ssize_t>(1)}, src->data[0], capsule);
+        return py::array(py::dtype::of<uint8_t>(), {height, width, static_cast<ssize_t>(NUM_CHANNELS)},
+                         {linesize, static_cast<ssize_t>(NUM_CHANNELS), static_cast<ssize_t>(1)}, src->data[0], capsule);
+    }
+
     /// Convert AVFrame to numpy array with zero-copy (frame lifecycle tied to array)
     ///
     /// This function creates a numpy array that directly references the AVFrame's data buffer.
-    /// The AVFrame is kept alive via a Python capsule until the numpy array is garbage collected.
+    /// The AVFrame is owned by a Python capsule until the numpy array is garbage collected.
+    ///
+    /// @param src AVFrame read from cap (image or tensor), ownership is transferred to the returned array(s)
+    /// @param cap Capture the frame was read from, gives tensor shape and element type
+    /// @return py::array numpy array referencing the frame data, or for NV12/YUV420P a tuple of plane arrays (see image_to_numpy())
+    py::object frame_to_numpy(AVFrame *src, const VideoCapture &cap)
+    {
+        if (!cap.options().tensor.enabled)
+            return image_to_numpy(src);
+
+        // Create and return numpy array: (height, width, 3) HWC tensor, (3, height, width) CHW tensor
+        auto capsule = frame_capsule(src);
+        return py::array(output_dtype(cap),
+                         output_shape(cap),
+                         output_strides(cap, src->linesize[0]),
+                         src->data[0],
+                         capsule); // Pass the capsule to keep the AVFrame alive
+    }
+
+    /// Read-only numpy array viewing a frame pinned in a shared ring, zero-copy (the slot stays pinned until the array is released)
     ///
-    /// @param src AVFrame to convert (must be BGR24 format)
-    /// @return py::array numpy array referencing the frame data
-    py::array frame_to_numpy_bgr(AVFrame *src)
+    /// @param frame Pinned frame, ownership is transferred to the returned array
+    /// @param format Frame layout of the ring
+    /// @return py::array of the publisher's frame shape and dtype; NV12/YUV420P frames are one (height * 3/2, width) array
+    py::array shared_frame_to_numpy(SharedFrame &&frame, const SharedFrameFormat &format)
     {
-        // Create a reference-counted copy to keep buffer alive
-        AVFrame *keep = av_frame_alloc();
-        if (av_frame_ref(keep, src) < 0)
+        // Slot is shared with other consumers, the array must not write it
+        auto *held = new SharedFrame(std::move(frame));
+        py::capsule capsule(held, [](void *p)
+                            { delete static_cast<SharedFrame *>(p); });
+        py::array array(output_dtype(format), output_shape(format), output_strides(format, format.linesize), held->data(), capsule);
+        array.attr("setflags")(py::arg("write") = false);
+        return array;
+    }
+
+    /// DLPack tensor for one plane of a device frame, owns a frame reference until the consumer releases the tensor
+    struct DLPackPlane
+    {
+        DLManagedTensor tensor; //!< Tensor handed to the consumer (manager_ctx points back to this struct)
+        int64_t shape[3];       //!< Plane shape: rows, columns[, interleaved components]
+        int64_t strides[3];     //!< Plane strides in elements
+        AVFrame *frame;         //!< Frame reference keeping the device surface alive
+    };
+
+    /// Wrap one plane of a CUDA frame into a DLPack capsule with zero-copy (frame lifecycle tied to the tensor)
+    ///
+    /// @param src CUDA hardware frame
+    /// @param plane Plane index in src->data
+    /// @param height Plane height in rows
+    /// @param width Plane width in pixels
+    /// @param components Interleaved components per pixel (1 = 2-D tensor, otherwise 3-D tensor)
+    /// @param elem_size Component size in bytes (1 or 2)
+    /// @param device_id CUDA device ordinal holding the frame
+    /// @return py::object "dltensor" capsule as defined by the DLPack Python protocol
+    py::object frame_plane_to_dlpack(const AVFrame *src, int plane, int height, int width, int components, int elem_size, int device_id)
+    {
+        // Create a reference-counted copy to keep the device surface alive
+        AVFrame *keep = FrameShellPool::instance().acquire();
+        if (!keep || av_frame_ref(keep, src) < 0)
+        {
+            FrameShellPool::instance().release(keep);
             throw std::runtime_error("av_frame_ref failed");
+        }
+
+        auto *ctx = new DLPackPlane();
+        ctx->frame = keep;
+        ctx->shape[0] = height;
+        ctx->shape[1] = width;
+        ctx->shape[2] = components;
+        ctx->strides[0] = keep->linesize[plane] / elem_size;
+        ctx->strides[1] = components;
+        ctx->strides[2] = 1;
+
+        DLTensor &tensor = ctx->tensor.dl_tensor;
+        tensor.data = keep->data[plane];
+        tensor.device = {kDLCUDA, device_id};
+        tensor.ndim = components > 1 ? 3 : 2;
+        tensor.dtype = {static_cast<uint8_t>(kDLUInt), static_cast<uint8_t>(elem_size * 8), 1};
+        tensor.shape = ctx->shape;
+        tensor.strides = ctx->strides;
+        tensor.byte_offset = 0;
+        ctx->tensor.manager_ctx = ctx;
+        ctx->tensor.deleter = [](DLManagedTensor *self)
+        {
+            auto *ctx = static_cast<DLPackPlane *>(self->manager_ctx);
+            FrameShellPool::instance().release(ctx->frame);
+            delete ctx;
+        };
+
+        // Consumer renames the capsule to "used_dltensor" and becomes responsible for calling the deleter
+        PyObject *capsule = PyCapsule_New(&ctx->tensor, "dltensor", [](PyObject *cap)
+                                          {
+            if (PyCapsule_IsValid(cap, "dltensor")) {
+                auto *tensor = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(cap, "dltensor"));
+                tensor->deleter(tensor);
+            } });
+        if (!capsule)
+        {
+            ctx->tensor.deleter(&ctx->tensor);
+            throw py::error_already_set();
+        }
+        return py::reinterpret_steal<py::object>(capsule);
+    }
+
+    /// Export a decoded CUDA frame as DLPack capsules of its luma and interleaved chroma planes
+    ///
+    /// @param src CUDA hardware frame with NV12 (8-bit) or P010/P016 (16-bit) surface layout
+    /// @param device_id CUDA device ordinal holding the frame
+    /// @return py::tuple (y, uv): y is (height, width), uv is (height/2, width/2, 2), both uint8 or uint16
+    py::tuple frame_to_dlpack_nv12(const AVFrame *src, int device_id)
+    {
+        const AVHWFramesContext *frames = src->hw_frames_ctx ? reinterpret_cast<const AVHWFramesContext *>(src->hw_frames_ctx->data) : nullptr;
+        const AVPixFmtDescriptor *desc = frames ? av_pix_fmt_desc_get(frames->sw_format) : nullptr;
+        if (src->format != AV_PIX_FMT_CUDA || !desc || desc->nb_components != 3 || av_pix_fmt_count_planes(frames->sw_format) != 2)
+            throw std::runtime_error("Device output is supported for CUDA frames with NV12/P010 layout only");
+
+        // Luma component step gives the element size: 1 byte for NV12, 2 bytes for P010/P016
+        const int elem_size = desc->comp[0].step;
+        const int chroma_width = (src->width + (1 << desc->log2_chroma_w) - 1) >> desc->log2_chroma_w;
+        const int chroma_height = (src->height + (1 << desc->log2_chroma_h) - 1) >> desc->log2_chroma_h;
+
+        return py::make_tuple(
+            frame_plane_to_dlpack(src, 0, src->height, src->width, 1, elem_size, device_id),
+            frame_plane_to_dlpack(src, 1, chroma_height, chroma_width, 2, elem_size, device_id));
+    }
+
+    /// Per-channel values of a tensor option given as a sequence of 3 numbers
+    /// @param value Python sequence, e.g. (123.675, 116.28, 103.53)
+    /// @param key Option name for the error message
+    /// @return Values in output channel order
+    std::array<float, 3> cast_channels(const py::handle &value, const std::string &key)
+    {
+        const py::sequence seq = py::reinterpret_borrow<py::sequence>(value);
+        if (!py::isinstance<py::sequence>(value) || py::len(seq) != 3)
+            throw py::value_error("VideoCapture option '" + key + "' must be a sequence of 3 numbers");
+        return {seq[0].cast<float>(), seq[1].cast<float>(), seq[2].cast<float>()};
+    }
+
+    /// CUDA device ordinal selected by a "cuda[:N]" hw_device option (FFmpeg parses the device string the same way)
+    int cuda_device_index(const std::string &hw_device)
+    {
+        const size_t colon = hw_device.find(':');
+        return colon == std::string::npos ? 0 : std::atoi(hw_device.c_str() + colon + 1);
+    }
+
+    /// Hold the call lock of a capture for a whole binding, so another thread cannot close or reopen it in between
+    /// @param cap Capture to lock
+    /// @return Lock of cap, waited for without the GIL (the thread holding it may need the GIL to finish)
+    std::unique_lock<std::recursive_mutex> lock_capture(const VideoCapture &cap)
+    {
+        py::gil_scoped_release release;
+        return cap.lockCalls();
+    }
+
+    /// Deleter of captures owned by Python objects: closing joins the prefetch thread, which may be waiting for the GIL
+    /// to run a ready callback, so the capture is destroyed without the GIL
+    struct CaptureDeleter
+    {
+        void operator()(VideoCapture *cap) const
+        {
+            py::gil_scoped_release release;
+            delete cap;
+        }
+    };
+    using CapturePtr = std::unique_ptr<VideoCapture, CaptureDeleter>;
+
+    /// Python object of a frame read from a capture, taking ownership of the frame
+    /// @param frame Frame read from cap (taken from the FrameShellPool, given back here or when the returned object is released)
+    /// @param cap Capture the frame was read from
+    /// @return numpy array (or tuple of plane arrays), or a tuple (y, uv) of DLPack capsules for device_output;
+    ///         with renditions a tuple of the main output followed by each rendition
+    py::object frame_to_python(AVFrame *frame, const VideoCapture &cap)
+    {
+        // Device frame: export planes via DLPack, data never leaves GPU memory
+        if (cap.options().device_output)
+        {
+            py::tuple planes;
+            try
+            {
+                planes = frame_to_dlpack_nv12(frame, cuda_device_index(cap.options().hw_device));
+            }
+            catch (...)
+            {
+                FrameShellPool::instance().release(frame);
+                throw;
+            }
+            FrameShellPool::instance().release(frame);
+            return planes;
+        }
+
+        // Renditions: each array keeps its own reference to its rendition frame
+        const size_t count = cap.options().renditions.size();
+        if (count == 0)
+            return frame_to_numpy(frame, cap);
+        py::tuple outputs(count + 1);
+        for (size_t i = 0; i < count; i++)
+        {
+            const AVFrame *rendition = VideoCapture::renditionFrame(frame, static_cast<int>(i));
+            AVFrame *shell = FrameShellPool::instance().acquire();
+            if (!rendition || !shell || av_frame_ref(shell, rendition) < 0)
+            {
+                FrameShellPool::instance().release(shell);
+                FrameShellPool::instance().release(frame);
+                throw std::runtime_error("Failed to reference rendition frame");
+            }
+            outputs[i + 1] = image_to_numpy(shell);
+        }
+
+        // The main array no longer keeps the renditions alive
+        av_buffer_unref(&frame->opaque_ref);
+        outputs[0] = frame_to_numpy(frame, cap);
+        return outputs;
+    }
 
-        // Create a capsule that will free the AVFrame when the numpy array is garbage collected
-        auto capsule = py::capsule(keep, [](void *p)
-                                   {
-            AVFrame* f = reinterpret_cast<AVFrame*>(p);
-            av_frame_free(&f); });
-
-        // Calculate strides for numpy array (in bytes)
-        std::vector<ssize_t> strides = {
-            static_cast<ssize_t>(src->linesize[0]),
-            static_cast<ssize_t>(NUM_CHANNELS),
-            static_cast<ssize_t>(1)};
-
-        // Create and return numpy array
-        return py::array(py::buffer_info(
-                             src->data[0],                             // pointer to data
-                             1,                                        // item size (1 byte for uint8_t)
-                             py::format_descriptor<uint8_t>::format(), // format (uint8)
-                             3,                                        // height, width, channels
-                             {src->height, src->width, NUM_CHANNELS},  // shape of data
-                             strides),                                 // strides for each dimension
-                         capsule);                                     // Pass the capsule to keep the AVFrame alive
+    /// Summary of one stage latency histogram
+    /// @param histogram Decode or convert latencies
+    /// @return dict of count, total_ms, mean_us, p50_us, p90_us, p99_us, max_us and histogram
+    ///         (list of (bucket start in us, count) pairs of the non-empty power-of-two buckets)
+    py::dict latency_to_python(const LatencyHistogram &histogram)
+    {
+        const uint64_t count = histogram.count();
+        py::list buckets;
+        for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+        {
+            if (histogram.bucket(i) > 0)
+                buckets.append(py::make_tuple(LatencyHistogram::bucketStartUs(i), histogram.bucket(i)));
+        }
+
+        py::dict result;
+        result["count"] = count;
+        result["total_ms"] = static_cast<double>(histogram.totalNs()) / 1e6;
+        result["mean_us"] = count > 0 ? static_cast<double>(histogram.totalNs()) / 1e3 / static_cast<double>(count) : 0.0;
+        result["p50_us"] = histogram.percentileUs(0.5);
+        result["p90_us"] = histogram.percentileUs(0.9);
+        result["p99_us"] = histogram.percentileUs(0.99);
+        result["max_us"] = static_cast<double>(histogram.maxNs()) / 1e3;
+        result["histogram"] = buckets;
+        return result;
+    }
+
+    /// Per-stage statistics of a capture as a Python dict
+    /// @param cap Capture to describe (its counters may advance while they are read)
+    /// @return dict of packet, byte and frame counters, demux time and decode / convert latency summaries; empty if compiled out
+    py::dict stats_to_python(const VideoCapture &cap)
+    {
+        py::dict result;
+        if (!CaptureStats::enabled)
+            return result;
+
+        const CaptureStats &stats = cap.stats();
+        result["packets_read"] = stats.packets_read.load(std::memory_order_relaxed);
+        result["bytes_read"] = stats.bytes_read.load(std::memory_order_relaxed);
+        result["frames_decoded"] = stats.decode.count();
+        result["frames_dropped"] = stats.frames_dropped.load(std::memory_order_relaxed);
+        result["frames_converted"] = stats.convert.count();
+        result["demux_ms"] = static_cast<double>(stats.demux_ns.load(std::memory_order_relaxed)) / 1e6;
+        result["decode"] = latency_to_python(stats.decode);
+        result["convert"] = latency_to_python(stats.convert);
+        return result;
+    }
+
+    /// Build VideoCaptureOptions from resize arguments and keyword options shared by the constructor and open()
+    ///
+    /// @param width Target width for resized frames (0 = no resize)
+    /// @param height Target height for resized frames (0 = no resize)
+    /// @param kwargs Additional keyword options (pixel_format, prefetch, hw_device, device_output, tensor, layout, dtype, channel_order, mean, std, frame_index, index_path, frame_step, target_fps, skip_frame, live, rtsp_transport, timeout_ms, latest_frame, reconnect_attempts, reconnect_delay_ms, decoder_threads, thread_type, cpu_affinity, numa_node, convert_threads, crop, lowres, renditions, probesize, analyze_duration_ms, input_format, fast_open, memory_map)
+    /// @return VideoCaptureOptions filled from the arguments
+    VideoCaptureOptions make_options(int width, int height, const py::kwargs &kwargs)
+    {
+        VideoCaptureOptions options;
+        options.target_width = width;
+        options.target_height = height;
+
+        for (auto item : kwargs)
+        {
+            const std::string key = py::str(item.first);
+            if (key == "prefetch")
+                options.prefetch = item.second.cast<int>();
+            else if (key == "hw_device")
+                options.hw_device = item.second.cast<std::string>();
+            else if (key == "device_output")
+                options.device_output = item.second.cast<bool>();
+            else if (key == "pixel_format")
+            {
+                const std::string name = item.second.cast<std::string>();
+                options.pixel_format = av_get_pix_fmt(name.c_str());
+                if (options.pixel_format == AV_PIX_FMT_NONE)
+                    throw py::value_error("Unknown pixel_format '" + name + "'");
+            }
+            else if (key == "tensor")
+                options.tensor.enabled = item.second.cast<bool>();
+            else if (key == "layout")
+            {
+                const std::string layout = item.second.cast<std::string>();
+                if (layout == "nchw")
+                    options.tensor.layout = TensorLayout::NCHW;
+                else if (layout == "nhwc")
+                    options.tensor.layout = TensorLayout::NHWC;
+                else
+                    throw py::value_error("layout must be 'nchw' or 'nhwc'");
+            }
+            else if (key == "dtype")
+            {
+                const std::string dtype = py::str(py::dtype::from_args(item.second));
+                if (dtype == "uint8")
+                    options.tensor.dtype = TensorDataType::UInt8;
+                else if (dtype == "float16")
+                    options.tensor.dtype = TensorDataType::Float16;
+                else if (dtype == "float32")
+                    options.tensor.dtype = TensorDataType::Float32;
+                else
+                    throw py::value_error("dtype must be uint8, float16 or float32");
+            }
+            else if (key == "channel_order")
+            {
+                const std::string order = item.second.cast<std::string>();
+                if (order != "rgb" && order != "bgr")
+                    throw py::value_error("channel_order must be 'rgb' or 'bgr'");
+                options.tensor.rgb = order == "rgb";
+            }
+            else if (key == "mean")
+                options.tensor.mean = cast_channels(item.second, key);
+            else if (key == "std")
+                options.tensor.stddev = cast_channels(item.second, key);
+            else if (key == "frame_index")
+                options.frame_index = item.second.cast<bool>();
+            else if (key == "index_path")
+                options.index_path = item.second.cast<std::string>();
+            else if (key == "frame_step")
+                options.frame_step = item.second.cast<int>();
+            else if (key == "target_fps")
+                options.target_fps = item.second.cast<double>();
+            else if (key == "skip_frame")
+            {
+                const std::string skip = item.second.cast<std::string>();
+                if (skip == "default")
+                    options.skip_frame = AVDISCARD_DEFAULT;
+                else if (skip == "nonref")
+                    options.skip_frame = AVDISCARD_NONREF;
+                else if (skip == "nonkey")
+                    options.skip_frame = AVDISCARD_NONKEY;
+                else
+                    throw py::value_error("skip_frame must be 'default', 'nonref' or 'nonkey'");
+            }
+            else if (key == "live")
+                options.live = item.second.cast<bool>();
+            else if (key == "rtsp_transport")
+                options.rtsp_transport = item.second.cast<std::string>();
+            else if (key == "timeout_ms")
+                options.timeout_ms = item.second.cast<int>();
+            else if (key == "latest_frame")
+                options.latest_frame = item.second.cast<bool>();
+            else if (key == "reconnect_attempts")
+                options.reconnect_attempts = item.second.cast<int>();
+            else if (key == "reconnect_delay_ms")
+                options.reconnect_delay_ms = item.second.cast<int>();
+            else if (key == "decoder_threads")
+                options.decoder_threads = item.second.cast<int>();
+            else if (key == "thread_type")
+            {
+                const std::string type = item.second.cast<std::string>();
+                if (type == "auto")
+                    options.thread_type = 0;
+                else if (type == "frame")
+                    options.thread_type = FF_THREAD_FRAME;
+                else if (type == "slice")
+                    options.thread_type = FF_THREAD_SLICE;
+                else if (type == "frame+slice")
+                    options.thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+                else
+                    throw py::value_error("thread_type must be 'auto', 'frame', 'slice' or 'frame+slice'");
+            }
+            else if (key == "cpu_affinity")
+            {
+                if (!py::isinstance<py::sequence>(item.second) || py::isinstance<py::str>(item.second))
+                    throw py::value_error("VideoCapture option 'cpu_affinity' must be a sequence of CPU numbers");
+                options.cpu_affinity.clear();
+                for (auto cpu : py::reinterpret_borrow<py::sequence>(item.second))
+                {
+                    options.cpu_affinity.push_back(cpu.cast<int>());
+                    if (options.cpu_affinity.back() < 0)
+                        throw py::value_error("VideoCapture option 'cpu_affinity' must hold non-negative CPU numbers");
+                }
+            }
+            else if (key == "numa_node")
+                options.numa_node = item.second.cast<int>();
+            else if (key == "convert_threads")
+                options.convert_threads = item.second.cast<int>();
+            else if (key == "crop")
+            {
+                const py::sequence crop = py::reinterpret_borrow<py::sequence>(item.second);
+                if (!py::isinstance<py::sequence>(item.second) || py::len(crop) != 4)
+                    throw py::value_error("VideoCapture option 'crop' must be a sequence (x, y, width, height)");
+                options.crop_x = crop[0].cast<int>();
+                options.crop_y = crop[1].cast<int>();
+                options.crop_width = crop[2].cast<int>();
+                options.crop_height = crop[3].cast<int>();
+                if (options.crop_x < 0 || options.crop_y < 0 || options.crop_width <= 0 || options.crop_height <= 0)
+                    throw py::value_error("VideoCapture option 'crop' must have a non-negative origin and a positive size");
+            }
+            else if (key == "probesize")
+                options.probesize = item.second.cast<int64_t>();
+            else if (key == "analyze_duration_ms")
+                options.analyze_duration_ms = item.second.cast<int>();
+            else if (key == "input_format")
+                options.input_format = item.second.cast<std::string>();
+            else if (key == "fast_open")
+                options.fast_open = item.second.cast<bool>();
+            else if (key == "renditions")
+            {
+                if (!py::isinstance<py::sequence>(item.second) || py::isinstance<py::str>(item.second))
+                    throw py::value_error("VideoCapture option 'renditions' must be a sequence of dicts");
+                for (auto entry : py::reinterpret_borrow<py::sequence>(item.second))
+                {
+                    if (!py::isinstance<py::dict>(entry))
+                        throw py::value_error("VideoCapture option 'renditions' must be a sequence of dicts");
+                    RenditionSpec spec;
+                    for (auto field : py::reinterpret_borrow<py::dict>(entry))
+                    {
+                        const std::string name = py::str(field.first);
+                        if (name == "width")
+                            spec.width = field.second.cast<int>();
+                        else if (name == "height")
+                            spec.height = field.second.cast<int>();
+                        else if (name == "letterbox")
+                            spec.letterbox = field.second.cast<bool>();
+                        else if (name == "pixel_format")
+                        {
+                            const std::string format = field.second.cast<std::string>();
+                            spec.pixel_format = av_get_pix_fmt(format.c_str());
+                            if (spec.pixel_format == AV_PIX_FMT_NONE)
+                                throw py::value_error("Unknown rendition pixel_format '" + format + "'");
+                        }
+                        else
+                            throw py::type_error("Unknown rendition field '" + name + "'");
+                    }
+                    options.renditions.push_back(spec);
+                }
+            }
+            else if (key == "memory_map")
+                options.memory_map = item.second.cast<bool>();
+            else if (key == "lowres")
+            {
+                if (py::isinstance<py::str>(item.second) && item.second.cast<std::string>() == "auto")
+                    options.lowres = -1;
+                else if (py::isinstance<py::int_>(item.second) && item.second.cast<int>() >= 0)
+                    options.lowres = item.second.cast<int>();
+                else
+                    throw py::value_error("VideoCapture option 'lowres' must be 'auto' or a non-negative int");
+            }
+            else
+                throw py::type_error("Unknown VideoCapture option '" + key + "'");
+        }
+        return options;
     }
 
 } // namespace DG
@@ -59,108 +641,634 @@ PYBIND11_MODULE(_video_capture, m)
 {
     m.doc() = "DeGirum Video Capture - FFmpeg-based video reading library";
 
-    py::class_<DG::VideoCapture>(m, "VideoCapture")
+    py::class_<DG::VideoCapture, DG::CapturePtr>(m, "VideoCapture")
         // Default constructor (no args) -> VideoCapture
         .def(py::init([]()
-                      { return std::make_unique<DG::VideoCapture>(); }),
+                      { return DG::CapturePtr(new DG::VideoCapture()); }),
              "Create a new VideoCapture object")
 
-        // Constructor with filename only -> VideoCapture
-        .def(py::init([](const char *filename)
-                      { return std::make_unique<DG::VideoCapture>(filename); }),
-             py::arg("filename"),
-             "Create and open a video file\n\n"
-             "Args:\n"
-             "    filename (str): Path to the video file")
-
-        // Constructor with filename, width, height -> VideoCapture with resize
-        .def(py::init([](const char *filename, int width, int height)
-                      { return std::make_unique<DG::VideoCapture>(filename, width, height); }),
-             py::arg("filename"), py::arg("width"), py::arg("height"),
-             "Create and open a video file with resizing\n\n"
+        // Constructor with filename, optional width, height and options -> VideoCapture
+        .def(py::init([](const char *filename, int width, int height, const py::kwargs &kwargs)
+                      {
+                          // Options are parsed from Python objects, opening (probing, network I/O) runs without the GIL
+                          const DG::VideoCaptureOptions options = DG::make_options(width, height, kwargs);
+                          py::gil_scoped_release release;
+                          return DG::CapturePtr(new DG::VideoCapture(filename, options)); }),
+             py::arg("filename"), py::arg("width") = 0, py::arg("height") = 0,
+             "Create and open a video file, optionally with resizing\n\n"
              "Args:\n"
              "    filename (str): Path to the video file\n"
-             "    width (int): Target width for resized frames\n"
-             "    height (int): Target height for resized frames")
+             "    width (int, optional): Target width for resized frames (default: 0 = no resize)\n"
+             "    height (int, optional): Target height for resized frames (default: 0 = no resize)\n"
+             "    pixel_format (str, optional): Output pixel format 'bgr24', 'rgb24', 'gray', 'nv12' or 'yuv420p' (default: 'bgr24')\n"
+             "    prefetch (int, optional): Number of frames decoded ahead on a background thread (default: 0 = disabled)\n"
+             "    hw_device (str, optional): Hardware decoder as 'type[:device]', e.g. 'cuda', 'vaapi' (default: CPU decoding)\n"
+             "    device_output (bool, optional): With hw_device='cuda', read() returns DLPack capsules of the frame in GPU memory (default: False)\n"
+             "    tensor (bool, optional): Return model-ready tensors instead of BGR frames (default: False)\n"
+             "    layout (str, optional): Tensor layout 'nchw' (3, height, width) or 'nhwc' (height, width, 3) (default: 'nchw')\n"
+             "    dtype (optional): Tensor element type np.uint8, np.float16 or np.float32 (default: np.float32)\n"
+             "    channel_order (str, optional): Tensor channel order 'rgb' or 'bgr' (default: 'rgb')\n"
+             "    mean (sequence, optional): Per-channel mean in 0..255 pixel units, in channel_order (default: (0, 0, 0))\n"
+             "    std (sequence, optional): Per-channel standard deviation in 0..255 pixel units (default: (1, 1, 1))\n"
+             "    frame_index (bool, optional): Keep a keyframe index in a sidecar file for direct seeks and fast reopening (default: False)\n"
+             "    index_path (str, optional): Sidecar file of the frame index (default: filename + '.dgidx')\n"
+             "    frame_step (int, optional): Return every frame_step-th frame, skipped frames are not converted (default: 1)\n"
+             "    target_fps (float, optional): Return frames at this rate, selected by timestamp (default: 0 = every frame)\n"
+             "    skip_frame (str, optional): Frames the decoder drops: 'default', 'nonref' (non-reference frames) or 'nonkey' (keyframes only) (default: 'default')\n"
+             "    live (bool, optional): Low-latency mode for live sources: no buffering, short probing, slice threading (default: False)\n"
+             "    rtsp_transport (str, optional): RTSP transport 'tcp' or 'udp' (default: FFmpeg default)\n"
+             "    timeout_ms (int, optional): Abort blocking network reads after this many milliseconds (default: 0 = none, 5000 if live)\n"
+             "    latest_frame (bool, optional): read() returns the newest decoded frame, dropping stale ones (default: False)\n"
+             "    reconnect_attempts (int, optional): Reopen attempts per outage of a failed or stalled source (default: 0 = none, -1 = unlimited)\n"
+             "    reconnect_delay_ms (int, optional): Delay before the first reopen attempt, doubled per failed attempt up to 10 s (default: 500)\n"
+             "    decoder_threads (int, optional): Decoder threads (default: 0 = one per CPU core)\n"
+             "    thread_type (str, optional): Decoder threading 'frame', 'slice', 'frame+slice' or 'auto' (frame+slice, slice if live) (default: 'auto')\n"
+             "    cpu_affinity (sequence, optional): CPUs the decoder, prefetch and conversion threads run on (default: any)\n"
+             "    numa_node (int, optional): Run those threads on the CPUs of this NUMA node (default: -1 = any)\n"
+             "    convert_threads (int, optional): Convert frames on a separate pipeline stage, scaling slices on this many threads (default: 0 = off)\n"
+             "    crop (tuple, optional): Region of interest (x, y, width, height) in decoded pixels, converted and resized alone (default: whole frame)\n"
+             "    probesize (int, optional): Bytes read to detect the format and probe streams (default: 0 = FFmpeg default, 32 KB if live)\n"
+             "    analyze_duration_ms (int, optional): Stream duration analyzed while probing (default: 0 = FFmpeg default, 500 if live)\n"
+             "    input_format (str, optional): Container format skipping detection, e.g. 'mp4', 'matroska', 'h264' (default: detect)\n"
+             "    fast_open (bool, optional): Skip stream probing when the header carries the codec parameters, as in MP4 and MKV (default: False)\n"
+             "    renditions (list, optional): Extra outputs of the whole decoded frame, dicts of width, height (0 = no resize),\n"
+             "        letterbox (default True, False stretches) and pixel_format; read() then returns (frame, *renditions) (default: none)\n"
+             "    memory_map (bool, optional): Demux a local file from a read-only memory mapping instead of file reads (default: False)\n"
+             "    lowres (int or str, optional): Decode at 1/2^lowres resolution where the codec supports it (MJPEG, MPEG-1/2/4),\n"
+             "        'auto' picks the largest factor not below the resize target (default: 0 = full resolution)")
 
-        .def("open", &DG::VideoCapture::open,
+        .def("open", [](DG::VideoCapture &self, const char *filename, int width, int height, const py::kwargs &kwargs)
+             {
+                const DG::VideoCaptureOptions options = DG::make_options(width, height, kwargs);
+                py::gil_scoped_release release;
+                return self.open(filename, options); },
              py::arg("filename"), py::arg("width") = 0, py::arg("height") = 0,
              "Open a video file for reading\n\n"
              "Args:\n"
              "    filename (str): Path to the video file\n"
              "    width (int, optional): Target width for resized frames (default: 0 = no resize)\n"
-             "    height (int, optional): Target height for resized frames (default: 0 = no resize)\n\n"
+             "    height (int, optional): Target height for resized frames (default: 0 = no resize)\n"
+             "    pixel_format (str, optional): Output pixel format 'bgr24', 'rgb24', 'gray', 'nv12' or 'yuv420p' (default: 'bgr24')\n"
+             "    prefetch (int, optional): Number of frames decoded ahead on a background thread (default: 0 = disabled)\n"
+             "    hw_device (str, optional): Hardware decoder as 'type[:device]', e.g. 'cuda', 'vaapi' (default: CPU decoding)\n"
+             "    device_output (bool, optional): With hw_device='cuda', read() returns DLPack capsules of the frame in GPU memory (default: False)\n"
+             "    tensor (bool, optional): Return model-ready tensors instead of BGR frames (default: False)\n"
+             "    layout (str, optional): Tensor layout 'nchw' (3, height, width) or 'nhwc' (height, width, 3) (default: 'nchw')\n"
+             "    dtype (optional): Tensor element type np.uint8, np.float16 or np.float32 (default: np.float32)\n"
+             "    channel_order (str, optional): Tensor channel order 'rgb' or 'bgr' (default: 'rgb')\n"
+             "    mean (sequence, optional): Per-channel mean in 0..255 pixel units, in channel_order (default: (0, 0, 0))\n"
+             "    std (sequence, optional): Per-channel standard deviation in 0..255 pixel units (default: (1, 1, 1))\n"
+             "    frame_index (bool, optional): Keep a keyframe index in a sidecar file for direct seeks and fast reopening (default: False)\n"
+             "    index_path (str, optional): Sidecar file of the frame index (default: filename + '.dgidx')\n"
+             "    frame_step (int, optional): Return every frame_step-th frame, skipped frames are not converted (default: 1)\n"
+             "    target_fps (float, optional): Return frames at this rate, selected by timestamp (default: 0 = every frame)\n"
+             "    skip_frame (str, optional): Frames the decoder drops: 'default', 'nonref' (non-reference frames) or 'nonkey' (keyframes only) (default: 'default')\n"
+             "    live (bool, optional): Low-latency mode for live sources: no buffering, short probing, slice threading (default: False)\n"
+             "    rtsp_transport (str, optional): RTSP transport 'tcp' or 'udp' (default: FFmpeg default)\n"
+             "    timeout_ms (int, optional): Abort blocking network reads after this many milliseconds (default: 0 = none, 5000 if live)\n"
+             "    latest_frame (bool, optional): read() returns the newest decoded frame, dropping stale ones (default: False)\n"
+             "    reconnect_attempts (int, optional): Reopen attempts per outage of a failed or stalled source (default: 0 = none, -1 = unlimited)\n"
+             "    reconnect_delay_ms (int, optional): Delay before the first reopen attempt, doubled per failed attempt up to 10 s (default: 500)\n"
+             "    decoder_threads (int, optional): Decoder threads (default: 0 = one per CPU core)\n"
+             "    thread_type (str, optional): Decoder threading 'frame', 'slice', 'frame+slice' or 'auto' (frame+slice, slice if live) (default: 'auto')\n"
+             "    cpu_affinity (sequence, optional): CPUs the decoder, prefetch and conversion threads run on (default: any)\n"
+             "    numa_node (int, optional): Run those threads on the CPUs of this NUMA node (default: -1 = any)\n"
+             "    convert_threads (int, optional): Convert frames on a separate pipeline stage, scaling slices on this many threads (default: 0 = off)\n"
+             "    crop (tuple, optional): Region of interest (x, y, width, height) in decoded pixels, converted and resized alone (default: whole frame)\n"
+             "    probesize (int, optional): Bytes read to detect the format and probe streams (default: 0 = FFmpeg default, 32 KB if live)\n"
+             "    analyze_duration_ms (int, optional): Stream duration analyzed while probing (default: 0 = FFmpeg default, 500 if live)\n"
+             "    input_format (str, optional): Container format skipping detection, e.g. 'mp4', 'matroska', 'h264' (default: detect)\n"
+             "    fast_open (bool, optional): Skip stream probing when the header carries the codec parameters, as in MP4 and MKV (default: False)\n"
+             "    renditions (list, optional): Extra outputs of the whole decoded frame, dicts of width, height (0 = no resize),\n"
+             "        letterbox (default True, False stretches) and pixel_format; read() then returns (frame, *renditions) (default: none)\n"
+             "    memory_map (bool, optional): Demux a local file from a read-only memory mapping instead of file reads (default: False)\n"
+             "    lowres (int or str, optional): Decode at 1/2^lowres resolution where the codec supports it (MJPEG, MPEG-1/2/4),\n"
+             "        'auto' picks the largest factor not below the resize target (default: 0 = full resolution)\n\n"
+             "Returns:\n"
+             "    bool: True if successful, False otherwise")
+
+        .def("open_from_buffer", [](DG::VideoCapture &self, const py::object &data, int width, int height, const py::kwargs &kwargs)
+             {
+                const DG::VideoCaptureOptions options = DG::make_options(width, height, kwargs);
+
+                // The exported buffer stays locked and referenced until close(), which may run on any thread
+                Py_buffer *view = new Py_buffer();
+                if (PyObject_GetBuffer(data.ptr(), view, PyBUF_SIMPLE) != 0) {
+                    delete view;
+                    throw py::error_already_set();
+                }
+                std::shared_ptr<const void> owner(view, [](Py_buffer *v)
+                                                  {
+                    py::gil_scoped_acquire acquire;
+                    PyBuffer_Release(v);
+                    delete v; });
+                const uint8_t *bytes = static_cast<const uint8_t *>(view->buf);
+                const size_t size = static_cast<size_t>(view->len);
+                py::gil_scoped_release release;
+                return self.openBuffer(bytes, size, options, std::move(owner)); },
+             py::arg("data"), py::arg("width") = 0, py::arg("height") = 0,
+             "Open a video held in memory, demuxed straight from the buffer without temporary files\n\n"
+             "Args:\n"
+             "    data (bytes-like): Whole media file, e.g. bytes, bytearray, memoryview or mmap; referenced (not copied) until close()\n"
+             "    width (int, optional): Target width for resized frames (default: 0 = no resize)\n"
+             "    height (int, optional): Target height for resized frames (default: 0 = no resize)\n"
+             "    **options: Options of open(), except frame_index\n\n"
              "Returns:\n"
              "    bool: True if successful, False otherwise")
 
         .def("read", [](DG::VideoCapture &self)
              {
+                // Output format must stay the one of the frame read until it is wrapped
+                auto lock = DG::lock_capture(self);
+
                 // Check if video is opened
                 if (!self.isOpened()) {
                     return py::make_tuple(false, py::none());
                 }
 
-                // Allocate BGR frame for this read
-                AVFrame *bgr_frame = av_frame_alloc();
-                if (!bgr_frame) {
+                // Empty frame shell for this read, recycled from earlier reads (buffer is provided by the reader)
+                AVFrame *frame = DG::FrameShellPool::instance().acquire();
+                if (!frame) {
                     throw std::runtime_error("Failed to allocate AVFrame");
                 }
 
-                // Configure frame for BGR24
-                bgr_frame->format = AV_PIX_FMT_BGR24;
-                bgr_frame->width = self.outputWidth();
-                bgr_frame->height = self.outputHeight();
-
-                // Allocate buffer for the frame data
-                if (av_frame_get_buffer(bgr_frame, 32) < 0) {
-                    av_frame_free(&bgr_frame);
-                    throw std::runtime_error("Failed to allocate frame buffer");
+                // Read frame without holding the GIL, so other Python threads run during decode or prefetch wait
+                bool ok;
+                {
+                    py::gil_scoped_release release;
+                    ok = self.readFrame(frame);
                 }
-
-                // Read frame
-                if (!self.readFrame(bgr_frame)) {
-                    av_frame_free(&bgr_frame);
+                if (!ok) {
+                    DG::FrameShellPool::instance().release(frame);
                     return py::make_tuple(false, py::none());
                 }
 
-                try {
-                    // Convert to numpy with zero-copy (frame_to_numpy_bgr creates reference)
-                    auto array = DG::frame_to_numpy_bgr(bgr_frame);
-                    
-                    // Free original frame since numpy array has its own reference
-                    av_frame_free(&bgr_frame);
-                    
-                    return py::make_tuple(true, array);
-                }
-                catch (const std::exception& e) {
-                    av_frame_free(&bgr_frame);
-                    throw;
-                } }, "Read the next frame from the video\n\n"
+                // Numpy array (zero-copy, takes ownership of the frame) or DLPack capsules of a device frame
+                return py::make_tuple(true, DG::frame_to_python(frame, self)); }, "Read the next frame from the video\n\n"
                   "Returns:\n"
                   "    tuple: (success: bool, frame: np.ndarray or None)\n"
                   "           success is True if a frame was read\n"
-                  "           frame is numpy array (height, width, 3) in BGR format or None")
+                  "           frame is numpy array (height, width, 3) in BGR format or None\n"
+                  "           (height, width, 3) RGB for 'rgb24', (height, width) for 'gray',\n"
+                  "           a tuple of plane arrays (y, uv) for 'nv12' and (y, u, v) for 'yuv420p'\n"
+                  "           with tensor=True, frame is a tensor of the configured layout and dtype\n"
+                  "           with device_output=True, frame is a tuple (y, uv) of DLPack capsules in GPU memory\n"
+                  "           with renditions, frame is a tuple of the main output followed by each rendition")
+
+        .def("try_read", [](DG::VideoCapture &self)
+             {
+                auto lock = DG::lock_capture(self);
+                AVFrame *frame = DG::FrameShellPool::instance().acquire();
+                if (!frame) {
+                    throw std::runtime_error("Failed to allocate AVFrame");
+                }
+
+                // Does not wait with prefetch, but may decode (without prefetch) or convert
+                int status;
+                {
+                    py::gil_scoped_release release;
+                    status = self.tryReadFrame(frame);
+                }
+                if (status <= 0) {
+                    DG::FrameShellPool::instance().release(frame);
+                    return py::make_tuple(status, py::none());
+                }
+                return py::make_tuple(status, DG::frame_to_python(frame, self)); },
+             "Read the next frame only if the prefetch thread has one ready\n\n"
+             "Returns:\n"
+             "    tuple: (status: int, frame), status 1 if a frame was read, 0 if none is ready yet\n"
+             "           (frame is None), -1 at end of video or on error (frame is None).\n"
+             "           Without prefetch the frame is decoded synchronously (status is never 0)")
+
+        .def("notify_when_ready", [](DG::VideoCapture &self, py::function callback)
+             {
+                // Called and released on the prefetch thread, both need the GIL
+                std::shared_ptr<py::function> held(new py::function(std::move(callback)), [](py::function *f)
+                                                   {
+                    py::gil_scoped_acquire acquire;
+                    delete f; });
+                py::gil_scoped_release release;
+                return self.notifyWhenReady([held]
+                                            {
+                    py::gil_scoped_acquire acquire;
+                    try {
+                        (*held)();
+                    } catch (py::error_already_set &e) {
+                        e.discard_as_unraisable("VideoCapture.notify_when_ready callback");
+                    } }); },
+             py::arg("callback"),
+             "Call callback() once when the next frame is ready, decoding ended or the capture is closed\n\n"
+             "Called on the prefetch thread, e.g. to wake an event loop with loop.call_soon_threadsafe();\n"
+             "it must not call into the capture. Every armed callback is called once.\n\n"
+             "Returns:\n"
+             "    bool: True if armed, False if a frame or end of video is pending already (try_read() returns it)\n"
+             "          or the capture does not prefetch (callback is not called)")
 
-        .def("isOpened", &DG::VideoCapture::isOpened, "Check if the video is opened\n\n"
-                                                      "Returns:\n"
-                                                      "    bool: True if opened, False otherwise")
+        .def_property_readonly("prefetch", [](const DG::VideoCapture &self)
+                               {
+                                   auto lock = DG::lock_capture(self);
+                                   return self.options().prefetch; },
+                               "Number of frames decoded ahead on the prefetch thread (0 = reads decode synchronously)")
 
-        .def("close", &DG::VideoCapture::close, "Close the video file")
+        .def("read_into", [](DG::VideoCapture &self, py::array out)
+             {
+                // Output format must stay the validated one until the frame is read
+                auto lock = DG::lock_capture(self);
+
+                // Validate destination: writable array of the output shape and dtype with packed rows, rows may be padded
+                const py::dtype dtype = DG::output_dtype(self);
+                const std::vector<ssize_t> shape = DG::output_shape(self);
+                bool shape_ok = out.dtype().equal(dtype) && out.ndim() == static_cast<ssize_t>(shape.size());
+                std::string shape_text;
+                for (size_t i = 0; i < shape.size(); i++) {
+                    shape_ok = shape_ok && out.shape(i) == shape[i];
+                    shape_text += (i ? ", " : "") + std::to_string(shape[i]);
+                }
+                if (!shape_ok) {
+                    throw py::value_error("out must be a " + std::string(py::str(dtype)) + " array of shape (" + shape_text + ")");
+                }
+                const bool planar = self.options().tensor.enabled && self.options().tensor.layout == DG::TensorLayout::NCHW;
+                const ssize_t linesize = planar ? out.strides(1) : out.strides(0);
+                const std::vector<ssize_t> strides = DG::output_strides(self, linesize);
+                bool strides_ok = linesize >= self.outputRowBytes();
+                for (size_t i = 0; i < strides.size(); i++) {
+                    strides_ok = strides_ok && out.strides(i) == strides[i];
+                }
+                if (!strides_ok) {
+                    throw py::value_error("out must have packed pixels and non-overlapping rows (use a C-contiguous array)");
+                }
+                if (!out.writeable()) {
+                    throw py::value_error("out must be writable");
+                }
+
+                uint8_t *data = static_cast<uint8_t *>(out.mutable_data());
+                int64_t pts = AV_NOPTS_VALUE;
+                bool ok;
+                {
+                    py::gil_scoped_release release;
+                    ok = self.readFrameInto(data, static_cast<int>(linesize), &pts);
+                }
+                return ok; },
+             py::arg("out"),
+             "Read the next frame directly into a caller-supplied array (no allocation per frame)\n\n"
+             "Args:\n"
+             "    out (np.ndarray): Writable uint8 array (height, width, 3) with packed BGR pixels,\n"
+             "                      (height, width) for 'gray', (height * 3/2, width) for 'nv12'/'yuv420p',\n"
+             "                      or with tensor=True an array of the tensor shape and dtype,\n"
+             "                      e.g. a view of pinned host memory or a shared-memory segment.\n"
+             "                      Rows may be padded; 32-byte aligned rows convert fastest.\n\n"
+             "Returns:\n"
+             "    bool: True if a frame was read into out, False at end of video or on error")
+
+        .def("read_batch", [](DG::VideoCapture &self, int n)
+             {
+                if (n < 0) {
+                    throw py::value_error("n must be non-negative");
+                }
 
-        .def("get", &DG::VideoCapture::get, py::arg("prop_id"), "Get video capture property\n\n"
-                                                                "Args:\n"
-                                                                "    prop_id (int): Property identifier (use CAP_PROP_* constants)\n\n"
-                                                                "Returns:\n"
-                                                                "    float: Property value, or -1 if not supported/available\n\n"
-                                                                "Example:\n"
-                                                                "    fps = cap.get(CAP_PROP_FPS)\n"
-                                                                "    frame_count = cap.get(CAP_PROP_FRAME_COUNT)")
+                // Output format must stay the one of the preallocated array until all frames are read
+                auto lock = DG::lock_capture(self);
+                if (!self.isOpened() || self.options().device_output) {
+                    n = 0;
+                }
+
+                // Preallocate one contiguous N x (frame shape) array, each frame is decoded straight into its slot
+                std::vector<ssize_t> shape = DG::output_shape(self);
+                shape.insert(shape.begin(), static_cast<ssize_t>(n));
+                py::array frames(DG::output_dtype(self), shape);
+                py::array_t<int64_t> pts(n);
+
+                uint8_t *buffer = static_cast<uint8_t *>(frames.mutable_data());
+                int count;
+                {
+                    py::gil_scoped_release release;
+                    count = self.readFrames(buffer, n, pts.mutable_data());
+                }
+
+                // Convert PTS to milliseconds like CAP_PROP_POS_MSEC
+                py::array_t<double> timestamps(count);
+                for (int i = 0; i < count; i++) {
+                    timestamps.mutable_at(i) = self.ptsToMsec(pts.at(i));
+                }
+
+                // Trim to the frames actually read (view, no copy)
+                if (count < n) {
+                    return py::make_tuple(frames[py::slice(0, count, 1)], timestamps);
+                }
+                return py::make_tuple(frames, timestamps); },
+             py::arg("n"),
+             "Read up to n frames into one contiguous array\n\n"
+             "Args:\n"
+             "    n (int): Number of frames to read\n\n"
+             "Returns:\n"
+             "    tuple: (frames: np.ndarray, timestamps: np.ndarray)\n"
+             "           frames is uint8 array (count, height, width, 3) in BGR format, count < n at end of video\n"
+             "           (count, height, width) for 'gray', (count, height * 3/2, width) for 'nv12'/'yuv420p'\n"
+             "           (with tensor=True, count tensors of the configured layout and dtype)\n"
+             "           timestamps is float64 array (count,) of frame timestamps in milliseconds")
+
+        .def("isOpened", &DG::VideoCapture::isOpened,
+             py::call_guard<py::gil_scoped_release>(),
+             "Check if the video is opened\n\n"
+             "Returns:\n"
+             "    bool: True if opened, False otherwise")
+
+        .def("reopen", &DG::VideoCapture::reopen, py::arg("filename"), py::call_guard<py::gil_scoped_release>(),
+             "Switch to the next segment of a playlist (HLS chunks, DVR segment files), keeping the decoder, its threads\n"
+             "and the conversion state when the video stream has the same codec parameters; other segments are opened\n"
+             "from scratch with the same options. Reading starts at the first frame of the new segment.\n\n"
+             "Args:\n"
+             "    filename (str): Path or URL of the next segment\n\n"
+             "Returns:\n"
+             "    bool: True if the segment is open, False if it cannot be opened (the capture is closed then)")
+
+        .def("close", &DG::VideoCapture::close, py::call_guard<py::gil_scoped_release>(),
+             "Close the video file (from another thread this interrupts a read blocked on network input)")
+
+        .def("get", &DG::VideoCapture::get, py::arg("prop_id"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Get video capture property\n\n"
+             "Args:\n"
+             "    prop_id (int): Property identifier (use CAP_PROP_* constants)\n\n"
+             "Returns:\n"
+             "    float: Property value, or -1 if not supported/available\n\n"
+             "Example:\n"
+             "    fps = cap.get(CAP_PROP_FPS)\n"
+             "    frame_count = cap.get(CAP_PROP_FRAME_COUNT)")
+
+        .def("set", &DG::VideoCapture::set, py::arg("prop_id"), py::arg("value"),
+             py::call_guard<py::gil_scoped_release>(),
+             "Set video capture property, seeking for position properties\n\n"
+             "Args:\n"
+             "    prop_id (int): CAP_PROP_POS_FRAMES, CAP_PROP_POS_MSEC or CAP_PROP_POS_AVI_RATIO\n"
+             "    value (float): New position (frame index, milliseconds or ratio 0..1)\n\n"
+             "Returns:\n"
+             "    bool: True if positioned on the target frame, False if the source cannot seek or the target is past the end\n\n"
+             "Example:\n"
+             "    cap.set(CAP_PROP_POS_FRAMES, 1000)  # next read() returns frame 1000")
+
+        .def("stats", [](DG::VideoCapture &self, bool reset)
+             {
+                auto lock = DG::lock_capture(self);
+                py::dict result = DG::stats_to_python(self);
+                if (reset) {
+                    self.resetStats();
+                }
+                return result; },
+             py::arg("reset") = false,
+             "Per-stage performance counters since open, to find whether I/O, decoding or conversion limits throughput\n\n"
+             "Args:\n"
+             "    reset (bool, optional): Restart the counters after reading them, e.g. once per measurement window (default: False)\n\n"
+             "Returns:\n"
+             "    dict: packets_read (video packets), bytes_read (all packets), frames_decoded, frames_dropped\n"
+             "          (skipped by frame_step / target_fps or stale with latest_frame), frames_converted, demux_ms\n"
+             "          (time reading packets), and decode / convert dicts of count, total_ms, mean_us, p50_us, p90_us,\n"
+             "          p99_us, max_us and histogram [(bucket start us, count), ...] with power-of-two buckets.\n"
+             "          Decode time excludes demuxing; convert time covers download, renditions, scaling and tensor output.\n"
+             "          Empty if the module was built with ENABLE_CAPTURE_STATS=OFF")
+
+        .def("build_index", &DG::VideoCapture::buildIndex,
+             py::call_guard<py::gil_scoped_release>(),
+             "Scan the file for a frame index (packets only, no decoding), keeping the read position\n\n"
+             "Seeks then go directly to the right keyframe and CAP_PROP_FRAME_COUNT is exact.\n"
+             "Opened with frame_index=True, the index is also saved to the sidecar file.\n\n"
+             "Returns:\n"
+             "    bool: True if the index was built, False if the stream has no timestamps or cannot seek")
 
         .def("__enter__", [](DG::VideoCapture &self) -> DG::VideoCapture &
              { return self; }, "Context manager entry")
 
         .def("__exit__", [](DG::VideoCapture &self, py::object, py::object, py::object)
-             { self.close(); }, "Context manager exit");
+             {
+                py::gil_scoped_release release;
+                self.close(); }, "Context manager exit");
+
+    py::class_<DG::VideoCaptureGroup>(m, "VideoCaptureGroup")
+        .def(py::init<int, int, int>(), py::arg("num_threads") = 0, py::arg("decoder_threads") = 1, py::arg("queue_depth") = 2,
+             "Create a group of video sources decoded by one shared pool of worker threads\n\n"
+             "Args:\n"
+             "    num_threads (int, optional): Worker threads shared by all streams (default: 0 = number of CPU cores)\n"
+             "    decoder_threads (int, optional): Decoder threads of each stream not setting decoder_threads itself (default: 1)\n"
+             "    queue_depth (int, optional): Frames read ahead per stream (default: 2)")
+
+        .def("add", [](DG::VideoCaptureGroup &self, const std::string &filename, int width, int height, const py::kwargs &kwargs)
+             {
+                const DG::VideoCaptureOptions options = DG::make_options(width, height, kwargs);
+                py::gil_scoped_release release;
+                return self.add(filename.c_str(), options); },
+             py::arg("filename"), py::arg("width") = 0, py::arg("height") = 0,
+             "Open a video source and start decoding it on the worker pool\n\n"
+             "Args:\n"
+             "    filename (str): Path or URL of the video source\n"
+             "    width, height, **options: Same as VideoCapture.open(); prefetch is replaced by the group queue\n\n"
+             "Returns:\n"
+             "    int: Stream id (0, 1, ... in order of adding), or -1 if the source could not be opened")
+
+        .def("read_any", [](DG::VideoCaptureGroup &self, int timeout_ms)
+             {
+                AVFrame *frame = DG::FrameShellPool::instance().acquire();
+                if (!frame) {
+                    throw std::runtime_error("Failed to allocate AVFrame");
+                }
+
+                // The capture comes with the frame, it stays open for the conversion even if another thread closes the group
+                int stream_id = -1;
+                std::shared_ptr<const DG::VideoCapture> cap;
+                bool ok;
+                {
+                    py::gil_scoped_release release;
+                    ok = self.readAny(stream_id, frame, timeout_ms, &cap);
+                }
+                if (!ok) {
+                    DG::FrameShellPool::instance().release(frame);
+                    return py::make_tuple(-1, py::none());
+                }
+                return py::make_tuple(stream_id, DG::frame_to_python(frame, *cap)); },
+             py::arg("timeout_ms") = -1,
+             "Read the next ready frame of any stream, streams are served round-robin\n\n"
+             "Args:\n"
+             "    timeout_ms (int, optional): Maximum wait in milliseconds (default: -1 = until all streams ended)\n\n"
+             "Returns:\n"
+             "    tuple: (stream_id: int, frame), (-1, None) on timeout or when all streams ended")
+
+        .def("read_all", [](DG::VideoCaptureGroup &self)
+             {
+                const int n = self.size();
+                std::vector<AVFrame *> frames(static_cast<size_t>(n));
+                std::vector<std::shared_ptr<const DG::VideoCapture>> caps(static_cast<size_t>(n));
+                std::unique_ptr<bool[]> ok(new bool[static_cast<size_t>(n)]);
+                for (auto &frame : frames) {
+                    frame = DG::FrameShellPool::instance().acquire();
+                }
+                {
+                    py::gil_scoped_release release;
+                    self.readAll(n, frames.data(), ok.get(), caps.data());
+                }
+
+                // Ownership of each frame read passes to its Python object
+                py::list result;
+                for (int i = 0; i < n; i++) {
+                    if (ok[i]) {
+                        result.append(DG::frame_to_python(frames[i], *caps[static_cast<size_t>(i)]));
+                    } else {
+                        DG::FrameShellPool::instance().release(frames[i]);
+                        result.append(py::none());
+                    }
+                }
+                return result; },
+             "Read the next frame of every stream\n\n"
+             "Returns:\n"
+             "    list: One frame per stream id, None for streams that ended")
+
+        .def("get", [](const DG::VideoCaptureGroup &self, int stream_id, int prop_id)
+             {
+                const std::shared_ptr<const DG::VideoCapture> cap = self.capture(stream_id);
+                if (!cap) {
+                    throw py::value_error("Invalid stream id " + std::to_string(stream_id));
+                }
+                // Waits for the capture while a worker decodes it
+                py::gil_scoped_release release;
+                return cap->get(prop_id); },
+             py::arg("stream_id"), py::arg("prop_id"),
+             "Get a property of one stream, see VideoCapture.get()")
+
+        .def("stats", [](const DG::VideoCaptureGroup &self, int stream_id)
+             {
+                const std::shared_ptr<const DG::VideoCapture> cap = self.capture(stream_id);
+                if (!cap) {
+                    throw py::value_error("Invalid stream id " + std::to_string(stream_id));
+                }
+                return DG::stats_to_python(*cap); },
+             py::arg("stream_id"),
+             "Per-stage performance counters of one stream, see VideoCapture.stats()")
+
+        .def("__len__", &DG::VideoCaptureGroup::size, "Number of streams added")
+
+        .def("close", &DG::VideoCaptureGroup::close, py::call_guard<py::gil_scoped_release>(),
+             "Stop decoding and close all streams")
+
+        .def("__enter__", [](DG::VideoCaptureGroup &self) -> DG::VideoCaptureGroup &
+             { return self; }, "Context manager entry")
+
+        .def("__exit__", [](DG::VideoCaptureGroup &self, py::object, py::object, py::object)
+             {
+                py::gil_scoped_release release;
+                self.close(); }, "Context manager exit");
+
+    py::class_<DG::SharedFramePublisher>(m, "SharedFramePublisher")
+        .def(py::init([](const std::string &name, DG::VideoCapture &capture, int slots)
+                      {
+                          if (slots < 1 || slots > DG::SharedFramePublisher::MAX_SLOTS) {
+                              throw py::value_error("slots must be between 1 and " + std::to_string(DG::SharedFramePublisher::MAX_SLOTS));
+                          }
+                          auto publisher = std::make_unique<DG::SharedFramePublisher>();
+                          bool ok;
+                          {
+                              py::gil_scoped_release release;
+                              ok = publisher->create(name, capture, slots);
+                          }
+                          if (!ok) {
+                              throw std::runtime_error("Failed to create shared frame ring '" + name + "' (capture closed, device_output or invalid name)");
+                          }
+                          return publisher; }),
+             py::arg("name"), py::arg("capture"), py::arg("slots") = 4, py::keep_alive<1, 3>(),
+             "Create a named shared-memory ring publishing the frames of a capture to other processes\n\n"
+             "Args:\n"
+             "    name (str): Ring name subscribers open, up to 30 characters without '/' (replaces a ring of the same name)\n"
+             "    capture (VideoCapture): Opened capture publish() reads from (not device_output); without prefetch,\n"
+             "        frames are converted straight into shared memory\n"
+             "    slots (int, optional): Frames kept in the ring, more than subscribers hold at once (default: 4)")
+
+        .def("publish", &DG::SharedFramePublisher::publish, py::arg("timeout_ms") = -1, py::call_guard<py::gil_scoped_release>(),
+             "Read the next frame of the capture into a free slot and publish it to subscribers\n\n"
+             "The slot of the oldest frame no subscriber holds is reused, so slow subscribers skip frames.\n\n"
+             "Args:\n"
+             "    timeout_ms (int, optional): Maximum wait when subscribers hold every slot (default: -1 = no limit, 0 = no wait)\n\n"
+             "Returns:\n"
+             "    int: 1 if a frame was published, 0 if no slot was released in time (no frame was read),\n"
+             "         -1 at end of video, on error, when the capture output size changed or close() was called meanwhile")
+
+        .def_property_readonly("sequence", &DG::SharedFramePublisher::sequence,
+                               "Sequence number of the last frame published (frames are numbered from 1, 0 = none)")
+
+        .def("isOpened", &DG::SharedFramePublisher::isOpened, "Check if the ring is open for publishing")
+
+        .def("close", &DG::SharedFramePublisher::close, py::call_guard<py::gil_scoped_release>(),
+             "Close the ring: subscribers read the frames left, then read() returns -1; its name is removed")
+
+        .def("__enter__", [](DG::SharedFramePublisher &self) -> DG::SharedFramePublisher &
+             { return self; }, "Context manager entry")
+
+        .def("__exit__", [](DG::SharedFramePublisher &self, py::object, py::object, py::object)
+             {
+                py::gil_scoped_release release;
+                self.close(); }, "Context manager exit");
+
+    py::class_<DG::SharedFrameSubscriber>(m, "SharedFrameSubscriber")
+        .def(py::init<>(), "Create a subscriber without opening a ring")
+
+        .def(py::init([](const std::string &name)
+                      {
+                          auto subscriber = std::make_unique<DG::SharedFrameSubscriber>();
+                          subscriber->open(name);
+                          return subscriber; }),
+             py::arg("name"),
+             "Create a subscriber and open the ring of a SharedFramePublisher, check isOpened()\n\n"
+             "Args:\n"
+             "    name (str): Ring name given to the publisher")
+
+        .def("open", &DG::SharedFrameSubscriber::open, py::arg("name"),
+             "Open the ring of a SharedFramePublisher, reading starts at the oldest frame in the ring\n\n"
+             "Args:\n"
+             "    name (str): Ring name given to the publisher\n\n"
+             "Returns:\n"
+             "    bool: True if successful, False if no ring of that name exists (yet)")
+
+        .def("isOpened", &DG::SharedFrameSubscriber::isOpened, "Check if a ring is opened")
+
+        .def("read", [](DG::SharedFrameSubscriber &self, int timeout_ms, bool latest)
+             {
+                DG::SharedFrame frame;
+                int status;
+                {
+                    py::gil_scoped_release release;
+                    status = self.read(frame, timeout_ms, latest);
+                }
+                if (status <= 0) {
+                    return py::make_tuple(status, py::none(), py::none());
+                }
+                const int64_t sequence = static_cast<int64_t>(frame.sequence());
+                const double timestamp = frame.timestampMs();
+                return py::make_tuple(sequence, DG::shared_frame_to_numpy(std::move(frame), self.format()), timestamp); },
+             py::arg("timeout_ms") = -1, py::arg("latest") = false,
+             "Read the next frame of the ring as a zero-copy, read-only view of shared memory\n\n"
+             "The frame's slot is not reused while the array (or a view of it) is alive: release frames promptly.\n"
+             "Frames the publisher overwrote before they were read are skipped, seen as gaps in the sequence numbers.\n\n"
+             "Args:\n"
+             "    timeout_ms (int, optional): Maximum wait for a frame (default: -1 = until the publisher closes, 0 = no wait)\n"
+             "    latest (bool, optional): Read the newest frame, skipping older unread ones (default: False)\n\n"
+             "Returns:\n"
+             "    tuple: (sequence: int, frame: np.ndarray or None, timestamp_ms: float or None)\n"
+             "           sequence is the frame number (from 1), 0 on timeout, -1 when the publisher closed and all frames were read\n"
+             "           frame has the publisher's frame shape and dtype, (height * 3/2, width) for 'nv12'/'yuv420p'\n"
+             "           timestamp_ms is the frame timestamp in milliseconds")
+
+        .def("close", &DG::SharedFrameSubscriber::close, py::call_guard<py::gil_scoped_release>(),
+             "Close the ring after a read in progress returns (frames still referenced stay valid)")
+
+        .def("__enter__", [](DG::SharedFrameSubscriber &self) -> DG::SharedFrameSubscriber &
+             { return self; }, "Context manager entry")
+
+        .def("__exit__", [](DG::SharedFrameSubscriber &self, py::object, py::object, py::object)
+             {
+                py::gil_scoped_release release;
+                self.close(); }, "Context manager exit");
+
+    m.def("allocation_count", &DG::allocationCount,
+          "Number of FFmpeg frames and packets allocated by the module so far\n\n"
+          "Steady-state reads reuse their frames and packets, so the count stays constant while reading.\n\n"
+          "Returns:\n"
+          "    int: Allocations since the module was loaded");
 
     // Expose VideoCaptureProperties enum constants
     m.attr("CAP_PROP_POS_MSEC") = static_cast<int>(cv::CAP_PROP_POS_MSEC);
@@ -171,6 +1279,17 @@ PYBIND11_MODULE(_video_capture, m)
     m.attr("CAP_PROP_FPS") = static_cast<int>(cv::CAP_PROP_FPS);
     m.attr("CAP_PROP_FOURCC") = static_cast<int>(cv::CAP_PROP_FOURCC);
     m.attr("CAP_PROP_FRAME_COUNT") = static_cast<int>(cv::CAP_PROP_FRAME_COUNT);
+    m.attr("CAP_PROP_RECONNECT_COUNT") = static_cast<int>(DG::CAP_PROP_RECONNECT_COUNT);
+    m.attr("CAP_PROP_PACKETS_READ") = static_cast<int>(DG::CAP_PROP_PACKETS_READ);
+    m.attr("CAP_PROP_BYTES_READ") = static_cast<int>(DG::CAP_PROP_BYTES_READ);
+    m.attr("CAP_PROP_FRAMES_DECODED") = static_cast<int>(DG::CAP_PROP_FRAMES_DECODED);
+    m.attr("CAP_PROP_FRAMES_DROPPED") = static_cast<int>(DG::CAP_PROP_FRAMES_DROPPED);
+    m.attr("CAP_PROP_FRAMES_CONVERTED") = static_cast<int>(DG::CAP_PROP_FRAMES_CONVERTED);
+    m.attr("CAP_PROP_DEMUX_MSEC") = static_cast<int>(DG::CAP_PROP_DEMUX_MSEC);
+    m.attr("CAP_PROP_DECODE_MSEC") = static_cast<int>(DG::CAP_PROP_DECODE_MSEC);
+    m.attr("CAP_PROP_CONVERT_MSEC") = static_cast<int>(DG::CAP_PROP_CONVERT_MSEC);
+    m.attr("CAP_PROP_COLORSPACE") = static_cast<int>(DG::CAP_PROP_COLORSPACE);
+    m.attr("CAP_PROP_COLOR_RANGE") = static_cast<int>(DG::CAP_PROP_COLOR_RANGE);
 
     // Version automatically set by CMake from PROJECT_VERSION
     m.attr("__version__") = "@PROJECT_VERSION@";
@@ -0,0 +1,175 @@
+//
+// Per-stage performance counters of VideoCapture
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef CAPTURE_STATS_H
+#define CAPTURE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#ifndef DG_CAPTURE_STATS
+#define DG_CAPTURE_STATS 1 //!< Collect per-stage counters and timers (0 compiles all recording out, get() then returns -1 for them)
+#endif
+
+namespace DG
+{
+    /// Monotonic timestamp of the stage timers in nanoseconds (0 when statistics are compiled out)
+    inline int64_t statsClock()
+    {
+#if DG_CAPTURE_STATS
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+        return 0;
+#endif
+    }
+
+    /// Latency histogram with power-of-two microsecond buckets, written by one stage thread and read from any thread
+    ///
+    /// Bucket 0 counts latencies below 2 us, bucket i latencies in [2^i, 2^(i+1)) us, the last bucket everything longer.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int BUCKETS = 24; //!< Number of buckets, the last one starts at about 8.4 s
+
+        /// Record one latency
+        /// @param ns Latency in nanoseconds
+        void add(int64_t ns)
+        {
+#if DG_CAPTURE_STATS
+            int64_t us = ns / 1000;
+            int bucket = 0;
+            while (us > 1 && bucket < BUCKETS - 1)
+            {
+                us >>= 1;
+                bucket++;
+            }
+            m_buckets[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_total_ns.fetch_add(ns, std::memory_order_relaxed);
+            if (ns > m_max_ns.load(std::memory_order_relaxed))
+                m_max_ns.store(ns, std::memory_order_relaxed);
+#else
+            (void)ns;
+#endif
+        }
+
+        uint64_t count() const { return m_count.load(std::memory_order_relaxed); }   //!< Number of latencies recorded
+        int64_t totalNs() const { return m_total_ns.load(std::memory_order_relaxed); } //!< Sum of the latencies recorded
+        int64_t maxNs() const { return m_max_ns.load(std::memory_order_relaxed); }     //!< Longest latency recorded
+        uint64_t bucket(int i) const { return m_buckets[static_cast<size_t>(i)].load(std::memory_order_relaxed); } //!< Count of bucket i
+
+        /// Lower bound of a bucket in microseconds
+        static double bucketStartUs(int i) { return i == 0 ? 0.0 : static_cast<double>(int64_t(1) << i); }
+
+        /// Percentile estimated from the buckets, interpolated linearly within the bucket holding it
+        /// @param fraction Percentile as a fraction, e.g. 0.99
+        /// @return Latency in microseconds (0 if nothing was recorded), at most maxNs()
+        double percentileUs(double fraction) const
+        {
+            const uint64_t total = count();
+            if (total == 0)
+                return 0;
+            const double max_us = static_cast<double>(maxNs()) / 1000.0;
+            const double rank = fraction * static_cast<double>(total);
+            double below = 0;
+            for (int i = 0; i < BUCKETS; i++)
+            {
+                const double n = static_cast<double>(bucket(i));
+                if (n > 0 && below + n >= rank)
+                {
+                    const double start = bucketStartUs(i);
+                    const double end = i + 1 < BUCKETS ? bucketStartUs(i + 1) : max_us;
+                    const double value = start + (end - start) * (rank - below) / n;
+                    return value < max_us ? value : max_us;
+                }
+                below += n;
+            }
+            return max_us;
+        }
+
+        /// Forget all recorded latencies
+        void reset()
+        {
+            for (auto &bucket : m_buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            m_count.store(0, std::memory_order_relaxed);
+            m_total_ns.store(0, std::memory_order_relaxed);
+            m_max_ns.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKETS> m_buckets{}; //!< Latency counts per bucket
+        std::atomic<uint64_t> m_count{0};                       //!< Number of latencies recorded
+        std::atomic<int64_t> m_total_ns{0};                     //!< Sum of the latencies recorded
+        std::atomic<int64_t> m_max_ns{0};                       //!< Longest latency recorded
+    };
+
+    /// Counters and latencies of the demux, decode and convert stages of one capture since it was opened
+    ///
+    /// Stages may run on the caller, prefetch and decode threads while others read the counters; all updates are relaxed atomics.
+    struct CaptureStats
+    {
+        static constexpr bool enabled = DG_CAPTURE_STATS != 0; //!< Statistics are compiled in
+
+        std::atomic<uint64_t> packets_read{0};     //!< Video packets read from the source
+        std::atomic<uint64_t> bytes_read{0};       //!< Bytes of all packets read from the source (video and other streams)
+        std::atomic<uint64_t> frames_dropped{0};   //!< Decoded frames not returned: skipped by frame_step / target_fps or stale with latest_frame
+        std::atomic<int64_t> demux_ns{0};          //!< Time spent reading packets (I/O, demuxing and reconnecting)
+        LatencyHistogram decode;                   //!< Decode time per decoded frame, demuxing excluded (count = frames decoded)
+        LatencyHistogram convert;                  //!< Convert time per output frame: download, renditions, scaling and tensor conversion (count = frames converted)
+
+        /// Count one packet read
+        /// @param size Size of the packet in bytes
+        /// @param video true for packets of the video stream
+        void addPacket(int size, bool video)
+        {
+#if DG_CAPTURE_STATS
+            bytes_read.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+            if (video)
+                packets_read.fetch_add(1, std::memory_order_relaxed);
+#else
+            (void)size;
+            (void)video;
+#endif
+        }
+
+        /// Add time spent in the demuxer
+        void addDemux(int64_t ns)
+        {
+#if DG_CAPTURE_STATS
+            demux_ns.fetch_add(ns, std::memory_order_relaxed);
+#else
+            (void)ns;
+#endif
+        }
+
+        /// Count decoded frames not returned
+        void addDropped(uint64_t n = 1)
+        {
+#if DG_CAPTURE_STATS
+            frames_dropped.fetch_add(n, std::memory_order_relaxed);
+#else
+            (void)n;
+#endif
+        }
+
+        /// Reset all counters, e.g. when the capture is reopened
+        void reset()
+        {
+            packets_read.store(0, std::memory_order_relaxed);
+            bytes_read.store(0, std::memory_order_relaxed);
+            frames_dropped.store(0, std::memory_order_relaxed);
+            demux_ns.store(0, std::memory_order_relaxed);
+            decode.reset();
+            convert.reset();
+        }
+    };
+
+} // namespace DG
+
+#endif // CAPTURE_STATS_H
@@ -0,0 +1,390 @@
+//
+// Unscaled YUV to BGR24 / RGB24 conversion kernels
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#include "ColorConvert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+extern "C"
+{
+#include <libavutil/cpu.h>
+#include <libswscale/swscale.h>
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define DG_COLOR_X86 1
+#if defined(__GNUC__)
+#define DG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DG_TARGET_AVX2
+#endif
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define DG_COLOR_NEON 1
+#endif
+
+namespace DG
+{
+    namespace
+    {
+        using Coefficient = ColorConverter::Coefficient;
+        using Coefficients = ColorConverter::Coefficients;
+
+        /// Split a multiplier into its integer part and a Q15 fraction
+        Coefficient fixedPoint(double k)
+        {
+            double n = std::floor(k);
+            long f = std::lround((k - n) * 32768.0);
+            if (f == 32768)
+            {
+                n += 1;
+                f = 0;
+            }
+            return Coefficient{static_cast<int16_t>(n), static_cast<int16_t>(f)};
+        }
+
+        /// Transform of a matrix given by its luma weights of red and blue into full-range RGB
+        Coefficients makeCoefficients(double kr, double kb, bool full_range)
+        {
+            const double kg = 1.0 - kr - kb;
+            const double luma_scale = full_range ? 1.0 : 255.0 / 219.0;
+            const double chroma_scale = full_range ? 1.0 : 255.0 / 224.0;
+            Coefficients k;
+            k.y_offset = full_range ? 0 : 16;
+            k.y = fixedPoint(luma_scale);
+            k.vr = fixedPoint(2.0 * (1.0 - kr) * chroma_scale);
+            k.ug = fixedPoint(-2.0 * kb * (1.0 - kb) / kg * chroma_scale);
+            k.vg = fixedPoint(-2.0 * kr * (1.0 - kr) / kg * chroma_scale);
+            k.ub = fixedPoint(2.0 * (1.0 - kb) * chroma_scale);
+            return k;
+        }
+
+        //
+        // Portable pixel conversion for the row tails of the vector kernels: every step is the 16-bit operation they perform
+        //
+
+        inline int16_t addSat(int a, int b)
+        {
+            return static_cast<int16_t>(std::min(std::max(a + b, -32768), 32767));
+        }
+
+        /// x * (n + f / 32768), the Q15 product rounded as by pmulhrsw / sqrdmulh
+        inline int16_t multiply(int16_t x, Coefficient k)
+        {
+            return addSat(x * k.n, (x * k.f + 16384) >> 15);
+        }
+
+        /// Drop the 6 fractional bits with rounding and clamp to 0..255
+        inline uint8_t toByte(int16_t value)
+        {
+            return static_cast<uint8_t>(std::min(std::max(addSat(value, 32) >> 6, 0), 255));
+        }
+
+        /// Convert the pixels [begin, end) of a row; chroma is horizontally subsampled by two
+        template <bool Interleaved, bool Rgb>
+        inline void convertPixels(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst, int begin, int end, const Coefficients &k)
+        {
+            for (int x = begin; x < end; x++)
+            {
+                const int c = x >> 1;
+                const int cb = Interleaved ? u[2 * c] : u[c];
+                const int cr = Interleaved ? u[2 * c + 1] : v[c];
+                const int16_t luma = multiply(static_cast<int16_t>((y[x] - k.y_offset) * 64), k.y);
+                const int16_t cb6 = static_cast<int16_t>((cb - 128) * 64);
+                const int16_t cr6 = static_cast<int16_t>((cr - 128) * 64);
+                const uint8_t r = toByte(addSat(luma, multiply(cr6, k.vr)));
+                const uint8_t g = toByte(addSat(addSat(luma, multiply(cb6, k.ug)), multiply(cr6, k.vg)));
+                const uint8_t b = toByte(addSat(luma, multiply(cb6, k.ub)));
+                uint8_t *out = dst + 3 * x;
+                out[0] = Rgb ? r : b;
+                out[1] = g;
+                out[2] = Rgb ? b : r;
+            }
+        }
+
+#if defined(DG_COLOR_X86)
+        //
+        // AVX2 kernels, 16 pixels per iteration
+        //
+
+        DG_TARGET_AVX2 inline __m256i multiply16(__m256i x, __m256i n, __m256i f)
+        {
+            return _mm256_adds_epi16(_mm256_mullo_epi16(x, n), _mm256_mulhrs_epi16(x, f));
+        }
+
+        /// Round, clamp and narrow 16 values to bytes in order
+        DG_TARGET_AVX2 inline __m128i toBytes16(__m256i value)
+        {
+            const __m256i shifted = _mm256_srai_epi16(_mm256_adds_epi16(value, _mm256_set1_epi16(32)), 6);
+            const __m256i packed = _mm256_packus_epi16(shifted, shifted); // per 128-bit lane
+            return _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0x08));
+        }
+
+        template <bool Interleaved, bool Rgb>
+        DG_TARGET_AVX2 void rowAvx2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst, int width, const Coefficients &k)
+        {
+            const __m256i y_offset = _mm256_set1_epi16(k.y_offset);
+            const __m256i chroma_offset = _mm256_set1_epi16(128);
+            const __m256i yn = _mm256_set1_epi16(k.y.n), yf = _mm256_set1_epi16(k.y.f);
+            const __m256i vrn = _mm256_set1_epi16(k.vr.n), vrf = _mm256_set1_epi16(k.vr.f);
+            const __m256i ugn = _mm256_set1_epi16(k.ug.n), ugf = _mm256_set1_epi16(k.ug.f);
+            const __m256i vgn = _mm256_set1_epi16(k.vg.n), vgf = _mm256_set1_epi16(k.vg.f);
+            const __m256i ubn = _mm256_set1_epi16(k.ub.n), ubf = _mm256_set1_epi16(k.ub.f);
+
+            // Byte shuffles spreading three 16-byte channels over 48 interleaved bytes, [output block][channel]
+            const __m128i spread[3][3] = {
+                {_mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5),
+                 _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1),
+                 _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)},
+                {_mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1),
+                 _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10),
+                 _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1)},
+                {_mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1),
+                 _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1),
+                 _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15)}};
+
+            int x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                // Chroma of 8 pixel pairs, each sample repeated for both pixels of its pair
+                __m128i cb8, cr8;
+                if (Interleaved)
+                {
+                    const __m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x));
+                    cb8 = _mm_shuffle_epi8(uv, _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14));
+                    cr8 = _mm_shuffle_epi8(uv, _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15));
+                }
+                else
+                {
+                    const __m128i cb_half = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x / 2));
+                    const __m128i cr_half = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x / 2));
+                    cb8 = _mm_unpacklo_epi8(cb_half, cb_half);
+                    cr8 = _mm_unpacklo_epi8(cr_half, cr_half);
+                }
+
+                const __m256i y16 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x)));
+                const __m256i luma = multiply16(_mm256_slli_epi16(_mm256_sub_epi16(y16, y_offset), 6), yn, yf);
+                const __m256i cb = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(cb8), chroma_offset), 6);
+                const __m256i cr = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(cr8), chroma_offset), 6);
+
+                const __m128i r = toBytes16(_mm256_adds_epi16(luma, multiply16(cr, vrn, vrf)));
+                const __m128i g = toBytes16(_mm256_adds_epi16(_mm256_adds_epi16(luma, multiply16(cb, ugn, ugf)), multiply16(cr, vgn, vgf)));
+                const __m128i b = toBytes16(_mm256_adds_epi16(luma, multiply16(cb, ubn, ubf)));
+                const __m128i first = Rgb ? r : b;
+                const __m128i last = Rgb ? b : r;
+
+                __m128i *out = reinterpret_cast<__m128i *>(dst + 3 * x);
+                for (int block = 0; block < 3; block++)
+                {
+                    const __m128i bytes = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(first, spread[block][0]), _mm_shuffle_epi8(g, spread[block][1])),
+                                                       _mm_shuffle_epi8(last, spread[block][2]));
+                    _mm_storeu_si128(out + block, bytes);
+                }
+            }
+            convertPixels<Interleaved, Rgb>(y, u, v, dst, x, width, k);
+        }
+#endif
+
+#if defined(DG_COLOR_NEON)
+        //
+        // NEON kernels, 16 pixels per iteration
+        //
+
+        inline int16x8_t multiply8(int16x8_t x, Coefficient k)
+        {
+            return vqaddq_s16(vmulq_n_s16(x, k.n), vqrdmulhq_n_s16(x, k.f));
+        }
+
+        /// Round, clamp and narrow 8 values to bytes
+        inline uint8x8_t toBytes8(int16x8_t value)
+        {
+            return vqmovun_s16(vshrq_n_s16(vqaddq_s16(value, vdupq_n_s16(32)), 6));
+        }
+
+        template <bool Interleaved, bool Rgb>
+        void rowNeon(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst, int width, const Coefficients &k)
+        {
+            const int16x8_t y_offset = vdupq_n_s16(k.y_offset);
+            const int16x8_t chroma_offset = vdupq_n_s16(128);
+            int x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                uint8x8_t cb_half, cr_half;
+                if (Interleaved)
+                {
+                    const uint8x8x2_t uv = vld2_u8(u + x);
+                    cb_half = uv.val[0];
+                    cr_half = uv.val[1];
+                }
+                else
+                {
+                    cb_half = vld1_u8(u + x / 2);
+                    cr_half = vld1_u8(v + x / 2);
+                }
+
+                // Chroma sample repeated for both pixels of its pair: val[0] covers pixels 0..7, val[1] pixels 8..15
+                const uint8x8x2_t cb_pairs = vzip_u8(cb_half, cb_half);
+                const uint8x8x2_t cr_pairs = vzip_u8(cr_half, cr_half);
+                const uint8x16_t y8 = vld1q_u8(y + x);
+
+                uint8x8_t r[2], g[2], b[2];
+                for (int half = 0; half < 2; half++)
+                {
+                    const uint8x8_t y_half = half ? vget_high_u8(y8) : vget_low_u8(y8);
+                    const int16x8_t luma = multiply8(vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y_half)), y_offset), 6), k.y);
+                    const int16x8_t cb = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(cb_pairs.val[half])), chroma_offset), 6);
+                    const int16x8_t cr = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(cr_pairs.val[half])), chroma_offset), 6);
+                    r[half] = toBytes8(vqaddq_s16(luma, multiply8(cr, k.vr)));
+                    g[half] = toBytes8(vqaddq_s16(vqaddq_s16(luma, multiply8(cb, k.ug)), multiply8(cr, k.vg)));
+                    b[half] = toBytes8(vqaddq_s16(luma, multiply8(cb, k.ub)));
+                }
+
+                uint8x16x3_t pixels;
+                pixels.val[0] = Rgb ? vcombine_u8(r[0], r[1]) : vcombine_u8(b[0], b[1]);
+                pixels.val[1] = vcombine_u8(g[0], g[1]);
+                pixels.val[2] = Rgb ? vcombine_u8(b[0], b[1]) : vcombine_u8(r[0], r[1]);
+                vst3q_u8(dst + 3 * x, pixels);
+            }
+            convertPixels<Interleaved, Rgb>(y, u, v, dst, x, width, k);
+        }
+#endif
+
+        /// Row kernel of a chroma layout and output channel order for the running CPU
+        /// @return Vector kernel, nullptr without one: per-pixel code is slower than the SIMD paths of swscale
+        template <bool Interleaved, bool Rgb>
+        void (*selectRow())(const uint8_t *, const uint8_t *, const uint8_t *, uint8_t *, int, const Coefficients &)
+        {
+#if defined(DG_COLOR_X86)
+            if (av_get_cpu_flags() & AV_CPU_FLAG_AVX2)
+                return rowAvx2<Interleaved, Rgb>;
+#elif defined(DG_COLOR_NEON)
+            // NEON is mandatory on AArch64
+            return rowNeon<Interleaved, Rgb>;
+#endif
+            return nullptr;
+        }
+    } // namespace
+
+    /// Matrix of the YUV -> RGB transform of a source colorspace
+    /// @param colorspace Colorspace tag of the stream or frame
+    /// @return SWS_CS_ITU709, SWS_CS_BT2020 or SWS_CS_ITU601 (untagged and SD sources), -1 for colorspaces the kernels
+    ///         do not implement (FCC, SMPTE 240M, YCgCo, ...), which are left to swscale defaults
+    int yuvMatrix(AVColorSpace colorspace)
+    {
+        switch (colorspace)
+        {
+        case AVCOL_SPC_BT709:
+            return SWS_CS_ITU709;
+        case AVCOL_SPC_BT2020_NCL:
+        case AVCOL_SPC_BT2020_CL:
+            return SWS_CS_BT2020;
+        case AVCOL_SPC_UNSPECIFIED:
+        case AVCOL_SPC_BT470BG:
+        case AVCOL_SPC_SMPTE170M:
+            return SWS_CS_ITU601;
+        default:
+            return -1;
+        }
+    }
+
+    /// Whether YUV samples use the full 0..255 range
+    /// @param format Source pixel format, the JPEG formats are full range by definition
+    /// @param range Range tag of the stream or frame
+    bool isFullRange(AVPixelFormat format, AVColorRange range)
+    {
+        return range == AVCOL_RANGE_JPEG || format == AV_PIX_FMT_YUVJ420P || format == AV_PIX_FMT_YUVJ422P || format == AV_PIX_FMT_YUVJ444P;
+    }
+
+    /// Select the conversion kernel for a source and output format
+    /// @param src_format Decoded pixel format
+    /// @param dst_format Output pixel format
+    /// @param colorspace Colorspace tag of the source
+    /// @param range Range tag of the source
+    /// @return true if a kernel covers the combination on the running CPU, false if the frames have to be converted by swscale
+    bool ColorConverter::init(AVPixelFormat src_format, AVPixelFormat dst_format, AVColorSpace colorspace, AVColorRange range)
+    {
+        m_src_format = src_format;
+        m_colorspace = colorspace;
+        m_range = range;
+        m_row = nullptr;
+
+        const bool rgb = dst_format == AV_PIX_FMT_RGB24;
+        if (!rgb && dst_format != AV_PIX_FMT_BGR24)
+            return false;
+
+        switch (src_format)
+        {
+        case AV_PIX_FMT_YUV420P:
+        case AV_PIX_FMT_YUVJ420P:
+            m_interleaved = false;
+            m_chroma_shift = 1;
+            break;
+        case AV_PIX_FMT_YUV422P:
+        case AV_PIX_FMT_YUVJ422P:
+            m_interleaved = false;
+            m_chroma_shift = 0;
+            break;
+        case AV_PIX_FMT_NV12:
+            m_interleaved = true;
+            m_chroma_shift = 1;
+            break;
+        default:
+            return false;
+        }
+
+        const bool full_range = isFullRange(src_format, range);
+        switch (yuvMatrix(colorspace))
+        {
+        case SWS_CS_ITU601:
+            m_coefficients = makeCoefficients(0.299, 0.114, full_range);
+            break;
+        case SWS_CS_ITU709:
+            m_coefficients = makeCoefficients(0.2126, 0.0722, full_range);
+            break;
+        case SWS_CS_BT2020:
+            m_coefficients = makeCoefficients(0.2627, 0.0593, full_range);
+            break;
+        default:
+            return false;
+        }
+
+        if (m_interleaved)
+            m_row = rgb ? selectRow<true, true>() : selectRow<true, false>();
+        else
+            m_row = rgb ? selectRow<false, true>() : selectRow<false, false>();
+        return m_row != nullptr;
+    }
+
+    /// Whether init() was last called for this source, so frames of a changing source are only re-selected on change
+    bool ColorConverter::matches(AVPixelFormat src_format, AVColorSpace colorspace, AVColorRange range) const
+    {
+        return m_src_format == src_format && m_colorspace == colorspace && m_range == range;
+    }
+
+    /// Convert a YUV image into packed BGR24 / RGB24
+    /// @param src Luma and chroma planes (Cb, Cr; the UV plane and nullptr for NV12) at the top-left pixel to convert,
+    ///            on an even column of the source
+    /// @param src_linesize Line size in bytes of each plane
+    /// @param width Width in pixels
+    /// @param height Height in rows
+    /// @param dst First output row
+    /// @param dst_linesize Output line size in bytes
+    void ColorConverter::convert(const uint8_t *const src[3], const int src_linesize[3], int width, int height, uint8_t *dst, int dst_linesize) const
+    {
+        for (int y = 0; y < height; y++)
+        {
+            const int c = y >> m_chroma_shift;
+            m_row(src[0] + static_cast<ptrdiff_t>(y) * src_linesize[0],
+                  src[1] + static_cast<ptrdiff_t>(c) * src_linesize[1],
+                  m_interleaved ? nullptr : src[2] + static_cast<ptrdiff_t>(c) * src_linesize[2],
+                  dst + static_cast<ptrdiff_t>(y) * dst_linesize, width, m_coefficients);
+        }
+    }
+
+} // namespace DG
@@ -0,0 +1,69 @@
+//
+// Unscaled YUV to BGR24 / RGB24 conversion kernels
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef COLOR_CONVERT_H
+#define COLOR_CONVERT_H
+
+extern "C"
+{
+#include <libavutil/pixfmt.h>
+}
+
+#include <cstdint>
+
+namespace DG
+{
+    int yuvMatrix(AVColorSpace colorspace);                   //!< SWS_CS_* matrix of the YUV -> RGB transform of a colorspace, -1 if the kernels do not implement it
+    bool isFullRange(AVPixelFormat format, AVColorRange range); //!< YUV samples use the full 0..255 range (JPEG formats or tagged full range)
+
+    /// Converts decoded YUV frames of the common decoder formats to packed BGR24 / RGB24 without scaling
+    ///
+    /// Covers YUV420P, YUVJ420P, NV12, YUV422P and YUVJ422P sources with BT.601, BT.709 and BT.2020 matrices in
+    /// limited or full range, in 16-bit fixed point with identical results for the AVX2 and NEON kernels (within one
+    /// level of the exact transform). Chroma is taken from the co-sited sample of each pixel pair, as swscale does for
+    /// unscaled conversion. CPUs without AVX2 or NEON are left to swscale.
+    class ColorConverter
+    {
+    public:
+        bool init(AVPixelFormat src_format, AVPixelFormat dst_format, AVColorSpace colorspace, AVColorRange range); //!< Select the kernel, false for combinations left to swscale
+        bool matches(AVPixelFormat src_format, AVColorSpace colorspace, AVColorRange range) const;                 //!< init() was last called for this source
+        bool valid() const { return m_row != nullptr; }
+
+        void convert(const uint8_t *const src[3], const int src_linesize[3], int width, int height, uint8_t *dst, int dst_linesize) const;
+
+        /// Multiplier n + f / 32768 with 0 <= f < 32768, applied to 16-bit samples with 6 fractional bits
+        struct Coefficient
+        {
+            int16_t n;
+            int16_t f;
+        };
+
+        /// Fixed-point YUV -> RGB transform
+        struct Coefficients
+        {
+            int16_t y_offset; //!< Black level of luma (16 limited, 0 full range)
+            Coefficient y;    //!< Luma scale
+            Coefficient vr;   //!< Cr contribution to red
+            Coefficient ug;   //!< Cb contribution to green (negative)
+            Coefficient vg;   //!< Cr contribution to green (negative)
+            Coefficient ub;   //!< Cb contribution to blue
+        };
+
+    private:
+        using RowFn = void (*)(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *dst, int width, const Coefficients &k);
+
+        Coefficients m_coefficients = {};                 //!< Transform of the source matrix and range
+        RowFn m_row = nullptr;                            //!< Vector row kernel selected for the formats and the running CPU (nullptr = use swscale)
+        int m_chroma_shift = 0;                           //!< log2 of the vertical chroma subsampling
+        bool m_interleaved = false;                       //!< Chroma is one interleaved UV plane (NV12)
+        AVPixelFormat m_src_format = AV_PIX_FMT_NONE;     //!< Source format of the last init()
+        AVColorSpace m_colorspace = AVCOL_SPC_UNSPECIFIED; //!< Source colorspace of the last init()
+        AVColorRange m_range = AVCOL_RANGE_UNSPECIFIED;   //!< Source range of the last init()
+    };
+
+} // namespace DG
+
+#endif // COLOR_CONVERT_H
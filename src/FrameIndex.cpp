@@ -0,0 +1,294 @@
+//
+// Frame index for random access seeking
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#include "FrameIndex.h"
+
+extern "C"
+{
+#include <libavutil/avutil.h>
+}
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <system_error>
+
+namespace DG
+{
+    namespace
+    {
+        const char INDEX_MAGIC[8] = {'D', 'G', 'V', 'I', 'D', 'X', '0', '1'}; //!< Sidecar file signature and format version
+        const uint32_t INDEX_BYTE_ORDER = 0x01020304;                          //!< Written natively, rejects sidecars from machines of other endianness
+
+        /// Size and modification time identifying one version of the video file
+        struct FileStamp
+        {
+            uint64_t size = 0;
+            int64_t mtime = 0;
+        };
+
+        bool fileStamp(const std::string &path, FileStamp &stamp)
+        {
+            std::error_code ec;
+            const auto size = std::filesystem::file_size(path, ec);
+            if (ec)
+                return false;
+            const auto mtime = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return false;
+            stamp.size = static_cast<uint64_t>(size);
+            stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+            return true;
+        }
+
+        template <typename T>
+        void writeValue(std::ofstream &out, const T &value)
+        {
+            out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool readValue(std::ifstream &in, T &value)
+        {
+            return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+
+        template <typename T>
+        void writeArray(std::ofstream &out, const std::vector<T> &values)
+        {
+            out.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+        }
+
+        template <typename T>
+        bool readArray(std::ifstream &in, std::vector<T> &values, uint64_t count)
+        {
+            values.resize(static_cast<size_t>(count));
+            return static_cast<bool>(in.read(reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+        }
+    } // namespace
+
+    /// Drop the index and any recorded packets
+    void FrameIndex::clear()
+    {
+        m_stream = StreamInfo();
+        m_frame_pts.clear();
+        m_frame_key.clear();
+        m_decode_distance.clear();
+        m_key_pts.clear();
+        m_key_pos.clear();
+        cancelRecording();
+    }
+
+    /// Start collecting packets of a sequential pass, replacing the current index
+    /// @param stream Parameters of the indexed video stream
+    void FrameIndex::beginRecording(const StreamInfo &stream)
+    {
+        clear();
+        m_stream = stream;
+        m_recording = true;
+    }
+
+    /// Drop collected packets, the index stays empty
+    void FrameIndex::cancelRecording()
+    {
+        m_packets.clear();
+        m_packets.shrink_to_fit();
+        m_recording = false;
+    }
+
+    /// Record one video packet while recording
+    /// @param pts Packet presentation timestamp (AV_NOPTS_VALUE makes the stream unindexable)
+    /// @param pos Byte offset of the packet in the file (-1 if unknown)
+    /// @param keyframe true if the packet starts a keyframe
+    void FrameIndex::addPacket(int64_t pts, int64_t pos, bool keyframe)
+    {
+        if (m_recording)
+            m_packets.push_back({pts, pos, keyframe});
+    }
+
+    /// Build the index from the packets recorded since beginRecording()
+    /// @return true if the index was built, false if not recording or packets lack timestamps or a leading keyframe
+    bool FrameIndex::finishRecording()
+    {
+        if (!m_recording)
+            return false;
+
+        std::vector<Packet> packets;
+        packets.swap(m_packets);
+        cancelRecording();
+
+        // Streams without timestamps (e.g. raw elementary streams) cannot be seeked by PTS
+        if (packets.empty() || !packets.front().keyframe)
+            return false;
+        for (const Packet &packet : packets)
+        {
+            if (packet.pts == AV_NOPTS_VALUE)
+                return false;
+        }
+
+        // Decode order: each packet decodes from the latest keyframe not presented after it
+        // (open-GOP leading pictures reference the previous keyframe)
+        std::vector<uint32_t> packet_key(packets.size());
+        std::vector<uint32_t> packet_distance(packets.size());
+        std::vector<size_t> key_decode_index;
+        for (size_t i = 0; i < packets.size(); i++)
+        {
+            if (packets[i].keyframe)
+            {
+                m_key_pts.push_back(packets[i].pts);
+                m_key_pos.push_back(packets[i].pos);
+                key_decode_index.push_back(i);
+            }
+
+            size_t k = m_key_pts.size() - 1;
+            while (k > 0 && m_key_pts[k] > packets[i].pts)
+                k--;
+            packet_key[i] = static_cast<uint32_t>(k);
+            packet_distance[i] = static_cast<uint32_t>(i - key_decode_index[k] + 1);
+        }
+
+        // Presentation order: frame N is the packet with the N-th smallest PTS
+        std::vector<size_t> order(packets.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                         { return packets[a].pts < packets[b].pts; });
+
+        m_frame_pts.reserve(order.size());
+        m_frame_key.reserve(order.size());
+        m_decode_distance.reserve(order.size());
+        for (size_t i : order)
+        {
+            m_frame_pts.push_back(packets[i].pts);
+            m_frame_key.push_back(packet_key[i]);
+            m_decode_distance.push_back(packet_distance[i]);
+        }
+        return true;
+    }
+
+    /// Seek point of a frame
+    /// @param frame Frame number in presentation order
+    /// @param point Receives the frame PTS and the keyframe to decode it from
+    /// @return true on success, false if frame is out of range
+    bool FrameIndex::seekPoint(int64_t frame, SeekPoint &point) const
+    {
+        if (frame < 0 || frame >= frameCount())
+            return false;
+        const size_t n = static_cast<size_t>(frame);
+        const uint32_t key = m_frame_key[n];
+        point.frame_pts = m_frame_pts[n];
+        point.key_pts = m_key_pts[key];
+        point.key_pos = m_key_pos[key];
+        point.decode_distance = m_decode_distance[n];
+        return true;
+    }
+
+    /// Number of the first frame presented at or after a timestamp
+    /// @param pts Timestamp in stream time base
+    /// @return Frame number, frameCount() if pts is past the last frame
+    int64_t FrameIndex::frameAtPts(int64_t pts) const
+    {
+        return static_cast<int64_t>(std::lower_bound(m_frame_pts.begin(), m_frame_pts.end(), pts) - m_frame_pts.begin());
+    }
+
+    /// Load the index from a sidecar file
+    /// @param path Sidecar file path
+    /// @param video_path Video file the sidecar must belong to (its size and modification time are compared)
+    /// @return true if a matching, consistent index was loaded; the index is left empty otherwise
+    bool FrameIndex::load(const std::string &path, const std::string &video_path)
+    {
+        clear();
+
+        FileStamp stamp;
+        if (!fileStamp(video_path, stamp))
+            return false;
+
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return false;
+
+        char magic[sizeof(INDEX_MAGIC)];
+        uint32_t byte_order = 0;
+        FileStamp stored;
+        uint64_t frame_count = 0, key_count = 0;
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+            !readValue(in, byte_order) || byte_order != INDEX_BYTE_ORDER ||
+            !readValue(in, stored.size) || !readValue(in, stored.mtime) ||
+            stored.size != stamp.size || stored.mtime != stamp.mtime ||
+            !readValue(in, m_stream) || !readValue(in, frame_count) || !readValue(in, key_count) ||
+            key_count == 0 || key_count > frame_count || frame_count > stamp.size)
+        {
+            clear();
+            return false;
+        }
+
+        bool ok = readArray(in, m_frame_pts, frame_count) &&
+                  readArray(in, m_frame_key, frame_count) &&
+                  readArray(in, m_decode_distance, frame_count) &&
+                  readArray(in, m_key_pts, key_count) &&
+                  readArray(in, m_key_pos, key_count);
+
+        // Reject truncated or corrupted sidecars instead of seeking to wrong places
+        ok = ok && std::is_sorted(m_frame_pts.begin(), m_frame_pts.end()) &&
+             std::all_of(m_frame_key.begin(), m_frame_key.end(), [&](uint32_t key)
+                         { return key < key_count; });
+        if (!ok)
+            clear();
+        return ok;
+    }
+
+    /// Save the index to a sidecar file, written to a temporary file first and renamed into place
+    /// @param path Sidecar file path
+    /// @param video_path Video file the index belongs to (its size and modification time are stored)
+    /// @return true on success, false if the index is empty or the file cannot be written
+    bool FrameIndex::save(const std::string &path, const std::string &video_path) const
+    {
+        FileStamp stamp;
+        if (empty() || !fileStamp(video_path, stamp))
+            return false;
+
+        // Unique temporary name, several processes may index the same file at once
+        const std::string tmp_path = path + ".tmp" + std::to_string(std::random_device()());
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+
+            out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+            writeValue(out, INDEX_BYTE_ORDER);
+            writeValue(out, stamp.size);
+            writeValue(out, stamp.mtime);
+            writeValue(out, m_stream);
+            writeValue(out, static_cast<uint64_t>(m_frame_pts.size()));
+            writeValue(out, static_cast<uint64_t>(m_key_pts.size()));
+            writeArray(out, m_frame_pts);
+            writeArray(out, m_frame_key);
+            writeArray(out, m_decode_distance);
+            writeArray(out, m_key_pts);
+            writeArray(out, m_key_pos);
+            if (!out.flush())
+            {
+                out.close();
+                std::remove(tmp_path.c_str());
+                return false;
+            }
+        }
+
+        // Concurrent loaders see either the old or the new sidecar, never a partial one
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec)
+        {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+} // namespace DG
@@ -0,0 +1,81 @@
+//
+// Frame index for random access seeking
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef FRAME_INDEX_H
+#define FRAME_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DG
+{
+    /// Compact frame number -> (frame PTS, keyframe PTS, keyframe byte offset, decode distance) index of one video stream
+    ///
+    /// Built from demuxed packets (no decoding), either during a sequential pass or by an explicit scan,
+    /// and persisted in a sidecar file validated against the size and modification time of the video file.
+    class FrameIndex
+    {
+    public:
+        /// Video stream parameters stored with the index, used to open the stream without probing
+        struct StreamInfo
+        {
+            int stream_index = -1;     //!< Index of the video stream in the file
+            int width = 0;             //!< Coded width in pixels
+            int height = 0;            //!< Coded height in pixels
+            int pix_fmt = -1;          //!< Decoded pixel format (AVPixelFormat)
+            int time_base_num = 0;     //!< Stream time base numerator
+            int time_base_den = 1;     //!< Stream time base denominator
+        };
+
+        /// Where to start decoding to reach a frame
+        struct SeekPoint
+        {
+            int64_t frame_pts = 0;        //!< PTS of the frame
+            int64_t key_pts = 0;          //!< PTS of the keyframe to seek to
+            int64_t key_pos = -1;         //!< Byte offset of the keyframe packet (-1 if unknown)
+            uint32_t decode_distance = 0; //!< Number of packets decoded from the keyframe up to and including the frame
+        };
+
+        void clear();
+        bool empty() const { return m_frame_pts.empty(); }
+        int64_t frameCount() const { return static_cast<int64_t>(m_frame_pts.size()); }
+        const StreamInfo &streamInfo() const { return m_stream; }
+
+        void beginRecording(const StreamInfo &stream);           //!< Start collecting packets of a sequential pass from the start of the stream
+        void cancelRecording();                                 //!< Drop collected packets, e.g. after a seek broke the sequential pass
+        bool isRecording() const { return m_recording; }
+        void addPacket(int64_t pts, int64_t pos, bool keyframe); //!< Record one video packet in decode order
+        bool finishRecording();                                 //!< Build the index from the recorded packets
+
+        bool seekPoint(int64_t frame, SeekPoint &point) const;  //!< Seek point of frame number frame (presentation order)
+        int64_t frameAtPts(int64_t pts) const;                  //!< Number of the first frame with PTS >= pts (frameCount() if none)
+
+        bool load(const std::string &path, const std::string &video_path);       //!< Load the sidecar if it matches video_path and is valid
+        bool save(const std::string &path, const std::string &video_path) const; //!< Write the sidecar atomically (write + rename)
+
+    private:
+        /// Video packet in decode order, collected while recording
+        struct Packet
+        {
+            int64_t pts;   //!< Presentation timestamp
+            int64_t pos;   //!< Byte offset in the file (-1 if unknown)
+            bool keyframe; //!< Packet starts a keyframe
+        };
+
+        StreamInfo m_stream;                     //!< Stream the index belongs to
+        std::vector<int64_t> m_frame_pts;        //!< PTS of each frame, presentation order (sorted)
+        std::vector<uint32_t> m_frame_key;       //!< Index into m_key_pts / m_key_pos of the keyframe to decode each frame from
+        std::vector<uint32_t> m_decode_distance; //!< Packets decoded from the keyframe up to and including each frame
+        std::vector<int64_t> m_key_pts;          //!< PTS of each keyframe, decode order
+        std::vector<int64_t> m_key_pos;          //!< Byte offset of each keyframe packet, decode order
+        std::vector<Packet> m_packets;           //!< Packets collected while recording
+        bool m_recording = false;                //!< Packets of a sequential pass are being collected
+    };
+
+} // namespace DG
+
+#endif // FRAME_INDEX_H
@@ -0,0 +1,184 @@
+//
+// In-memory and memory-mapped input for the demuxer
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#include "MemoryInput.h"
+
+extern "C"
+{
+#include <libavutil/error.h>
+#include <libavutil/mem.h>
+}
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <filesystem>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DG
+{
+    namespace
+    {
+        const int IO_BUFFER_SIZE = 64 * 1024; //!< Bytes the demuxer pulls per read callback
+    } // namespace
+
+    /// Wrap a caller buffer holding a whole media file
+    /// @param data First byte of the file, must stay valid while the input exists
+    /// @param size File size in bytes
+    /// @param owner Object keeping data alive, released with the input (nullptr if the caller manages the lifetime)
+    MemoryInput::MemoryInput(const uint8_t *data, size_t size, std::shared_ptr<const void> owner)
+        : m_data(data), m_size(size), m_owner(std::move(owner))
+    {
+    }
+
+    /// Destructor unmaps a mapped file and releases the buffer owner
+    MemoryInput::~MemoryInput()
+    {
+        if (!m_mapping)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_size);
+#endif
+    }
+
+    /// Map a regular file read-only, the mapping outlives the file handle
+    /// @param path File path (UTF-8)
+    /// @return Input over the mapped file, nullptr if the file cannot be opened or mapped or is empty
+    std::unique_ptr<MemoryInput> MemoryInput::mapFile(const std::string &path)
+    {
+        void *view = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        HANDLE file = CreateFileW(std::filesystem::u8path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+        LARGE_INTEGER file_size;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+        {
+            size = static_cast<size_t>(file_size.QuadPart);
+            mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        CloseHandle(file);
+        if (!mapping)
+            return nullptr;
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view)
+            return nullptr;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            size = static_cast<size_t>(st.st_size);
+            view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (!view || view == MAP_FAILED)
+            return nullptr;
+
+        // Demuxing reads mostly forward, let the kernel read ahead aggressively
+        posix_madvise(view, size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+        std::unique_ptr<MemoryInput> input(new MemoryInput(static_cast<const uint8_t *>(view), size));
+        input->m_mapping = view;
+        return input;
+    }
+
+    /// Create a reader of the block for one format context (set as AVFormatContext::pb before opening)
+    /// @return Reader positioned at the start, nullptr on allocation failure
+    /// @note The format context does not free a custom reader, freeIOContext() does after avformat_close_input()
+    AVIOContext *MemoryInput::createIOContext() const
+    {
+        uint8_t *buffer = static_cast<uint8_t *>(av_malloc(IO_BUFFER_SIZE));
+        if (!buffer)
+            return nullptr;
+        Reader *reader = new Reader{this, 0};
+        AVIOContext *io = avio_alloc_context(buffer, IO_BUFFER_SIZE, 0, reader, &MemoryInput::readPacket, nullptr, &MemoryInput::seekPacket);
+        if (!io)
+        {
+            av_free(buffer);
+            delete reader;
+        }
+        return io;
+    }
+
+    /// Free a reader created by createIOContext()
+    /// @param io Reader to free, set to nullptr (no-op if already nullptr)
+    void MemoryInput::freeIOContext(AVIOContext **io)
+    {
+        if (!*io)
+            return;
+        delete static_cast<Reader *>((*io)->opaque);
+        av_freep(&(*io)->buffer); // may have been reallocated by the demuxer
+        avio_context_free(io);
+    }
+
+    /// Copy the next bytes of the block into the AVIOContext buffer
+    /// @param opaque Reader
+    /// @param buf Destination buffer
+    /// @param buf_size Maximum number of bytes to copy
+    /// @return Number of bytes copied, AVERROR_EOF at the end of the block
+    int MemoryInput::readPacket(void *opaque, uint8_t *buf, int buf_size)
+    {
+        Reader *reader = static_cast<Reader *>(opaque);
+        const int64_t left = static_cast<int64_t>(reader->input->m_size) - reader->pos;
+        if (left <= 0)
+            return AVERROR_EOF;
+        const int n = static_cast<int>(std::min<int64_t>(left, buf_size));
+        std::memcpy(buf, reader->input->m_data + reader->pos, static_cast<size_t>(n));
+        reader->pos += n;
+        return n;
+    }
+
+    /// Move the read position or report the block size
+    /// @param opaque Reader
+    /// @param offset Offset relative to whence
+    /// @param whence SEEK_SET, SEEK_CUR, SEEK_END or AVSEEK_SIZE, optionally with AVSEEK_FORCE
+    /// @return New position or block size, AVERROR(EINVAL) for positions outside the block
+    int64_t MemoryInput::seekPacket(void *opaque, int64_t offset, int whence)
+    {
+        Reader *reader = static_cast<Reader *>(opaque);
+        const int64_t size = static_cast<int64_t>(reader->input->m_size);
+        int64_t pos;
+        switch (whence & ~AVSEEK_FORCE)
+        {
+        case AVSEEK_SIZE:
+            return size;
+        case SEEK_SET:
+            pos = offset;
+            break;
+        case SEEK_CUR:
+            pos = reader->pos + offset;
+            break;
+        case SEEK_END:
+            pos = size + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+        }
+        if (pos < 0 || pos > size)
+            return AVERROR(EINVAL);
+        reader->pos = pos;
+        return pos;
+    }
+
+} // namespace DG
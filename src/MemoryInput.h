@@ -0,0 +1,62 @@
+//
+// In-memory and memory-mapped input for the demuxer
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef MEMORY_INPUT_H
+#define MEMORY_INPUT_H
+
+extern "C"
+{
+#include <libavformat/avio.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace DG
+{
+    /// Read-only block of memory holding a whole media file, demuxed through a custom AVIOContext
+    ///
+    /// Either a caller buffer (kept alive by an optional owner) or a file mapped into memory, which replaces
+    /// file reads by page faults and lets blobs from object storage or a message bus be decoded without temporary files.
+    class MemoryInput
+    {
+    public:
+        MemoryInput(const uint8_t *data, size_t size, std::shared_ptr<const void> owner = nullptr);
+        ~MemoryInput();
+
+        MemoryInput(const MemoryInput &) = delete;
+        MemoryInput &operator=(const MemoryInput &) = delete;
+
+        static std::unique_ptr<MemoryInput> mapFile(const std::string &path); //!< Map a regular file read-only (nullptr on failure or for an empty file)
+
+        const uint8_t *data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+        AVIOContext *createIOContext() const;        //!< New reader positioned at the start, freed with freeIOContext()
+        static void freeIOContext(AVIOContext **io); //!< Free a reader of createIOContext() and its buffer, sets *io to nullptr
+
+    private:
+        /// Read position of one AVIOContext over the block
+        struct Reader
+        {
+            const MemoryInput *input; //!< Block read from
+            int64_t pos;              //!< Offset of the next byte read
+        };
+
+        static int readPacket(void *opaque, uint8_t *buf, int buf_size);   //!< AVIOContext read callback
+        static int64_t seekPacket(void *opaque, int64_t offset, int whence); //!< AVIOContext seek callback, answers AVSEEK_SIZE
+
+        const uint8_t *m_data = nullptr;      //!< First byte of the file
+        size_t m_size = 0;                    //!< File size in bytes
+        std::shared_ptr<const void> m_owner;  //!< Keeps a caller buffer alive (nullptr for mapped files)
+        void *m_mapping = nullptr;            //!< Mapped view to unmap in the destructor (nullptr for caller buffers)
+    };
+
+} // namespace DG
+
+#endif // MEMORY_INPUT_H
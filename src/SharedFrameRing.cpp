@@ -0,0 +1,650 @@
+//
+// Shared-memory frame ring for consumers in other processes
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#include "SharedFrameRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#include <filesystem>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace DG
+{
+    namespace
+    {
+        const char RING_MAGIC[8] = {'D', 'G', 'S', 'H', 'M', 'R', '0', '1'}; //!< Ring signature and layout version
+        const int LINE_ALIGNMENT = 64;                                         //!< Row alignment in slots, for vectorized conversion
+        const size_t SLOT_ALIGNMENT = 4096;                                    //!< Slots start on page boundaries
+        const int32_t SLOT_WRITING = -1;                                       //!< Slot pin count while the publisher writes the slot
+        const std::chrono::microseconds POLL_INTERVAL(250);                    //!< Sleep between checks where no futex is available
+        const std::chrono::milliseconds SLOT_POLL_INTERVAL(1);                 //!< Sleep of a publisher waiting for consumers to release a slot
+
+        size_t alignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        /// Check that a ring name is usable on every platform: no path separators, short enough for macOS
+        bool validRingName(const std::string &name)
+        {
+            return !name.empty() && name.size() <= 30 && name.find_first_of("/\\") == std::string::npos;
+        }
+    } // namespace
+
+    /// Format of the frames read from a capture
+    /// @param capture Opened capture
+    /// @return Output layout of the capture, linesize = row_bytes
+    SharedFrameFormat SharedFrameFormat::of(const VideoCapture &capture)
+    {
+        const VideoCaptureOptions &options = capture.options();
+        SharedFrameFormat format;
+        format.pixel_format = options.tensor.enabled ? AV_PIX_FMT_NONE : options.pixel_format;
+        format.tensor_layout = static_cast<int32_t>(options.tensor.layout);
+        format.tensor_dtype = static_cast<int32_t>(options.tensor.dtype);
+        format.width = capture.outputWidth();
+        format.height = capture.outputHeight();
+        format.rows = capture.outputRows();
+        format.row_bytes = capture.outputRowBytes();
+        format.linesize = format.row_bytes;
+        return format;
+    }
+
+    /// Check if two formats describe the same frames, rows may be padded differently
+    bool SharedFrameFormat::sameFrames(const SharedFrameFormat &other) const
+    {
+        return pixel_format == other.pixel_format && width == other.width && height == other.height && rows == other.rows &&
+               row_bytes == other.row_bytes && (!isTensor() || (tensor_layout == other.tensor_layout && tensor_dtype == other.tensor_dtype));
+    }
+
+    /// Mapping of one ring: header with the slot states followed by the page-aligned slots
+    class SharedFrameRing
+    {
+    public:
+        static std::shared_ptr<SharedFrameRing> create(const std::string &name, const SharedFrameFormat &format, int slot_count);
+        static std::shared_ptr<SharedFrameRing> open(const std::string &name);
+        ~SharedFrameRing();
+
+        SharedFrameRing(const SharedFrameRing &) = delete;
+        SharedFrameRing &operator=(const SharedFrameRing &) = delete;
+
+        const SharedFrameFormat &format() const { return m_header->format; }
+        uint8_t *slotData(int slot) const { return reinterpret_cast<uint8_t *>(m_header) + m_header->data_offset + m_header->slot_size * static_cast<size_t>(slot); }
+
+        int claimFreeSlot();                                                     //!< Take the oldest slot no consumer pins for writing (-1 if all are pinned)
+        void publishSlot(int slot, uint64_t sequence, double timestamp_ms);      //!< Make a written slot visible to consumers and wake them
+        void abandonSlot(int slot);                                              //!< Give back a claimed slot left empty
+        bool pinFrame(uint64_t after, bool latest, int &slot, uint64_t &sequence, double &timestamp_ms); //!< Pin the oldest (newest) frame after a sequence number
+        void unpinSlot(int slot);                                                //!< Release one pin of a slot
+        void markClosed();                                                       //!< Tell consumers no more frames follow and wake them
+        bool closed() const { return m_header->closed.load(std::memory_order_acquire) != 0; }
+        uint32_t wakeCount() const { return m_header->wake.load(std::memory_order_acquire); }
+        void waitForPublish(uint32_t seen, int timeout_ms) const;                //!< Wait until wakeCount() differs from seen or timeout_ms passed (spurious returns possible)
+        void unlink();                                                           //!< Remove the name of a created ring, mappings stay valid
+
+    private:
+        /// State of one slot, changed by the publisher and all consumers
+        struct Slot
+        {
+            std::atomic<int32_t> refs;      //!< Pins held by consumers, SLOT_WRITING while the publisher writes
+            std::atomic<uint64_t> sequence; //!< Sequence number of the frame in the slot (0 = empty)
+            double timestamp_ms;            //!< Frame timestamp, written before the slot is published
+        };
+
+        /// Start of the mapping
+        struct Header
+        {
+            char magic[8];                   //!< RING_MAGIC
+            uint32_t header_size;            //!< sizeof(Header), catches builds with a different layout
+            uint32_t slot_count;             //!< Number of slots in use
+            uint64_t slot_size;              //!< Distance in bytes between slots
+            uint64_t data_offset;            //!< Offset of the first slot from the start of the mapping
+            uint64_t total_size;             //!< Size of the mapping in bytes
+            SharedFrameFormat format;        //!< Layout of the frames in the slots
+            std::atomic<uint32_t> ready;     //!< Set once the header is written
+            std::atomic<uint32_t> wake;      //!< Bumped by every publish and by close, futex word consumers wait on
+            std::atomic<uint32_t> closed;    //!< Publisher closed the ring
+            Slot slots[SharedFramePublisher::MAX_SLOTS]; //!< Slot states
+        };
+
+        static_assert(std::atomic<int32_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free &&
+                          std::atomic<uint64_t>::is_always_lock_free,
+                      "Atomics shared between processes must be lock-free");
+
+        SharedFrameRing() = default;
+        bool validate(size_t mapped_size) const; //!< Check the header of an opened ring against the mapped size
+        void wakeConsumers();                    //!< Bump the wake counter and wake all waiting consumers
+
+        Header *m_header = nullptr; //!< Start of the mapping
+        size_t m_size = 0;          //!< Mapped size in bytes
+        std::string m_name;         //!< Platform name of the shared memory object
+        bool m_linked = false;      //!< Name of a created ring not removed yet
+#ifdef _WIN32
+        HANDLE m_mapping = nullptr; //!< File mapping handle, the mapping exists while a handle is open
+#endif
+    };
+
+    /// Create a ring, replacing any ring of the same name (processes mapping the old one keep it)
+    /// @param name Ring name, up to 30 characters without path separators
+    /// @param format Frame layout, linesize is the row stride in the slots
+    /// @param slot_count Number of slots (1..MAX_SLOTS)
+    /// @return Mapped ring with empty slots, nullptr if it cannot be created
+    std::shared_ptr<SharedFrameRing> SharedFrameRing::create(const std::string &name, const SharedFrameFormat &format, int slot_count)
+    {
+        if (!validRingName(name) || slot_count < 1 || slot_count > SharedFramePublisher::MAX_SLOTS || format.rows <= 0 || format.linesize <= 0)
+            return nullptr;
+
+        const size_t data_offset = alignUp(sizeof(Header), SLOT_ALIGNMENT);
+        const size_t slot_size = alignUp(static_cast<size_t>(format.linesize) * static_cast<size_t>(format.rows), SLOT_ALIGNMENT);
+        const size_t size = data_offset + slot_size * static_cast<size_t>(slot_count);
+
+        std::shared_ptr<SharedFrameRing> ring(new SharedFrameRing());
+        void *base = nullptr;
+#ifdef _WIN32
+        ring->m_name = "Local\\" + name;
+        const std::wstring wide_name = std::filesystem::u8path(ring->m_name).wstring();
+        ring->m_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                             static_cast<DWORD>(size & 0xFFFFFFFFu), wide_name.c_str());
+        if (!ring->m_mapping)
+            return nullptr;
+        if (GetLastError() == ERROR_ALREADY_EXISTS)
+            return nullptr; // named mappings cannot be replaced while another process holds them
+        base = MapViewOfFile(ring->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!base)
+            return nullptr;
+#else
+        ring->m_name = "/" + name;
+        shm_unlink(ring->m_name.c_str());
+        const int fd = shm_open(ring->m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            return nullptr;
+        ring->m_linked = true;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+            base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (!base || base == MAP_FAILED)
+            return nullptr;
+#endif
+        ring->m_size = size;
+
+        // Fresh memory is zeroed: all slots empty and unpinned
+        Header *header = new (base) Header();
+        ring->m_header = header;
+        std::memcpy(header->magic, RING_MAGIC, sizeof(RING_MAGIC));
+        header->header_size = sizeof(Header);
+        header->slot_count = static_cast<uint32_t>(slot_count);
+        header->slot_size = slot_size;
+        header->data_offset = data_offset;
+        header->total_size = size;
+        header->format = format;
+        header->ready.store(1, std::memory_order_release);
+        return ring;
+    }
+
+    /// Map an existing ring for reading
+    /// @param name Ring name given to SharedFramePublisher::create()
+    /// @return Mapped ring, nullptr if no complete ring of that name exists
+    std::shared_ptr<SharedFrameRing> SharedFrameRing::open(const std::string &name)
+    {
+        if (!validRingName(name))
+            return nullptr;
+
+        std::shared_ptr<SharedFrameRing> ring(new SharedFrameRing());
+        void *base = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        ring->m_name = "Local\\" + name;
+        const std::wstring wide_name = std::filesystem::u8path(ring->m_name).wstring();
+        ring->m_mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, wide_name.c_str());
+        if (!ring->m_mapping)
+            return nullptr;
+        base = MapViewOfFile(ring->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info;
+        if (!base || VirtualQuery(base, &info, sizeof(info)) == 0)
+        {
+            if (base)
+                UnmapViewOfFile(base);
+            return nullptr;
+        }
+        size = info.RegionSize;
+#else
+        ring->m_name = "/" + name;
+        const int fd = shm_open(ring->m_name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(Header)))
+        {
+            size = static_cast<size_t>(st.st_size);
+            base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (!base || base == MAP_FAILED)
+            return nullptr;
+#endif
+        ring->m_header = static_cast<Header *>(base);
+        ring->m_size = size;
+        if (!ring->validate(size))
+            return nullptr;
+        return ring;
+    }
+
+    /// Destructor unmaps the ring and removes the name of a created ring if close() did not
+    SharedFrameRing::~SharedFrameRing()
+    {
+        unlink();
+#ifdef _WIN32
+        if (m_header)
+            UnmapViewOfFile(m_header);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+#else
+        if (m_header)
+            munmap(m_header, m_size);
+#endif
+    }
+
+    /// Remove the name of a created ring, new subscribers cannot open it any more
+    void SharedFrameRing::unlink()
+    {
+#ifndef _WIN32
+        if (m_linked)
+            shm_unlink(m_name.c_str());
+#endif
+        m_linked = false;
+    }
+
+    /// Check the header of an opened ring: written completely, same layout version and consistent sizes
+    /// @param mapped_size Size of the mapping
+    /// @return true if the ring can be read safely
+    bool SharedFrameRing::validate(size_t mapped_size) const
+    {
+        const Header &header = *m_header;
+        if (std::memcmp(header.magic, RING_MAGIC, sizeof(RING_MAGIC)) != 0 || header.ready.load(std::memory_order_acquire) == 0 ||
+            header.header_size != sizeof(Header) || header.total_size > mapped_size)
+            return false;
+
+        const SharedFrameFormat &format = header.format;
+        return header.slot_count >= 1 && header.slot_count <= static_cast<uint32_t>(SharedFramePublisher::MAX_SLOTS) &&
+               header.data_offset >= sizeof(Header) && format.rows > 0 && format.row_bytes > 0 && format.linesize >= format.row_bytes &&
+               static_cast<uint64_t>(format.linesize) * static_cast<uint64_t>(format.rows) <= header.slot_size &&
+               header.data_offset + header.slot_size * header.slot_count <= header.total_size;
+    }
+
+    /// Take the slot holding the oldest frame that no consumer pins, so recent frames stay readable longest
+    /// @return Slot now being written (its frame is dropped), -1 if every slot is pinned
+    int SharedFrameRing::claimFreeSlot()
+    {
+        const int count = static_cast<int>(m_header->slot_count);
+        for (int attempt = 0; attempt < count; attempt++)
+        {
+            int oldest = -1;
+            uint64_t oldest_sequence = 0;
+            for (int i = 0; i < count; i++)
+            {
+                const Slot &slot = m_header->slots[i];
+                const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+                if (slot.refs.load(std::memory_order_relaxed) == 0 && (oldest < 0 || sequence < oldest_sequence))
+                {
+                    oldest = i;
+                    oldest_sequence = sequence;
+                }
+            }
+            if (oldest < 0)
+                return -1;
+
+            // A consumer may pin the slot in between, then look again; acquire orders its reads before our writes
+            Slot &slot = m_header->slots[oldest];
+            int32_t expected = 0;
+            if (slot.refs.compare_exchange_strong(expected, SLOT_WRITING, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                slot.sequence.store(0, std::memory_order_relaxed);
+                return oldest;
+            }
+        }
+        return -1;
+    }
+
+    /// Make a written slot visible to consumers
+    /// @param slot Slot taken with claimFreeSlot()
+    /// @param sequence Sequence number of the frame written
+    /// @param timestamp_ms Frame timestamp in milliseconds
+    void SharedFrameRing::publishSlot(int slot, uint64_t sequence, double timestamp_ms)
+    {
+        Slot &state = m_header->slots[slot];
+        state.timestamp_ms = timestamp_ms;
+        state.sequence.store(sequence, std::memory_order_relaxed);
+        state.refs.store(0, std::memory_order_release); // frame data and fields above happen before any pin
+        wakeConsumers();
+    }
+
+    /// Give back a claimed slot without a frame
+    /// @param slot Slot taken with claimFreeSlot()
+    void SharedFrameRing::abandonSlot(int slot)
+    {
+        m_header->slots[slot].refs.store(0, std::memory_order_release);
+    }
+
+    /// Pin the frame following a sequence number
+    /// @param after Sequence number of the last frame read (0 = none)
+    /// @param latest Pin the newest frame instead of the oldest one after `after`
+    /// @param slot Receives the pinned slot
+    /// @param sequence Receives the sequence number of the pinned frame
+    /// @param timestamp_ms Receives the frame timestamp
+    /// @return true if a frame was pinned, false if no frame newer than `after` is available
+    bool SharedFrameRing::pinFrame(uint64_t after, bool latest, int &slot, uint64_t &sequence, double &timestamp_ms)
+    {
+        const int count = static_cast<int>(m_header->slot_count);
+        for (;;)
+        {
+            int best = -1;
+            uint64_t best_sequence = 0;
+            for (int i = 0; i < count; i++)
+            {
+                const uint64_t s = m_header->slots[i].sequence.load(std::memory_order_relaxed);
+                if (s > after && (best < 0 || (latest ? s > best_sequence : s < best_sequence)))
+                {
+                    best = i;
+                    best_sequence = s;
+                }
+            }
+            if (best < 0)
+                return false;
+
+            // Pin unless the publisher is rewriting the slot; acquire makes the published frame visible
+            Slot &state = m_header->slots[best];
+            int32_t refs = state.refs.load(std::memory_order_relaxed);
+            while (refs >= 0 && !state.refs.compare_exchange_weak(refs, refs + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+            }
+            if (refs < 0)
+                continue;
+
+            // The slot may have been reused between the scan and the pin
+            if (state.sequence.load(std::memory_order_relaxed) == best_sequence)
+            {
+                slot = best;
+                sequence = best_sequence;
+                timestamp_ms = state.timestamp_ms;
+                return true;
+            }
+            unpinSlot(best);
+        }
+    }
+
+    /// Release one pin of a slot, the publisher may reuse it once no pins are left
+    /// @param slot Slot pinned with pinFrame()
+    void SharedFrameRing::unpinSlot(int slot)
+    {
+        m_header->slots[slot].refs.fetch_sub(1, std::memory_order_release);
+    }
+
+    /// Mark the ring closed and wake all consumers, which then read the frames left and stop
+    void SharedFrameRing::markClosed()
+    {
+        m_header->closed.store(1, std::memory_order_release);
+        wakeConsumers();
+    }
+
+    /// Bump the wake counter and wake all consumers waiting in waitForPublish()
+    void SharedFrameRing::wakeConsumers()
+    {
+        m_header->wake.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+        syscall(SYS_futex, &m_header->wake, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    /// Wait for the next publish or close
+    /// @param seen wakeCount() read before the consumer found no frame
+    /// @param timeout_ms Maximum wait in milliseconds (-1 = no limit)
+    void SharedFrameRing::waitForPublish(uint32_t seen, int timeout_ms) const
+    {
+#ifdef __linux__
+        // Shared (not private) futex: the word is in memory mapped by several processes
+        struct timespec timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+        syscall(SYS_futex, &m_header->wake, FUTEX_WAIT, seen, timeout_ms < 0 ? nullptr : &timeout, nullptr, 0);
+#else
+        auto interval = POLL_INTERVAL;
+        if (timeout_ms >= 0)
+            interval = std::min<std::chrono::microseconds>(interval, std::chrono::milliseconds(timeout_ms));
+        if (wakeCount() == seen)
+            std::this_thread::sleep_for(interval);
+#endif
+    }
+
+    /// Move a pinned frame, the source frame is left invalid
+    SharedFrame::SharedFrame(SharedFrame &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    /// Move a pinned frame, releasing the frame held before
+    SharedFrame &SharedFrame::operator=(SharedFrame &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_ring = std::move(other.m_ring);
+            m_slot = other.m_slot;
+            m_data = other.m_data;
+            m_sequence = other.m_sequence;
+            m_timestamp_ms = other.m_timestamp_ms;
+            other.m_slot = -1;
+            other.m_data = nullptr;
+        }
+        return *this;
+    }
+
+    /// Unpin the slot, the frame data must not be used afterwards
+    void SharedFrame::release()
+    {
+        if (m_ring && m_slot >= 0)
+            m_ring->unpinSlot(m_slot);
+        m_ring.reset();
+        m_slot = -1;
+        m_data = nullptr;
+    }
+
+    /// Destructor closes the ring
+    SharedFramePublisher::~SharedFramePublisher()
+    {
+        close();
+    }
+
+    /// Create a named ring sized for the frames of a capture, replacing an open ring
+    /// @param name Ring name subscribers open, up to 30 characters without path separators
+    /// @param capture Opened capture publish() reads from, must outlive the publisher (not device_output);
+    ///        without prefetch frames are converted straight into the slots
+    /// @param slot_count Number of slots (1..MAX_SLOTS), at least one more than the frames consumers pin at once
+    /// @return true on success, false if the capture is not opened or the shared memory cannot be created
+    bool SharedFramePublisher::create(const std::string &name, VideoCapture &capture, int slot_count)
+    {
+        close();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto capture_lock = capture.lockCalls();
+        if (!capture.isOpened() || capture.options().device_output)
+            return false;
+
+        SharedFrameFormat format = SharedFrameFormat::of(capture);
+        format.linesize = static_cast<int32_t>(alignUp(static_cast<size_t>(format.row_bytes), LINE_ALIGNMENT));
+        m_ring = SharedFrameRing::create(name, format, slot_count);
+        if (!m_ring)
+            return false;
+        m_capture = &capture;
+        m_sequence = 0;
+        m_opened = true;
+        return true;
+    }
+
+    /// Read the next frame of the capture into a free slot and publish it
+    /// @param timeout_ms Maximum wait for consumers to release a slot when all are pinned (-1 = no limit, 0 = no wait)
+    /// @return 1 if a frame was published, 0 if no slot was released in time (no frame was read),
+    ///         -1 on EOS, error, closed publisher or when the output layout of the capture changed (e.g. reopen() to another size)
+    /// @note close() from another thread ends the wait for a slot, which returns -1
+    int SharedFramePublisher::publish(int timeout_ms)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_ring)
+            return -1;
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+        int slot;
+        while ((slot = m_ring->claimFreeSlot()) < 0)
+        {
+            if (m_closing)
+                return -1;
+            if (timeout_ms >= 0 && std::chrono::steady_clock::now() >= deadline)
+                return 0;
+            std::this_thread::sleep_for(SLOT_POLL_INTERVAL);
+        }
+
+        // Output layout must stay the one of the ring between the check and the read
+        auto capture_lock = m_capture->lockCalls();
+        const SharedFrameFormat &format = m_ring->format();
+        int64_t pts = AV_NOPTS_VALUE;
+        if (!SharedFrameFormat::of(*m_capture).sameFrames(format) || !m_capture->readFrameInto(m_ring->slotData(slot), format.linesize, &pts))
+        {
+            m_ring->abandonSlot(slot);
+            return -1;
+        }
+        m_ring->publishSlot(slot, ++m_sequence, m_capture->ptsToMsec(pts));
+        return 1;
+    }
+
+    /// Mark the ring closed and remove its name; subscribers read the frames left, new ones cannot open it
+    void SharedFramePublisher::close()
+    {
+        // A publish() in another thread may wait for a slot forever while holding the lock, end that wait first
+        m_closing = true;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = false;
+        if (!m_ring)
+            return;
+        m_opened = false;
+        m_ring->markClosed();
+        m_ring->unlink();
+        m_ring.reset();
+        m_capture = nullptr;
+    }
+
+    /// Check if a ring is created (does not wait for a publish() in progress)
+    bool SharedFramePublisher::isOpened() const
+    {
+        return m_opened;
+    }
+
+    /// Sequence number of the last frame published, frames are numbered from 1 (does not wait for a publish() in progress)
+    uint64_t SharedFramePublisher::sequence() const
+    {
+        return m_sequence;
+    }
+
+    /// Open a ring created by a publisher, reading starts at the oldest frame still in the ring
+    /// @param name Ring name given to SharedFramePublisher::create()
+    /// @return true on success, false if no ring of that name exists (yet)
+    bool SharedFrameSubscriber::open(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ring = SharedFrameRing::open(name);
+        m_last_sequence = 0;
+        return m_ring != nullptr;
+    }
+
+    /// Close the ring; frames still pinned keep the mapping until released
+    void SharedFrameSubscriber::close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ring.reset();
+    }
+
+    /// Check if a ring is opened
+    bool SharedFrameSubscriber::isOpened() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ring != nullptr;
+    }
+
+    /// Layout of the frames of the opened ring
+    /// @return Frame format, default-constructed if no ring is opened
+    SharedFrameFormat SharedFrameSubscriber::format() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ring ? m_ring->format() : SharedFrameFormat();
+    }
+
+    /// Pin the next frame of the ring
+    /// @param frame Receives the pinned frame (a frame it held before is released)
+    /// @param timeout_ms Maximum wait for a frame in milliseconds (-1 = until the publisher closes, 0 = no wait)
+    /// @param latest Read the newest frame, skipping older ones not read yet
+    /// @return 1 if a frame was read, 0 on timeout, -1 if the publisher closed and all its frames were read (or no ring is opened)
+    /// @note Frames overwritten before they were read are skipped, visible as a gap in the sequence numbers
+    int SharedFrameSubscriber::read(SharedFrame &frame, int timeout_ms, bool latest)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        frame.release();
+        if (!m_ring)
+            return -1;
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+        for (;;)
+        {
+            // Wake counter is read before the slots, so a frame published in between ends the wait at once
+            const uint32_t seen = m_ring->wakeCount();
+            if (pinNext(frame, latest))
+                return 1;
+            if (m_ring->closed())
+                return pinNext(frame, latest) ? 1 : -1;
+
+            int wait_ms = -1;
+            if (timeout_ms >= 0)
+            {
+                const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                if (left <= 0)
+                    return 0;
+                wait_ms = static_cast<int>(left);
+            }
+            m_ring->waitForPublish(seen, wait_ms);
+        }
+    }
+
+    /// Pin the next (or newest) frame after the last one read
+    /// @param frame Receives the pinned frame
+    /// @param latest Pin the newest frame
+    /// @return true if a frame was pinned (m_mutex must be held)
+    bool SharedFrameSubscriber::pinNext(SharedFrame &frame, bool latest)
+    {
+        int slot = -1;
+        uint64_t sequence = 0;
+        double timestamp_ms = 0;
+        if (!m_ring->pinFrame(m_last_sequence, latest, slot, sequence, timestamp_ms))
+            return false;
+        frame.m_ring = m_ring;
+        frame.m_slot = slot;
+        frame.m_data = m_ring->slotData(slot);
+        frame.m_sequence = sequence;
+        frame.m_timestamp_ms = timestamp_ms;
+        m_last_sequence = sequence;
+        return true;
+    }
+
+} // namespace DG
@@ -0,0 +1,128 @@
+//
+// Shared-memory frame ring for consumers in other processes
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef SHARED_FRAME_RING_H
+#define SHARED_FRAME_RING_H
+
+#include "VideoCapture.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace DG
+{
+    /// Layout of the frames of a ring, stored in the ring header so consumers need no capture options
+    struct SharedFrameFormat
+    {
+        int32_t pixel_format = AV_PIX_FMT_NONE; //!< Output pixel format of image frames (AV_PIX_FMT_NONE for tensors)
+        int32_t tensor_layout = 0;              //!< TensorLayout of tensor frames
+        int32_t tensor_dtype = 0;               //!< TensorDataType of tensor frames
+        int32_t width = 0;                      //!< Output width in pixels
+        int32_t height = 0;                     //!< Output height in pixels
+        int32_t rows = 0;                       //!< Rows per frame, VideoCapture::outputRows() (planes of NV12/YUV420P follow each other)
+        int32_t row_bytes = 0;                  //!< Packed row size, VideoCapture::outputRowBytes()
+        int32_t linesize = 0;                   //!< Distance in bytes between rows (row_bytes rounded up to 64 in a ring)
+
+        static SharedFrameFormat of(const VideoCapture &capture); //!< Format of the frames read from an opened capture, linesize = row_bytes
+        bool isTensor() const { return pixel_format == AV_PIX_FMT_NONE; }
+        bool sameFrames(const SharedFrameFormat &other) const; //!< Same frame layout apart from linesize
+    };
+
+    class SharedFrameRing; //!< Mapping of one ring, shared by its publisher or subscriber and the frames pinned from it
+
+    /// Frame pinned in a slot of a shared ring: the publisher does not reuse the slot until the frame is released
+    class SharedFrame
+    {
+    public:
+        SharedFrame() = default;
+        ~SharedFrame() { release(); }
+        SharedFrame(SharedFrame &&other) noexcept;
+        SharedFrame &operator=(SharedFrame &&other) noexcept;
+        SharedFrame(const SharedFrame &) = delete;
+        SharedFrame &operator=(const SharedFrame &) = delete;
+
+        bool valid() const { return m_slot >= 0; }
+        const uint8_t *data() const { return m_data; }        //!< First row of the frame, SharedFrameFormat::rows rows of SharedFrameFormat::linesize bytes
+        uint64_t sequence() const { return m_sequence; }      //!< Sequence number of the frame, 1 for the first frame published
+        double timestampMs() const { return m_timestamp_ms; } //!< Frame timestamp in milliseconds (CAP_PROP_POS_MSEC of the publisher)
+        void release();                                       //!< Unpin the slot (no-op for an invalid frame)
+
+    private:
+        friend class SharedFrameSubscriber;
+        std::shared_ptr<SharedFrameRing> m_ring; //!< Mapping holding the slot, kept alive while the frame is pinned
+        int m_slot = -1;                         //!< Pinned slot (-1 = none)
+        const uint8_t *m_data = nullptr;         //!< Frame data in the mapping
+        uint64_t m_sequence = 0;                 //!< Sequence number of the frame
+        double m_timestamp_ms = 0;               //!< Frame timestamp in milliseconds
+    };
+
+    /// Publisher of a capture's frames to a named shared-memory ring (POSIX shared memory, named file mapping on Windows)
+    ///
+    /// Each publish() reads one frame straight into a free slot with VideoCapture::readFrameInto(), so frames cross process
+    /// boundaries without copies or serialization. Slots pinned by consumers are never overwritten; the oldest unpinned slot
+    /// is reused, so slow consumers see gaps in the sequence numbers instead of blocking the publisher.
+    class SharedFramePublisher
+    {
+    public:
+        static constexpr int MAX_SLOTS = 64; //!< Maximum number of slots of a ring
+
+        SharedFramePublisher() = default;
+        ~SharedFramePublisher();
+
+        SharedFramePublisher(const SharedFramePublisher &) = delete;
+        SharedFramePublisher &operator=(const SharedFramePublisher &) = delete;
+
+        bool create(const std::string &name, VideoCapture &capture, int slot_count = 4);
+        int publish(int timeout_ms = -1); //!< Read the next frame of the capture into a slot: 1 = published, 0 = no free slot within timeout_ms, -1 = EOS or error
+        void close();                     //!< Mark the ring closed for subscribers and remove its name (mapped frames stay valid)
+        bool isOpened() const;
+        uint64_t sequence() const; //!< Sequence number of the last frame published (0 = none)
+
+    private:
+        mutable std::mutex m_mutex;              //!< Serializes publish() and close()
+        std::shared_ptr<SharedFrameRing> m_ring; //!< Created ring (nullptr = closed)
+        VideoCapture *m_capture = nullptr;       //!< Capture read by publish(), owned by the caller
+        std::atomic<bool> m_opened{false};       //!< A ring is created, readable while publish() waits for a slot
+        std::atomic<bool> m_closing{false};      //!< Set by close() to end a publish() waiting for a slot, e.g. pinned by a crashed subscriber
+        std::atomic<uint64_t> m_sequence{0};     //!< Sequence number of the last frame published
+    };
+
+    /// Subscriber reading the frames of a ring created by a SharedFramePublisher, usually in another process
+    ///
+    /// Frames are read in sequence order, skipping frames the publisher already overwrote, or newest first with latest.
+    /// Several subscribers may read the same ring; each pinned frame keeps its slot until released.
+    /// @note A subscriber process ending while it holds frames leaves their slots pinned until the publisher recreates the ring
+    class SharedFrameSubscriber
+    {
+    public:
+        SharedFrameSubscriber() = default;
+        ~SharedFrameSubscriber() = default;
+
+        SharedFrameSubscriber(const SharedFrameSubscriber &) = delete;
+        SharedFrameSubscriber &operator=(const SharedFrameSubscriber &) = delete;
+
+        bool open(const std::string &name);
+        void close();
+        bool isOpened() const;
+        SharedFrameFormat format() const; //!< Layout of the frames of the opened ring
+
+        int read(SharedFrame &frame, int timeout_ms = -1, bool latest = false); //!< Pin the next frame: 1 = read, 0 = timeout, -1 = publisher closed and no frame left
+
+    private:
+        bool pinNext(SharedFrame &frame, bool latest); //!< Pin the next (or newest) frame after m_last_sequence if one is available
+
+        mutable std::mutex m_mutex;              //!< Serializes reads from several threads
+        std::shared_ptr<SharedFrameRing> m_ring; //!< Opened ring (nullptr = closed)
+        uint64_t m_last_sequence = 0;            //!< Sequence number of the last frame read
+    };
+
+} // namespace DG
+
+#endif // SHARED_FRAME_RING_H
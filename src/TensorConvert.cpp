@@ -0,0 +1,488 @@
+//
+// Tensor output conversion kernels
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#include "TensorConvert.h"
+#include <cstring>
+
+extern "C"
+{
+#include <libavutil/cpu.h>
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define DG_TENSOR_X86 1
+#if defined(__GNUC__)
+#define DG_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#else
+#define DG_TARGET_AVX2
+#endif
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define DG_TENSOR_NEON 1
+#endif
+
+namespace DG
+{
+    namespace
+    {
+        /// Convert float to IEEE half precision with round-to-nearest-even
+        /// (branch-light variant of F. Giesen's public domain float_to_half_fast3_rtne)
+        inline uint16_t floatToHalf(float value)
+        {
+            const uint32_t f32infty = 255u << 23;
+            const uint32_t f16max = (127u + 16u) << 23;
+            const uint32_t denorm_magic_bits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+            const uint32_t sign_mask = 0x80000000u;
+
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            const uint32_t sign = bits & sign_mask;
+            bits ^= sign;
+
+            uint16_t result;
+            if (bits >= f16max)
+            {
+                // overflow saturates to infinity, NaN stays NaN
+                result = bits > f32infty ? 0x7e00 : 0x7c00;
+            }
+            else if (bits < (113u << 23))
+            {
+                // denormal or zero: let the FPU do the rounding by adding a magic value
+                float f, denorm_magic;
+                std::memcpy(&f, &bits, sizeof(f));
+                std::memcpy(&denorm_magic, &denorm_magic_bits, sizeof(denorm_magic));
+                f += denorm_magic;
+                std::memcpy(&bits, &f, sizeof(bits));
+                result = static_cast<uint16_t>(bits - denorm_magic_bits);
+            }
+            else
+            {
+                const uint32_t mant_odd = (bits >> 13) & 1;
+                bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff;
+                bits += mant_odd;
+                result = static_cast<uint16_t>(bits >> 13);
+            }
+            return static_cast<uint16_t>(result | (sign >> 16));
+        }
+
+        inline void storeElement(float value, float *dst)
+        {
+            *dst = value;
+        }
+
+        inline void storeElement(float value, uint16_t *dst)
+        {
+            *dst = floatToHalf(value);
+        }
+
+        //
+        // Portable kernels
+        //
+
+        void planeRowCopy(const uint8_t *src, void *dst, int width, float, float)
+        {
+            std::memcpy(dst, src, width);
+        }
+
+        template <typename T>
+        void planeRowScalar(const uint8_t *src, void *dst, int width, float scale, float bias)
+        {
+            T *out = static_cast<T *>(dst);
+            for (int x = 0; x < width; x++)
+                storeElement(src[x] * scale + bias, out + x);
+        }
+
+        void interleavedRowCopy(const uint8_t *const src[3], void *dst, int width, const float *, const float *)
+        {
+            uint8_t *out = static_cast<uint8_t *>(dst);
+            for (int x = 0; x < width; x++, out += 3)
+            {
+                out[0] = src[0][x];
+                out[1] = src[1][x];
+                out[2] = src[2][x];
+            }
+        }
+
+        template <typename T>
+        void interleavedRowScalar(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias)
+        {
+            T *out = static_cast<T *>(dst);
+            for (int x = 0; x < width; x++, out += 3)
+            {
+                storeElement(src[0][x] * scale[0] + bias[0], out + 0);
+                storeElement(src[1][x] * scale[1] + bias[1], out + 1);
+                storeElement(src[2][x] * scale[2] + bias[2], out + 2);
+            }
+        }
+
+#if defined(DG_TENSOR_X86)
+        //
+        // AVX2 + FMA + F16C kernels, 16 pixels per iteration (8 for NHWC floats)
+        //
+
+        /// Widen 8 bytes to floats and apply scale/bias
+        DG_TARGET_AVX2 inline __m256 normalize8(__m128i pixels, __m256 scale, __m256 bias)
+        {
+            return _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(pixels)), scale, bias);
+        }
+
+        DG_TARGET_AVX2 void planeRowFloat32Avx2(const uint8_t *src, void *dst, int width, float scale, float bias)
+        {
+            float *out = static_cast<float *>(dst);
+            const __m256 vscale = _mm256_set1_ps(scale);
+            const __m256 vbias = _mm256_set1_ps(bias);
+            int x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+                _mm256_storeu_ps(out + x, normalize8(pixels, vscale, vbias));
+                _mm256_storeu_ps(out + x + 8, normalize8(_mm_srli_si128(pixels, 8), vscale, vbias));
+            }
+            planeRowScalar<float>(src + x, out + x, width - x, scale, bias);
+        }
+
+        DG_TARGET_AVX2 void planeRowFloat16Avx2(const uint8_t *src, void *dst, int width, float scale, float bias)
+        {
+            uint16_t *out = static_cast<uint16_t *>(dst);
+            const __m256 vscale = _mm256_set1_ps(scale);
+            const __m256 vbias = _mm256_set1_ps(bias);
+            int x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+                const __m128i lo = _mm256_cvtps_ph(normalize8(pixels, vscale, vbias), _MM_FROUND_TO_NEAREST_INT);
+                const __m128i hi = _mm256_cvtps_ph(normalize8(_mm_srli_si128(pixels, 8), vscale, vbias), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), lo);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x + 8), hi);
+            }
+            planeRowScalar<uint16_t>(src + x, out + x, width - x, scale, bias);
+        }
+
+        // NHWC: three channel vectors are interleaved with cross-lane permutes and blends, the equivalent of NEON vst3
+
+        /// Interleave 8 pixels of three float channels into 24 consecutive floats c0 c1 c2 c0 c1 c2 ...
+        DG_TARGET_AVX2 inline void interleave3(__m256 c0, __m256 c1, __m256 c2, __m256 out[3])
+        {
+            // Per output vector: source pixel of each lane for each channel (lanes of other channels are don't-care)
+            const __m256i c0_index0 = _mm256_setr_epi32(0, 0, 0, 1, 0, 0, 2, 0);
+            const __m256i c1_index0 = _mm256_setr_epi32(0, 0, 0, 0, 1, 0, 0, 2);
+            const __m256i c2_index0 = _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 0, 0);
+            const __m256i c0_index1 = _mm256_setr_epi32(0, 3, 0, 0, 4, 0, 0, 5);
+            const __m256i c1_index1 = _mm256_setr_epi32(0, 0, 3, 0, 0, 4, 0, 0);
+            const __m256i c2_index1 = _mm256_setr_epi32(2, 0, 0, 3, 0, 0, 4, 0);
+            const __m256i c0_index2 = _mm256_setr_epi32(0, 0, 6, 0, 0, 7, 0, 0);
+            const __m256i c1_index2 = _mm256_setr_epi32(5, 0, 0, 6, 0, 0, 7, 0);
+            const __m256i c2_index2 = _mm256_setr_epi32(0, 5, 0, 0, 6, 0, 0, 7);
+
+            out[0] = _mm256_blend_ps(_mm256_blend_ps(_mm256_permutevar8x32_ps(c0, c0_index0), _mm256_permutevar8x32_ps(c1, c1_index0), 0x92),
+                                     _mm256_permutevar8x32_ps(c2, c2_index0), 0x24);
+            out[1] = _mm256_blend_ps(_mm256_blend_ps(_mm256_permutevar8x32_ps(c0, c0_index1), _mm256_permutevar8x32_ps(c1, c1_index1), 0x24),
+                                     _mm256_permutevar8x32_ps(c2, c2_index1), 0x49);
+            out[2] = _mm256_blend_ps(_mm256_blend_ps(_mm256_permutevar8x32_ps(c0, c0_index2), _mm256_permutevar8x32_ps(c1, c1_index2), 0x49),
+                                     _mm256_permutevar8x32_ps(c2, c2_index2), 0x92);
+        }
+
+        /// Normalize 8 pixels of each channel and interleave them
+        DG_TARGET_AVX2 inline void normalizeInterleaved8(const uint8_t *const src[3], int x, const float *scale, const float *bias, __m256 out[3])
+        {
+            __m256 channels[3];
+            for (int c = 0; c < 3; c++)
+            {
+                const __m128i pixels = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src[c] + x));
+                channels[c] = normalize8(pixels, _mm256_set1_ps(scale[c]), _mm256_set1_ps(bias[c]));
+            }
+            interleave3(channels[0], channels[1], channels[2], out);
+        }
+
+        DG_TARGET_AVX2 void interleavedRowCopyAvx2(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias)
+        {
+            // Byte shuffles placing pixels of one channel at their positions of each 16-byte output block (-1 = zero)
+            const __m128i c0_shuffle0 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+            const __m128i c1_shuffle0 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+            const __m128i c2_shuffle0 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+            const __m128i c0_shuffle1 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+            const __m128i c1_shuffle1 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+            const __m128i c2_shuffle1 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+            const __m128i c0_shuffle2 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+            const __m128i c1_shuffle2 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+            const __m128i c2_shuffle2 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+
+            uint8_t *out = static_cast<uint8_t *>(dst);
+            int x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src[0] + x));
+                const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src[1] + x));
+                const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src[2] + x));
+                __m128i *block = reinterpret_cast<__m128i *>(out + 3 * x);
+                _mm_storeu_si128(block + 0, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, c0_shuffle0), _mm_shuffle_epi8(c1, c1_shuffle0)),
+                                                         _mm_shuffle_epi8(c2, c2_shuffle0)));
+                _mm_storeu_si128(block + 1, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, c0_shuffle1), _mm_shuffle_epi8(c1, c1_shuffle1)),
+                                                         _mm_shuffle_epi8(c2, c2_shuffle1)));
+                _mm_storeu_si128(block + 2, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, c0_shuffle2), _mm_shuffle_epi8(c1, c1_shuffle2)),
+                                                         _mm_shuffle_epi8(c2, c2_shuffle2)));
+            }
+            const uint8_t *const rest[3] = {src[0] + x, src[1] + x, src[2] + x};
+            interleavedRowCopy(rest, out + 3 * x, width - x, scale, bias);
+        }
+
+        DG_TARGET_AVX2 void interleavedRowFloat32Avx2(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias)
+        {
+            float *out = static_cast<float *>(dst);
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                __m256 pixels[3];
+                normalizeInterleaved8(src, x, scale, bias, pixels);
+                for (int i = 0; i < 3; i++)
+                    _mm256_storeu_ps(out + 3 * x + 8 * i, pixels[i]);
+            }
+            const uint8_t *const rest[3] = {src[0] + x, src[1] + x, src[2] + x};
+            interleavedRowScalar<float>(rest, out + 3 * x, width - x, scale, bias);
+        }
+
+        DG_TARGET_AVX2 void interleavedRowFloat16Avx2(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias)
+        {
+            uint16_t *out = static_cast<uint16_t *>(dst);
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                // Conversion is per element, so the floats are interleaved before narrowing
+                __m256 pixels[3];
+                normalizeInterleaved8(src, x, scale, bias, pixels);
+                for (int i = 0; i < 3; i++)
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 3 * x + 8 * i), _mm256_cvtps_ph(pixels[i], _MM_FROUND_TO_NEAREST_INT));
+            }
+            const uint8_t *const rest[3] = {src[0] + x, src[1] + x, src[2] + x};
+            interleavedRowScalar<uint16_t>(rest, out + 3 * x, width - x, scale, bias);
+        }
+#endif
+
+#if defined(DG_TENSOR_NEON)
+        //
+        // NEON kernels, 8 pixels per iteration; NHWC uses the structured vst3 stores
+        //
+
+        inline float32x4_t normalizeLow(uint16x8_t pixels, float scale, float32x4_t bias)
+        {
+            return vfmaq_n_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(pixels))), scale);
+        }
+
+        inline float32x4_t normalizeHigh(uint16x8_t pixels, float scale, float32x4_t bias)
+        {
+            return vfmaq_n_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(pixels))), scale);
+        }
+
+        inline uint16x4_t toHalf(float32x4_t value)
+        {
+            return vreinterpret_u16_f16(vcvt_f16_f32(value));
+        }
+
+        void planeRowFloat32Neon(const uint8_t *src, void *dst, int width, float scale, float bias)
+        {
+            float *out = static_cast<float *>(dst);
+            const float32x4_t vbias = vdupq_n_f32(bias);
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                const uint16x8_t pixels = vmovl_u8(vld1_u8(src + x));
+                vst1q_f32(out + x, normalizeLow(pixels, scale, vbias));
+                vst1q_f32(out + x + 4, normalizeHigh(pixels, scale, vbias));
+            }
+            planeRowScalar<float>(src + x, out + x, width - x, scale, bias);
+        }
+
+        void planeRowFloat16Neon(const uint8_t *src, void *dst, int width, float scale, float bias)
+        {
+            uint16_t *out = static_cast<uint16_t *>(dst);
+            const float32x4_t vbias = vdupq_n_f32(bias);
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                const uint16x8_t pixels = vmovl_u8(vld1_u8(src + x));
+                vst1q_u16(out + x, vcombine_u16(toHalf(normalizeLow(pixels, scale, vbias)),
+                                                toHalf(normalizeHigh(pixels, scale, vbias))));
+            }
+            planeRowScalar<uint16_t>(src + x, out + x, width - x, scale, bias);
+        }
+
+        void interleavedRowCopyNeon(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias)
+        {
+            uint8_t *out = static_cast<uint8_t *>(dst);
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                uint8x8x3_t pixels;
+                pixels.val[0] = vld1_u8(src[0] + x);
+                pixels.val[1] = vld1_u8(src[1] + x);
+                pixels.val[2] = vld1_u8(src[2] + x);
+                vst3_u8(out + 3 * x, pixels);
+            }
+            const uint8_t *const rest[3] = {src[0] + x, src[1] + x, src[2] + x};
+            interleavedRowCopy(rest, out + 3 * x, width - x, scale, bias);
+        }
+
+        void interleavedRowFloat32Neon(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias)
+        {
+            float *out = static_cast<float *>(dst);
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                float32x4x3_t lo, hi;
+                for (int c = 0; c < 3; c++)
+                {
+                    const uint16x8_t pixels = vmovl_u8(vld1_u8(src[c] + x));
+                    const float32x4_t vbias = vdupq_n_f32(bias[c]);
+                    lo.val[c] = normalizeLow(pixels, scale[c], vbias);
+                    hi.val[c] = normalizeHigh(pixels, scale[c], vbias);
+                }
+                vst3q_f32(out + 3 * x, lo);
+                vst3q_f32(out + 3 * (x + 4), hi);
+            }
+            const uint8_t *const rest[3] = {src[0] + x, src[1] + x, src[2] + x};
+            interleavedRowScalar<float>(rest, out + 3 * x, width - x, scale, bias);
+        }
+
+        void interleavedRowFloat16Neon(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias)
+        {
+            uint16_t *out = static_cast<uint16_t *>(dst);
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                uint16x4x3_t lo, hi;
+                for (int c = 0; c < 3; c++)
+                {
+                    const uint16x8_t pixels = vmovl_u8(vld1_u8(src[c] + x));
+                    const float32x4_t vbias = vdupq_n_f32(bias[c]);
+                    lo.val[c] = toHalf(normalizeLow(pixels, scale[c], vbias));
+                    hi.val[c] = toHalf(normalizeHigh(pixels, scale[c], vbias));
+                }
+                vst3_u16(out + 3 * x, lo);
+                vst3_u16(out + 3 * (x + 4), hi);
+            }
+            const uint8_t *const rest[3] = {src[0] + x, src[1] + x, src[2] + x};
+            interleavedRowScalar<uint16_t>(rest, out + 3 * x, width - x, scale, bias);
+        }
+#endif
+
+    } // namespace
+
+    /// Size in bytes of one tensor element
+    /// @param dtype Element type
+    /// @return Element size in bytes
+    size_t tensorElementSize(TensorDataType dtype)
+    {
+        switch (dtype)
+        {
+        case TensorDataType::UInt8:
+            return 1;
+        case TensorDataType::Float16:
+            return 2;
+        case TensorDataType::Float32:
+            return 4;
+        }
+        return 1;
+    }
+
+    /// Constructor: precomputes the per-channel affine transform and selects row kernels for the running CPU
+    /// @param format Tensor output format; stddev entries must be non-zero for floating point types
+    TensorConverter::TensorConverter(const TensorFormat &format) : m_format(format)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            m_scale[c] = 1.0f / format.stddev[c];
+            m_bias[c] = -format.mean[c] / format.stddev[c];
+        }
+
+        switch (format.dtype)
+        {
+        case TensorDataType::UInt8:
+            m_plane_row = planeRowCopy;
+            m_interleaved_row = interleavedRowCopy;
+            break;
+        case TensorDataType::Float16:
+            m_plane_row = planeRowScalar<uint16_t>;
+            m_interleaved_row = interleavedRowScalar<uint16_t>;
+            break;
+        case TensorDataType::Float32:
+            m_plane_row = planeRowScalar<float>;
+            m_interleaved_row = interleavedRowScalar<float>;
+            break;
+        }
+
+#if defined(DG_TENSOR_X86)
+        // every CPU reporting AVX2 and FMA3 also implements F16C
+        const int required = AV_CPU_FLAG_AVX2 | AV_CPU_FLAG_FMA3;
+        if ((av_get_cpu_flags() & required) == required)
+        {
+            switch (format.dtype)
+            {
+            case TensorDataType::UInt8:
+                m_interleaved_row = interleavedRowCopyAvx2;
+                break;
+            case TensorDataType::Float16:
+                m_plane_row = planeRowFloat16Avx2;
+                m_interleaved_row = interleavedRowFloat16Avx2;
+                break;
+            case TensorDataType::Float32:
+                m_plane_row = planeRowFloat32Avx2;
+                m_interleaved_row = interleavedRowFloat32Avx2;
+                break;
+            }
+        }
+#elif defined(DG_TENSOR_NEON)
+        // NEON is mandatory on AArch64
+        switch (format.dtype)
+        {
+        case TensorDataType::UInt8:
+            m_interleaved_row = interleavedRowCopyNeon;
+            break;
+        case TensorDataType::Float16:
+            m_plane_row = planeRowFloat16Neon;
+            m_interleaved_row = interleavedRowFloat16Neon;
+            break;
+        case TensorDataType::Float32:
+            m_plane_row = planeRowFloat32Neon;
+            m_interleaved_row = interleavedRowFloat32Neon;
+            break;
+        }
+#endif
+    }
+
+    /// Convert three 8-bit channel planes into the output tensor
+    /// @param planes Source planes in output channel order
+    /// @param src_linesize Source line size in bytes of each plane
+    /// @param width Width in pixels
+    /// @param height Height in rows
+    /// @param dst Destination tensor
+    /// @param dst_linesize Destination row size in bytes; for NCHW consecutive channel planes are height rows apart
+    void TensorConverter::convert(const uint8_t *const planes[3], const int src_linesize[3], int width, int height,
+                                  uint8_t *dst, int dst_linesize) const
+    {
+        if (m_format.layout == TensorLayout::NCHW)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                uint8_t *plane = dst + static_cast<size_t>(c) * height * dst_linesize;
+                for (int y = 0; y < height; y++)
+                    m_plane_row(planes[c] + static_cast<size_t>(y) * src_linesize[c],
+                                plane + static_cast<size_t>(y) * dst_linesize, width, m_scale[c], m_bias[c]);
+            }
+        }
+        else
+        {
+            for (int y = 0; y < height; y++)
+            {
+                const uint8_t *const rows[3] = {planes[0] + static_cast<size_t>(y) * src_linesize[0],
+                                                planes[1] + static_cast<size_t>(y) * src_linesize[1],
+                                                planes[2] + static_cast<size_t>(y) * src_linesize[2]};
+                m_interleaved_row(rows, dst + static_cast<size_t>(y) * dst_linesize, width, m_scale, m_bias);
+            }
+        }
+    }
+
+} // namespace DG
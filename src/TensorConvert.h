@@ -0,0 +1,67 @@
+//
+// Tensor output conversion kernels
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef TENSOR_CONVERT_H
+#define TENSOR_CONVERT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace DG
+{
+    /// Memory layout of tensor output
+    enum class TensorLayout
+    {
+        NCHW, //!< Channel planes, one (height, width) plane per channel
+        NHWC, //!< Interleaved channels, (height, width, channels)
+    };
+
+    /// Element type of tensor output
+    enum class TensorDataType
+    {
+        UInt8,   //!< Raw pixel values, mean/stddev are ignored
+        Float16, //!< IEEE half precision, normalized
+        Float32, //!< IEEE single precision, normalized
+    };
+
+    /// Model-ready tensor output format: value = (pixel - mean[c]) / stddev[c], pixel in 0..255
+    struct TensorFormat
+    {
+        bool enabled = false;                            //!< Produce tensors instead of BGR24 frames
+        TensorLayout layout = TensorLayout::NCHW;        //!< Memory layout
+        TensorDataType dtype = TensorDataType::Float32;  //!< Element type
+        bool rgb = true;                                 //!< Channel order RGB (true) or BGR (false)
+        std::array<float, 3> mean = {0.0f, 0.0f, 0.0f};  //!< Per-channel mean in pixel units, in output channel order
+        std::array<float, 3> stddev = {1.0f, 1.0f, 1.0f}; //!< Per-channel standard deviation in pixel units, in output channel order
+    };
+
+    /// Size in bytes of one tensor element
+    size_t tensorElementSize(TensorDataType dtype);
+
+    /// Converts three 8-bit channel planes into a tensor with fused normalization, layout and type conversion
+    class TensorConverter
+    {
+    public:
+        explicit TensorConverter(const TensorFormat &format = TensorFormat());
+
+        void convert(const uint8_t *const planes[3], const int src_linesize[3], int width, int height,
+                     uint8_t *dst, int dst_linesize) const;
+
+    private:
+        using PlaneRowFn = void (*)(const uint8_t *src, void *dst, int width, float scale, float bias);
+        using InterleavedRowFn = void (*)(const uint8_t *const src[3], void *dst, int width, const float *scale, const float *bias);
+
+        TensorFormat m_format;                         //!< Output format
+        float m_scale[3] = {1.0f, 1.0f, 1.0f};         //!< Per-channel multiplier (1 / stddev)
+        float m_bias[3] = {0.0f, 0.0f, 0.0f};          //!< Per-channel offset (-mean / stddev)
+        PlaneRowFn m_plane_row = nullptr;              //!< Row kernel for NCHW layout, selected once for the running CPU
+        InterleavedRowFn m_interleaved_row = nullptr;  //!< Row kernel for NHWC layout, selected once for the running CPU
+    };
+
+} // namespace DG
+
+#endif // TENSOR_CONVERT_H
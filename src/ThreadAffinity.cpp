@@ -0,0 +1,155 @@
+//
+// CPU affinity of the threads created by a capture
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#include "ThreadAffinity.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace DG
+{
+    namespace
+    {
+        /// Parse a kernel CPU list such as "0-3,8-11"
+        /// @return CPUs in ascending order, empty for a malformed list
+        std::vector<int> parseCpuList(const std::string &list)
+        {
+            std::vector<int> cpus;
+            const char *pos = list.c_str();
+            while (*pos && *pos != '\n')
+            {
+                char *end = nullptr;
+                const long first = std::strtol(pos, &end, 10);
+                long last = first;
+                if (end == pos || first < 0)
+                    return {};
+                if (*end == '-')
+                {
+                    pos = end + 1;
+                    last = std::strtol(pos, &end, 10);
+                    if (end == pos || last < first)
+                        return {};
+                }
+                for (long cpu = first; cpu <= last; cpu++)
+                    cpus.push_back(static_cast<int>(cpu));
+                pos = *end == ',' ? end + 1 : end;
+                if (*end != ',' && *end && *end != '\n')
+                    return {};
+            }
+            return cpus;
+        }
+    } // namespace
+
+    /// CPUs of a NUMA node, e.g. to keep decoding and the buffers it first touches on the socket of a consumer
+    /// @param node NUMA node number
+    /// @return CPUs of the node in ascending order, empty if the node does not exist or NUMA is not supported
+    /// @note On Windows only nodes of processor group 0 (the first 64 logical processors) are supported
+    std::vector<int> numaNodeCpus(int node)
+    {
+        std::vector<int> cpus;
+        if (node < 0)
+            return cpus;
+#if defined(_WIN32)
+        GROUP_AFFINITY affinity = {};
+        if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity) || affinity.Group != 0)
+            return cpus;
+        for (int cpu = 0; cpu < 64; cpu++)
+            if (affinity.Mask & (KAFFINITY(1) << cpu))
+                cpus.push_back(cpu);
+#elif defined(__linux__)
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (std::getline(file, list))
+            cpus = parseCpuList(list);
+#endif
+        return cpus;
+    }
+
+    /// Restrict the calling thread to a set of CPUs; threads it creates afterwards inherit the set
+    /// @param cpus CPU numbers, must not be empty
+    /// @param previous Optional, receives the CPUs the thread could run on before
+    /// @return true on success, false if a CPU is invalid or affinity is not supported (macOS)
+    /// @note On Windows only CPUs of processor group 0 (the first 64 logical processors) can be used
+    bool setThreadAffinity(const std::vector<int> &cpus, std::vector<int> *previous)
+    {
+        if (cpus.empty() || *std::min_element(cpus.begin(), cpus.end()) < 0)
+            return false;
+#if defined(_WIN32)
+        DWORD_PTR mask = 0;
+        for (const int cpu : cpus)
+        {
+            if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8))
+                return false;
+            mask |= DWORD_PTR(1) << cpu;
+        }
+        const DWORD_PTR old_mask = SetThreadAffinityMask(GetCurrentThread(), mask);
+        if (old_mask == 0)
+            return false;
+        if (previous)
+        {
+            previous->clear();
+            for (int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); cpu++)
+                if (old_mask & (DWORD_PTR(1) << cpu))
+                    previous->push_back(cpu);
+        }
+        return true;
+#elif defined(__linux__)
+        // Dynamically sized sets cover machines with more than CPU_SETSIZE logical CPUs
+        const int max_cpu = std::max(*std::max_element(cpus.begin(), cpus.end()) + 1, static_cast<int>(CPU_SETSIZE));
+        cpu_set_t *set = CPU_ALLOC(max_cpu);
+        if (!set)
+            return false;
+        const size_t set_size = CPU_ALLOC_SIZE(max_cpu);
+        bool ok = true;
+        if (previous)
+        {
+            CPU_ZERO_S(set_size, set);
+            ok = pthread_getaffinity_np(pthread_self(), set_size, set) == 0;
+            previous->clear();
+            for (int cpu = 0; ok && cpu < max_cpu; cpu++)
+                if (CPU_ISSET_S(cpu, set_size, set))
+                    previous->push_back(cpu);
+        }
+        if (ok)
+        {
+            CPU_ZERO_S(set_size, set);
+            for (const int cpu : cpus)
+                CPU_SET_S(cpu, set_size, set);
+            ok = pthread_setaffinity_np(pthread_self(), set_size, set) == 0;
+        }
+        CPU_FREE(set);
+        return ok;
+#else
+        (void)previous;
+        return false;
+#endif
+    }
+
+    /// Change the affinity of the calling thread until the end of the scope
+    /// @param cpus CPU numbers (empty = leave the affinity unchanged)
+    ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int> &cpus)
+    {
+        if (!cpus.empty())
+            m_changed = setThreadAffinity(cpus, &m_previous);
+    }
+
+    /// Restore the affinity the thread had before the scope
+    ScopedThreadAffinity::~ScopedThreadAffinity()
+    {
+        if (m_changed && !m_previous.empty())
+            setThreadAffinity(m_previous);
+    }
+
+} // namespace DG
@@ -0,0 +1,37 @@
+//
+// CPU affinity of the threads created by a capture
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <vector>
+
+namespace DG
+{
+    std::vector<int> numaNodeCpus(int node); //!< CPUs of a NUMA node in ascending order (empty if the node does not exist or NUMA is not supported)
+    bool setThreadAffinity(const std::vector<int> &cpus, std::vector<int> *previous = nullptr); //!< Run the calling thread on a set of CPUs only
+
+    /// Affinity of the calling thread changed for a scope and restored at its end
+    ///
+    /// Threads inherit the affinity of the thread creating them, so FFmpeg decoder and swscale slice threads created
+    /// inside the scope stay on the given CPUs while the calling thread itself is unaffected outside of it.
+    class ScopedThreadAffinity
+    {
+    public:
+        explicit ScopedThreadAffinity(const std::vector<int> &cpus); //!< Empty cpus leave the affinity unchanged
+        ~ScopedThreadAffinity();
+
+        ScopedThreadAffinity(const ScopedThreadAffinity &) = delete;
+        ScopedThreadAffinity &operator=(const ScopedThreadAffinity &) = delete;
+
+    private:
+        bool m_changed = false;      //!< Affinity was changed and must be restored
+        std::vector<int> m_previous; //!< Affinity of the thread before the scope
+    };
+
+} // namespace DG
+
+#endif // THREAD_AFFINITY_H
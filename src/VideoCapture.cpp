@@ -1,9 +1,169 @@
 #include "VideoCapture.h"
+#include "ColorConvert.h"
+#include "ThreadAffinity.h"
 #include "opencv_enums.h"
-#include <sstream>
+#include <libavutil/imgutils.h>
+#include <libavutil/mathematics.h>
+#include <libavutil/pixdesc.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
 
 namespace DG
 {
+    namespace
+    {
+        constexpr size_t DECODED_QUEUE_DEPTH = 2; //!< Decoded frames queued between the decode and conversion stages of pipelined conversion
+
+        std::atomic<int64_t> allocation_count{0}; //!< Frames and packets allocated through allocFrame() / allocPacket()
+
+        /// Whether a decoder configured for one stream can decode another without being recreated
+        /// @param a Codec parameters of the stream the decoder was opened for
+        /// @param b Codec parameters of the new stream
+        /// @return true if codec, frame size, pixel format (where known) and extradata are equal
+        bool sameCodecParameters(const AVCodecParameters *a, const AVCodecParameters *b)
+        {
+            return a->codec_id == b->codec_id && a->width == b->width && a->height == b->height &&
+                   (a->format == b->format || a->format < 0 || b->format < 0) && a->extradata_size == b->extradata_size &&
+                   (a->extradata_size <= 0 || std::memcmp(a->extradata, b->extradata, static_cast<size_t>(a->extradata_size)) == 0);
+        }
+
+        /// Check if frames can be produced in a pixel format (main output and renditions)
+        bool isOutputFormat(AVPixelFormat format)
+        {
+            switch (format)
+            {
+            case AV_PIX_FMT_BGR24:
+            case AV_PIX_FMT_RGB24:
+            case AV_PIX_FMT_GRAY8:
+            case AV_PIX_FMT_NV12:
+            case AV_PIX_FMT_YUV420P:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /// Letterbox geometry: a region scaled to fit an output frame keeping its aspect ratio, centered
+        /// (same rounding as the scale filter with force_original_aspect_ratio=decrease)
+        /// @param src_width Width of the scaled region
+        /// @param src_height Height of the scaled region
+        /// @param dst_width Output frame width
+        /// @param dst_height Output frame height
+        /// @param format Output pixel format, the interior of subsampled formats is aligned to the chroma subsampling
+        /// @param scaled_width Receives the width of the scaled image
+        /// @param scaled_height Receives the height of the scaled image
+        /// @param pad_x Receives the left border
+        /// @param pad_y Receives the top border
+        void fitLetterbox(int src_width, int src_height, int dst_width, int dst_height, AVPixelFormat format,
+                          int &scaled_width, int &scaled_height, int &pad_x, int &pad_y)
+        {
+            const int fit_width = static_cast<int>(av_rescale(dst_height, src_width, src_height));
+            const int fit_height = static_cast<int>(av_rescale(dst_width, src_height, src_width));
+            scaled_width = std::max(1, std::min(fit_width, dst_width));
+            scaled_height = std::max(1, std::min(fit_height, dst_height));
+            pad_x = (dst_width - scaled_width) / 2;
+            pad_y = (dst_height - scaled_height) / 2;
+
+            const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(format);
+            if ((desc->log2_chroma_w || desc->log2_chroma_h) && (scaled_width != dst_width || scaled_height != dst_height))
+            {
+                const int align_x = 1 << desc->log2_chroma_w;
+                const int align_y = 1 << desc->log2_chroma_h;
+                scaled_width = std::max(align_x, scaled_width & ~(align_x - 1));
+                scaled_height = std::max(align_y, scaled_height & ~(align_y - 1));
+                pad_x = ((dst_width - scaled_width) / 2) & ~(align_x - 1);
+                pad_y = ((dst_height - scaled_height) / 2) & ~(align_y - 1);
+            }
+        }
+
+        /// Check if a decoded region is at least as large as its image in an output frame, so scaling never enlarges it
+        /// @param src_width Width of the decoded region
+        /// @param src_height Height of the decoded region
+        /// @param dst_width Output frame width
+        /// @param dst_height Output frame height
+        /// @param letterbox true if the region is fit keeping its aspect ratio, false if stretched to the output frame
+        bool coversOutput(int src_width, int src_height, int dst_width, int dst_height, bool letterbox)
+        {
+            const int fit_width = letterbox ? std::min(dst_width, static_cast<int>(av_rescale(dst_height, src_width, src_height))) : dst_width;
+            const int fit_height = letterbox ? std::min(dst_height, static_cast<int>(av_rescale(dst_width, src_height, src_width))) : dst_height;
+            return src_width >= fit_width && src_height >= fit_height;
+        }
+
+        /// Rendition frames of one decoded frame, pooled and attached to the main output frame as opaque_ref
+        struct RenditionSet
+        {
+            int count;                         //!< Number of frames converted
+            AVFrame *frames[MAX_RENDITIONS];   //!< Rendition frames in option order (allocated on first use, kept with the pooled set)
+        };
+
+        /// Allocator of the rendition set pool
+        /// @param size Size of RenditionSet
+        /// @return Zeroed set freeing its frames once the pool is gone, nullptr if out of memory
+        AVBufferRef *allocRenditionSet(void *, size_t size)
+        {
+            uint8_t *data = static_cast<uint8_t *>(av_mallocz(size));
+            if (!data)
+                return nullptr;
+            AVBufferRef *ref = av_buffer_create(data, size, [](void *, uint8_t *data)
+                                                {
+                RenditionSet *set = reinterpret_cast<RenditionSet *>(data);
+                for (AVFrame *&frame : set->frames)
+                    av_frame_free(&frame);
+                av_free(data); }, nullptr, 0);
+            if (!ref)
+                av_free(data);
+            return ref;
+        }
+
+        /// Make a swscale context converting YUV to RGB use the matrix and range the source is tagged with, as the
+        /// specialized kernels do (swscale defaults to BT.601 and takes full range only from the JPEG formats)
+        /// @param ctx Initialized context
+        /// @param src_format Source pixel format of the context
+        /// @param dst_format Output pixel format of the context, only RGB outputs are affected
+        /// @param colorspace Colorspace tag of the source
+        /// @param range Range tag of the source
+        void setSwsColorimetry(SwsContext *ctx, AVPixelFormat src_format, AVPixelFormat dst_format, AVColorSpace colorspace, AVColorRange range)
+        {
+            const AVPixFmtDescriptor *src_desc = av_pix_fmt_desc_get(src_format);
+            const AVPixFmtDescriptor *dst_desc = av_pix_fmt_desc_get(dst_format);
+            const int matrix = yuvMatrix(colorspace);
+            if (!src_desc || !dst_desc || (src_desc->flags & AV_PIX_FMT_FLAG_RGB) || !(dst_desc->flags & AV_PIX_FMT_FLAG_RGB) || src_desc->nb_components < 3 || matrix < 0)
+                return;
+
+            int *inv_table, *table;
+            int src_range, dst_range, brightness, contrast, saturation;
+            if (sws_getColorspaceDetails(ctx, &inv_table, &src_range, &table, &dst_range, &brightness, &contrast, &saturation) < 0)
+                return;
+            sws_setColorspaceDetails(ctx, sws_getCoefficients(matrix), isFullRange(src_format, range) ? 1 : 0, table, dst_range, brightness, contrast, saturation);
+        }
+    } // namespace
+
+    /// Allocate an empty frame, counted by allocationCount()
+    /// @return Frame to free with av_frame_free(), nullptr if out of memory
+    AVFrame *allocFrame()
+    {
+        allocation_count++;
+        return av_frame_alloc();
+    }
+
+    /// Allocate an empty packet, counted by allocationCount()
+    /// @return Packet to free with av_packet_free(), nullptr if out of memory
+    AVPacket *allocPacket()
+    {
+        allocation_count++;
+        return av_packet_alloc();
+    }
+
+    /// Number of frames and packets allocated by the library so far
+    /// @return Count of all allocFrame() and allocPacket() calls, e.g. to verify reads reuse their frames and packets
+    int64_t allocationCount()
+    {
+        return allocation_count;
+    }
+
     /// Constructor that opens the video file immediately
     /// @param filename Path to the video file to open
     VideoCapture::VideoCapture(const char *filename)
@@ -21,19 +181,18 @@ namespace DG
         open(filename, target_width, target_height);
     }
 
+    /// Constructor that opens the video file with the given options
+    /// @param filename Path to the video file to open
+    /// @param options Open-time options (resize, prefetch)
+    VideoCapture::VideoCapture(const char *filename, const VideoCaptureOptions &options)
+    {
+        open(filename, options);
+    }
+
     /// Destructor to clean up resources
     VideoCapture::~VideoCapture()
     {
         close();
-
-        // Free filter graph if exists
-        if (m_filter_graph)
-        {
-            avfilter_graph_free(&m_filter_graph);
-            m_filter_graph = nullptr;
-            m_buffersrc_ctx = nullptr;
-            m_buffersink_ctx = nullptr;
-        }
     }
 
     /// Open a video file for reading with target resize dimensions
@@ -43,18 +202,160 @@ namespace DG
     /// @return True if the video was successfully opened, false otherwise
     bool VideoCapture::open(const char *filename, int target_width, int target_height)
     {
+        VideoCaptureOptions options;
+        options.target_width = target_width;
+        options.target_height = target_height;
+        return open(filename, options);
+    }
+
+    /// Open a video file for reading with the given options
+    /// @param filename Path to the video file to open
+    /// @param options Open-time options (resize, prefetch)
+    /// @return True if the video was successfully opened, false otherwise
+    bool VideoCapture::open(const char *filename, const VideoCaptureOptions &options)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
         // Clean up any existing resources if already opened
         close();
 
-        m_target_width = target_width;
-        m_target_height = target_height;
+        // Mapped files are demuxed like buffers; sources that cannot be mapped (URLs, devices) are read as usual
+        m_filename = filename;
+        if (options.memory_map)
+            m_memory_input = MemoryInput::mapFile(m_filename);
+
+        // A failed open may have set up part of the capture, which must not look opened nor be read from
+        if (openSource(options))
+            return true;
+        close();
+        return false;
+    }
+
+    /// Open a video held in memory, demuxed straight from the buffer without temporary files
+    /// @param data First byte of the media file (container or elementary stream), must stay valid until close()
+    /// @param size Size of the media file in bytes
+    /// @param options Open-time options (resize, prefetch); frame_index is not available, there is no file to keep a sidecar for
+    /// @param owner Object keeping data alive, released by close() (nullptr if the caller manages the lifetime)
+    /// @return True if the video was successfully opened, false otherwise
+    bool VideoCapture::openBuffer(const uint8_t *data, size_t size, const VideoCaptureOptions &options, std::shared_ptr<const void> owner)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        close();
+
+        if (!data || size == 0 || options.frame_index)
+            return false;
+        m_memory_input = std::make_unique<MemoryInput>(data, size, std::move(owner));
+        if (openSource(options))
+            return true;
+        close();
+        return false;
+    }
+
+    /// Open m_filename, or m_memory_input if set, with the given options (call lock held, capture closed)
+    /// @param options Open-time options (resize, prefetch)
+    /// @return True if the video was successfully opened, false otherwise (the caller closes the partly opened capture)
+    bool VideoCapture::openSource(const VideoCaptureOptions &options)
+    {
+        m_options = options;
+        m_target_width = options.target_width;
+        m_target_height = options.target_height;
+
+        // Device frames are handed out as decoded, which rules out resizing and cropping on the CPU
+        if (options.device_output && (options.hw_device.empty() || (m_target_width > 0 && m_target_height > 0) || options.tensor.enabled ||
+                                      options.crop_width > 0 || options.crop_height > 0))
+            return false;
+
+        // Region of interest: both sizes or none, checked against the frame size once the decoder is open
+        if (options.crop_x < 0 || options.crop_y < 0 || options.crop_width < 0 || options.crop_height < 0 ||
+            (options.crop_width > 0) != (options.crop_height > 0))
+            return false;
+
+        // Decoder downscale: explicit factors are for software decoders only, hardware decoders always decode in full
+        if (options.lowres < -1 || (options.lowres > 0 && !options.hw_device.empty()))
+            return false;
+
+        // Output pixel formats that can be produced; device and tensor output define their own format
+        if (!isOutputFormat(options.pixel_format))
+            return false;
+        if (options.pixel_format != AV_PIX_FMT_BGR24 && (options.device_output || options.tensor.enabled))
+            return false;
+
+        // Renditions: image outputs converted on the CPU next to the main output, both sizes or none
+        if (options.renditions.size() > static_cast<size_t>(MAX_RENDITIONS) || (!options.renditions.empty() && options.device_output))
+            return false;
+        for (const RenditionSpec &spec : options.renditions)
+        {
+            if (!isOutputFormat(spec.pixel_format) || spec.width < 0 || spec.height < 0 || (spec.width > 0) != (spec.height > 0))
+                return false;
+        }
+
+        // Temporal subsampling: stride of at least one frame, no negative rate
+        if (options.frame_step < 1 || options.target_fps < 0)
+            return false;
+
+        // Device frames are not converted
+        if (options.convert_threads < 0 || (options.convert_threads > 0 && options.device_output))
+            return false;
+
+        // Decoder threading: known models only
+        if ((options.thread_type & ~(FF_THREAD_FRAME | FF_THREAD_SLICE)) != 0)
+            return false;
+
+        // Threads created by the capture inherit the CPU set, so decoding and the buffers it first touches stay on one NUMA node
+        if (!resolveThreadAffinity(options))
+            return false;
+
+        // Reconnect backoff
+        if (options.reconnect_delay_ms < 0)
+            return false;
+
+        // Probing limits, 0 keeps the FFmpeg defaults
+        if (options.probesize < 0 || options.analyze_duration_ms < 0)
+            return false;
+
+        // Normalization divides by stddev
+        if (options.tensor.enabled && options.tensor.dtype != TensorDataType::UInt8)
+        {
+            for (float stddev : options.tensor.stddev)
+                if (stddev == 0.0f)
+                    return false;
+        }
+
+        // Latest-frame reads pick the newest of the frames decoded ahead, and pipelined conversion runs in the prefetch thread
+        if (options.latest_frame || options.convert_threads > 0)
+            m_options.prefetch = std::max(options.prefetch, 2);
+
+        // Load the frame index sidecar of a previous open, if it still matches the file
+        if (options.frame_index)
+        {
+            m_index_path = options.index_path.empty() ? m_filename + ".dgidx" : options.index_path;
+            m_index.load(m_index_path, m_filename);
+        }
+
+        // Blocking network I/O is interrupted by a deadline, so open() and reads cannot hang forever; reconnecting needs stalls detected
+        m_io_timeout_ms = options.timeout_ms > 0 ? options.timeout_ms : (options.live || options.reconnect_attempts != 0 ? 5000 : 0);
 
         // Open input stream and read header
-        if (avformat_open_input(&m_fmt_ctx, filename, nullptr, nullptr) < 0)
+        if (!openInput(&m_fmt_ctx))
             return false;
 
         // Get stream info (required for some formats/codecs to initialize properly)
-        if (avformat_find_stream_info(m_fmt_ctx, nullptr) < 0)
+        // An index carries what probing would find out (decoded pixel format), so probing is skipped if the header agrees with it
+        const FrameIndex::StreamInfo &indexed = m_index.streamInfo();
+        AVCodecParameters *indexed_par = !m_index.empty() && indexed.stream_index >= 0 && indexed.stream_index < static_cast<int>(m_fmt_ctx->nb_streams)
+                                             ? m_fmt_ctx->streams[indexed.stream_index]->codecpar
+                                             : nullptr;
+        // Fast open trusts headers carrying codec parameters (MP4, MKV); the pixel format then comes with the first frame
+        bool probe = true;
+        if (indexed_par && indexed_par->codec_type == AVMEDIA_TYPE_VIDEO &&
+            indexed_par->width == indexed.width && indexed_par->height == indexed.height)
+        {
+            if (indexed_par->format < 0)
+                indexed_par->format = indexed.pix_fmt;
+            probe = false;
+        }
+        else
+            probe = needsStreamInfo(m_fmt_ctx);
+        if (probe && (armIoDeadline(), avformat_find_stream_info(m_fmt_ctx, nullptr) < 0))
             return false;
 
         // Find best video stream
@@ -74,44 +375,210 @@ namespace DG
             return false;
 
         // Enable multi-threaded decoding (0 = auto-detect CPU cores)
-        m_codec_ctx->thread_count = 0;
-        m_codec_ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+        // Frame threading delays output by one frame per thread, live sources only use slice threading and low-delay decoding
+        m_codec_ctx->thread_count = std::max(options.decoder_threads, 0);
+        m_codec_ctx->thread_type = options.thread_type != 0 ? options.thread_type : options.live ? FF_THREAD_SLICE : FF_THREAD_FRAME | FF_THREAD_SLICE;
+        if (options.live)
+            m_codec_ctx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+
+        // Attach hardware device if requested; decoding then runs on the GPU and CPU threads only add surface pressure
+        if (!options.hw_device.empty())
+        {
+            if (!initHwDecoder(decoder, options.hw_device))
+                return false;
+            m_codec_ctx->thread_count = 1;
 
-        // Initialize codec context to use selected codec
-        if (avcodec_open2(m_codec_ctx, decoder, nullptr) < 0)
-            return false;
+            // Device frames held by the prefetch ring and the caller must not starve the decoder surface pool
+            if (options.device_output)
+                m_codec_ctx->extra_hw_frames = m_options.prefetch + 4;
+        }
 
-        // Store video properties for potential user retrieval
+        // Decoder-level frame dropping for low-rate sampling (after the parameters, which reset the context)
+        m_codec_ctx->skip_frame = options.skip_frame;
+
+        // Store video properties for potential user retrieval (source size, crop coordinates refer to it)
         m_width = m_codec_ctx->width;
         m_height = m_codec_ctx->height;
+
+        // Region of interest in source pixels, the whole frame without crop
+        const int crop_width = options.crop_width > 0 ? options.crop_width : m_width - options.crop_x;
+        const int crop_height = options.crop_height > 0 ? options.crop_height : m_height - options.crop_y;
+        if (crop_width <= 0 || crop_height <= 0 || options.crop_x + crop_width > m_width || options.crop_y + crop_height > m_height)
+            return false;
+
+        // Decoder-side downscale (skipped DCT coefficients): decode and scale cost then follow the output size
+        // Automatic choice: the largest factor whose decoded region still covers the letterbox interior, so nothing is upscaled;
+        // renditions of the whole frame must stay covered too
+        int lowres = options.lowres;
+        if (lowres < 0)
+        {
+            lowres = 0;
+            if (m_target_width > 0 && m_target_height > 0 && options.hw_device.empty())
+            {
+                const auto covered = [&](int shift)
+                {
+                    if (!coversOutput(crop_width >> shift, crop_height >> shift, m_target_width, m_target_height, true))
+                        return false;
+                    for (const RenditionSpec &spec : options.renditions)
+                    {
+                        if (spec.width <= 0 || !coversOutput(m_width >> shift, m_height >> shift, spec.width, spec.height, spec.letterbox))
+                            return false;
+                    }
+                    return true;
+                };
+                while (lowres < decoder->max_lowres && covered(lowres + 1))
+                    lowres++;
+            }
+        }
+        m_codec_ctx->lowres = std::min(lowres, static_cast<int>(decoder->max_lowres));
+
+        // Initialize codec context to use selected codec; its threads start here and inherit the affinity of this scope
+        {
+            ScopedThreadAffinity pin(m_thread_affinity);
+            if (avcodec_open2(m_codec_ctx, decoder, nullptr) < 0)
+                return false;
+        }
         m_src_pix_fmt = m_codec_ctx->pix_fmt;
+        m_lowres = m_codec_ctx->lowres;
+
+        // Region of interest converted from each decoded frame, in decoded pixels
+        m_crop_x = options.crop_x >> m_lowres;
+        m_crop_y = options.crop_y >> m_lowres;
+        m_crop_width = std::min(AV_CEIL_RSHIFT(crop_width, m_lowres), AV_CEIL_RSHIFT(m_width, m_lowres) - m_crop_x);
+        m_crop_height = std::min(AV_CEIL_RSHIFT(crop_height, m_lowres), AV_CEIL_RSHIFT(m_height, m_lowres) - m_crop_y);
+
+        // Sampling rate as a rational, so sampling instants land exactly on frame timestamps for integer rate ratios
+        if (options.target_fps > 0)
+            m_sample_rate = av_d2q(options.target_fps, 1 << 16);
+
+        // Frame index must describe this stream; otherwise index the first sequential pass of a regular file
+        if (!m_index.empty())
+        {
+            const FrameIndex::StreamInfo info = indexStreamInfo();
+            if (info.stream_index != indexed.stream_index || info.width != indexed.width || info.height != indexed.height ||
+                info.time_base_num != indexed.time_base_num || info.time_base_den != indexed.time_base_den)
+                m_index.clear();
+        }
+        std::error_code ec;
+        if (options.frame_index && m_index.empty() && std::filesystem::is_regular_file(m_filename, ec))
+            m_index.beginRecording(indexStreamInfo());
+
+        // Allocate internal decoded YUV frame and the packet every demuxer read reuses (no buffers yet)
+        m_yuv_frame = allocFrame();
+        m_packet = allocPacket();
+        if (!m_yuv_frame || !m_packet)
+            return false;
 
-        // Allocate internal decoded YUV frame (does not allocate buffers yet)
-        m_yuv_frame = av_frame_alloc();
-        if (!m_yuv_frame)
+        // Allocate staging frame and caller frame shell for reads into caller memory (does not allocate buffers)
+        m_staging_frame = allocFrame();
+        m_caller_frame = allocFrame();
+        if (!m_staging_frame || !m_caller_frame)
             return false;
 
-        // Swscale context for YUV -> BGR24 conversion
-        m_sws_ctx = sws_getContext(
-            m_width, m_height, m_src_pix_fmt,
-            m_width, m_height, AV_PIX_FMT_BGR24,
-            SWS_BILINEAR,
-            nullptr, nullptr, nullptr);
-        if (!m_sws_ctx)
+        // Letterbox geometry: scale to fit the target size keeping aspect ratio, centered in the output frame
+        // Subsampled output formats need an even frame size (OpenCV NV12 / I420 layout) and get a chroma-aligned interior
+        const AVPixFmtDescriptor *out_desc = av_pix_fmt_desc_get(options.pixel_format);
+        if (outputWidth() % (1 << out_desc->log2_chroma_w) || outputHeight() % (1 << out_desc->log2_chroma_h))
             return false;
+        fitLetterbox(m_crop_width, m_crop_height, outputWidth(), outputHeight(), options.pixel_format,
+                     m_scaled_width, m_scaled_height, m_pad_x, m_pad_y);
 
-        // Choose implementation based on resize needed
-        if (m_target_width > 0 && m_target_height > 0)
+        // Renditions of the whole decoded frame, each with its own conversion (created with the first frame) and buffer pool
+        const int decoded_width = AV_CEIL_RSHIFT(m_width, m_lowres);
+        const int decoded_height = AV_CEIL_RSHIFT(m_height, m_lowres);
+        for (const RenditionSpec &spec : options.renditions)
         {
-            m_readFrameImpl = &VideoCapture::readFrameFiltered;
+            Rendition rendition;
+            rendition.spec = spec;
+            rendition.width = spec.width > 0 ? spec.width : decoded_width;
+            rendition.height = spec.height > 0 ? spec.height : decoded_height;
+            const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(spec.pixel_format);
+            if (rendition.width % (1 << desc->log2_chroma_w) || rendition.height % (1 << desc->log2_chroma_h))
+                return false;
+            rendition.scaled_width = rendition.width;
+            rendition.scaled_height = rendition.height;
+            if (spec.letterbox)
+                fitLetterbox(decoded_width, decoded_height, rendition.width, rendition.height, spec.pixel_format,
+                             rendition.scaled_width, rendition.scaled_height, rendition.pad_x, rendition.pad_y);
+
+            const int size = av_image_get_buffer_size(spec.pixel_format, rendition.width, rendition.height, 32);
+            rendition.pool = size > 0 ? av_buffer_pool_init(static_cast<size_t>(size), nullptr) : nullptr;
+            // Kept before the check, so the close() of a failed open frees the renditions set up so far
+            m_renditions.push_back(rendition);
+            if (!rendition.pool)
+                return false;
+        }
+        if (!m_renditions.empty())
+        {
+            m_rendition_set_pool = av_buffer_pool_init2(sizeof(RenditionSet), nullptr, &allocRenditionSet, nullptr);
+            if (!m_rendition_set_pool)
+                return false;
+        }
 
-            // Initialize filter graph for resizing and format conversion
-            if (!initFilterGraph())
-            {
-                // Filter graph init failed, clean up and return false
-                close();
+        // Tensor output: swscale writes planar RGB into an internal frame, the tensor kernels then normalize it into the output
+        m_convert_pix_fmt = options.pixel_format;
+        if (options.tensor.enabled)
+        {
+            m_convert_pix_fmt = AV_PIX_FMT_GBRP;
+            m_tensor_converter = TensorConverter(options.tensor);
+
+            m_tensor_frame = allocFrame();
+            if (!m_tensor_frame)
+                return false;
+            m_tensor_frame->format = AV_PIX_FMT_GBRP;
+            m_tensor_frame->width = outputWidth();
+            m_tensor_frame->height = outputHeight();
+            if (av_frame_get_buffer(m_tensor_frame, 32) < 0)
+                return false;
+
+            // The frame never leaves this object, so its letterbox border is cleared once here
+            for (int p = 0; p < 3; p++)
+                std::memset(m_tensor_frame->data[p], 0, static_cast<size_t>(m_tensor_frame->linesize[p]) * outputHeight());
+        }
+
+        // Unscaled YUV -> BGR24 / RGB24 of the common decoder formats runs on specialized kernels, selected here for the
+        // decoded format and colorimetry (re-selected if frames differ); slice-threaded conversion stays with swscale
+        m_direct_color = !options.tensor.enabled && options.convert_threads <= 1 && m_scaled_width == m_crop_width && m_scaled_height == m_crop_height;
+
+        // Swscale context for YUV -> output format (or GBRP) conversion, resizing straight into the letterbox interior
+        // Not used for frames decoded in the output format and size, these are passed through, or converted by the kernels
+        // For hardware decoding the downloaded software format is only known with the first frame, so it is created lazily,
+        // as it is when fast open left the decoded format unknown
+        if (m_hw_device_ctx)
+        {
+            m_sw_frame = allocFrame();
+            if (!m_sw_frame)
+                return false;
+        }
+        else if (m_src_pix_fmt != AV_PIX_FMT_NONE)
+        {
+            if (m_direct_color)
+                m_color_converter.init(m_src_pix_fmt, m_convert_pix_fmt, m_codec_ctx->colorspace, m_codec_ctx->color_range);
+            if (!m_color_converter.valid() && !updateSwsContext(m_src_pix_fmt, m_codec_ctx->colorspace, m_codec_ctx->color_range))
+                return false;
+        }
+
+        // Frame shells describing the letterbox interior and the cropped source for slice-threaded scaling
+        if (options.convert_threads > 1)
+        {
+            m_sws_view_frame = allocFrame();
+            m_sws_src_view_frame = allocFrame();
+            if (!m_sws_view_frame || !m_sws_src_view_frame)
                 return false;
-            }
+        }
+
+        // Pool of output buffers, so steady-state reads reuse already faulted-in memory
+        // Tensor rows are packed, making every pooled buffer one contiguous tensor
+        m_output_linesize = options.tensor.enabled ? outputRowBytes() : FFALIGN(outputRowBytes(), 32);
+        m_frame_pool = av_buffer_pool_init(static_cast<size_t>(m_output_linesize) * outputRows(), nullptr);
+        if (!m_frame_pool)
+            return false;
+
+        // Either decode on the caller's thread or hand decoding over to the prefetch thread
+        if (m_options.prefetch > 0)
+        {
+            m_readFrameImpl = &VideoCapture::readFramePrefetched;
+            startPrefetch(m_options.prefetch);
         }
         else
         {
@@ -125,6 +592,13 @@ namespace DG
     /// Close the video file and clean up all resources
     void VideoCapture::close()
     {
+        // A read blocked on network input in another thread holds the lock, interrupt it first
+        interrupt();
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+
+        // Stop prefetch thread before releasing anything it may be using
+        stopPrefetch();
+
         // Flush and clean up decoder context first
         if (m_codec_ctx)
         {
@@ -139,6 +613,14 @@ namespace DG
             sws_freeContext(m_sws_ctx);
             m_sws_ctx = nullptr;
         }
+        m_sws_src_pix_fmt = AV_PIX_FMT_NONE;
+        m_sws_colorspace = AVCOL_SPC_UNSPECIFIED;
+        m_sws_color_range = AVCOL_RANGE_UNSPECIFIED;
+        m_color_converter = ColorConverter();
+        m_direct_color = false;
+        av_frame_free(&m_sws_view_frame);
+        av_frame_free(&m_sws_src_view_frame);
+        freeRenditions();
 
         // Close input format context
         if (m_fmt_ctx)
@@ -147,6 +629,18 @@ namespace DG
             m_fmt_ctx = nullptr;
         }
 
+        // Custom input is not freed with the format context; the buffer (or its owner) is released with it
+        MemoryInput::freeIOContext(&m_memory_io);
+        m_memory_input.reset();
+
+        // Release output buffer pool (actually freed once frames still referenced by the caller are released)
+        if (m_frame_pool)
+        {
+            av_buffer_pool_uninit(&m_frame_pool);
+            m_frame_pool = nullptr;
+        }
+        m_output_linesize = 0;
+
         // Free internal YUV frame
         if (m_yuv_frame)
         {
@@ -154,31 +648,193 @@ namespace DG
             av_frame_free(&m_yuv_frame);
             m_yuv_frame = nullptr;
         }
+        av_packet_free(&m_packet);
+
+        // Free staging frame and caller frame shell (the shell never owns the caller's memory)
+        if (m_staging_frame)
+        {
+            av_frame_free(&m_staging_frame);
+            m_staging_frame = nullptr;
+        }
+        if (m_caller_frame)
+        {
+            av_frame_free(&m_caller_frame);
+            m_caller_frame = nullptr;
+        }
 
-        // Free filter graph if exists
-        if (m_filter_graph)
+        // Free tensor planar frame
+        if (m_tensor_frame)
         {
-            avfilter_graph_free(&m_filter_graph);
-            m_filter_graph = nullptr;
-            m_buffersrc_ctx = nullptr;
-            m_buffersink_ctx = nullptr;
+            av_frame_free(&m_tensor_frame);
+            m_tensor_frame = nullptr;
         }
+        m_tensor_converter = TensorConverter();
+
+        // Free downloaded frame and hardware device context
+        if (m_sw_frame)
+        {
+            av_frame_free(&m_sw_frame);
+            m_sw_frame = nullptr;
+        }
+        if (m_hw_device_ctx)
+        {
+            av_buffer_unref(&m_hw_device_ctx);
+            m_hw_device_ctx = nullptr;
+        }
+        m_hw_pix_fmt = AV_PIX_FMT_NONE;
+
+        // Drop frame index (the sidecar stays for the next open)
+        m_index.clear();
+        m_filename.clear();
+        m_index_path.clear();
 
         // Reset properties
+        m_io_timeout_ms = 0;
+        m_reconnect_count = 0;
+        m_stats.reset();
+        m_options = VideoCaptureOptions();
         m_video_stream_index = -1;
         m_width = m_height = 0;
         m_src_pix_fmt = AV_PIX_FMT_NONE;
+        m_convert_pix_fmt = AV_PIX_FMT_BGR24;
         m_flush_pending = false;
+        m_seek_frame_pending = false;
+        m_step_phase = 0;
+        m_sample_rate = AVRational{0, 1};
+        m_sample_origin = AV_NOPTS_VALUE;
+        m_sample_count = 0;
         m_frame_count = 0;
         m_last_pts = AV_NOPTS_VALUE;
+        m_position_unread = false;
         m_target_width = 0;
         m_target_height = 0;
+        m_scaled_width = m_scaled_height = 0;
+        m_pad_x = m_pad_y = 0;
+        m_crop_x = m_crop_y = 0;
+        m_crop_width = m_crop_height = 0;
+        m_lowres = 0;
+        m_thread_affinity.clear();
+        m_io_abort = false;
+    }
+
+    /// Make blocking input of a read in another thread fail (network reads, reconnect backoff) without taking the call lock
+    /// @note Reads keep failing until close(), which clears the request; used ahead of a close() that would wait for the read
+    void VideoCapture::interrupt()
+    {
+        m_io_abort = true;
+    }
+
+    /// Switch to the next file of a playlist of segments (HLS chunks, DVR segment files), keeping decoder, decoder threads,
+    /// swscale context and output buffers when its video stream has the same codec parameters
+    /// @param filename Path or URL of the next segment
+    /// @return True if the segment is open for reading, false if it cannot be opened (the capture is closed then)
+    /// @note Segments with different parameters are opened from scratch with the same options; either way reading starts
+    ///       at the first frame of the new segment and positions count from it
+    bool VideoCapture::reopen(const char *filename)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        if (!isOpened())
+            return false;
+        const VideoCaptureOptions options = m_options;
+        const std::string path = filename;
+
+        // Frames decoded ahead belong to the old segment
+        stopPrefetch();
+
+        // The new input is opened next to the current one, which is only replaced once the streams compare equal
+        AVFormatContext *old_fmt_ctx = m_fmt_ctx;
+        AVIOContext *old_memory_io = m_memory_io;
+        std::unique_ptr<MemoryInput> old_memory_input = std::move(m_memory_input);
+        m_memory_io = nullptr;
+        m_filename = path;
+        if (options.memory_map)
+            m_memory_input = MemoryInput::mapFile(m_filename);
+
+        AVFormatContext *fmt_ctx = nullptr;
+        int stream_index = -1;
+        if (openInput(&fmt_ctx) && (!needsStreamInfo(fmt_ctx) || (armIoDeadline(), avformat_find_stream_info(fmt_ctx, nullptr) >= 0)))
+            stream_index = av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (stream_index < 0 || !sameCodecParameters(old_fmt_ctx->streams[m_video_stream_index]->codecpar, fmt_ctx->streams[stream_index]->codecpar))
+        {
+            // Put the old input back for close(), then open the segment like any other file
+            if (fmt_ctx)
+                avformat_close_input(&fmt_ctx);
+            MemoryInput::freeIOContext(&m_memory_io);
+            m_memory_input = std::move(old_memory_input);
+            m_memory_io = old_memory_io;
+            return open(path.c_str(), options);
+        }
+
+        avformat_close_input(&old_fmt_ctx);
+        MemoryInput::freeIOContext(&old_memory_io);
+        old_memory_input.reset();
+        m_fmt_ctx = fmt_ctx;
+        m_video_stream_index = stream_index;
+
+        // Only the decoder buffers are flushed, its threads and the conversion state stay
+        avcodec_flush_buffers(m_codec_ctx);
+        m_flush_pending = false;
+        m_seek_frame_pending = false;
+        m_step_phase = 0;
+        m_sample_origin = AV_NOPTS_VALUE;
+        m_sample_count = 0;
+        m_frame_count = 0;
+        m_last_pts = AV_NOPTS_VALUE;
+        m_position_unread = false;
+        m_reconnect_count = 0;
+        m_stats.reset();
+
+        // Frame index of the new segment: its sidecar if valid, otherwise indexed by the first sequential pass
+        m_index.clear();
+        if (options.frame_index)
+        {
+            m_index_path = options.index_path.empty() ? m_filename + ".dgidx" : options.index_path;
+            if (m_index.load(m_index_path, m_filename))
+            {
+                const FrameIndex::StreamInfo indexed = m_index.streamInfo();
+                const FrameIndex::StreamInfo info = indexStreamInfo();
+                if (info.stream_index != indexed.stream_index || info.width != indexed.width || info.height != indexed.height ||
+                    info.time_base_num != indexed.time_base_num || info.time_base_den != indexed.time_base_den)
+                    m_index.clear();
+            }
+            std::error_code ec;
+            if (m_index.empty() && std::filesystem::is_regular_file(m_filename, ec))
+                m_index.beginRecording(indexStreamInfo());
+        }
+
+        if (options.prefetch > 0)
+            startPrefetch(m_options.prefetch);
+        return true;
+    }
+
+    /// Size in bytes of one packed output row
+    /// @return Row size of the first image plane (e.g. outputWidth() * 3 for BGR24, outputWidth() for GRAY8/NV12/YUV420P),
+    ///         or the tensor row size (one channel for NCHW, all channels for NHWC)
+    int VideoCapture::outputRowBytes() const
+    {
+        const TensorFormat &tensor = m_options.tensor;
+        if (!tensor.enabled)
+            return av_image_get_linesize(m_options.pixel_format, outputWidth(), 0);
+        const int channels = tensor.layout == TensorLayout::NHWC ? 3 : 1;
+        return outputWidth() * channels * static_cast<int>(tensorElementSize(tensor.dtype));
+    }
+
+    /// Number of output rows per frame
+    /// @return outputHeight(), 3/2 * outputHeight() for NV12/YUV420P (chroma rows follow luma rows),
+    ///         or 3 * outputHeight() for NCHW tensors (channel planes stacked)
+    int VideoCapture::outputRows() const
+    {
+        const TensorFormat &tensor = m_options.tensor;
+        if (tensor.enabled)
+            return tensor.layout == TensorLayout::NCHW ? 3 * outputHeight() : outputHeight();
+        return av_pix_fmt_count_planes(m_options.pixel_format) > 1 ? outputHeight() * 3 / 2 : outputHeight();
     }
 
     /// Check if the video file is currently opened
     /// @return True if the video is opened, false otherwise
     bool VideoCapture::isOpened() const
     {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
         return m_fmt_ctx && m_codec_ctx;
     }
 
@@ -187,6 +843,7 @@ namespace DG
     /// @return Property value, or -1 if property is not supported/available
     double VideoCapture::get(int propId) const
     {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
         if (!isOpened())
             return -1;
 
@@ -210,6 +867,10 @@ namespace DG
 
         case cv::CAP_PROP_FRAME_COUNT:
         {
+            // Exact when indexed
+            if (!m_index.empty())
+                return static_cast<double>(m_index.frameCount());
+
             AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
             if (stream->nb_frames > 0)
                 return static_cast<double>(stream->nb_frames);
@@ -230,9 +891,7 @@ namespace DG
         {
             if (m_last_pts == AV_NOPTS_VALUE)
                 return 0;
-            AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
-            double time_sec = m_last_pts * av_q2d(stream->time_base);
-            return time_sec * 1000.0; // Convert to milliseconds
+            return ptsToMsec(m_last_pts);
         }
 
         case cv::CAP_PROP_POS_AVI_RATIO:
@@ -246,364 +905,1564 @@ namespace DG
         case cv::CAP_PROP_FOURCC:
             return static_cast<double>(m_codec_ctx->codec_tag);
 
-        default:
-            return -1;
-        }
-    }
+        case CAP_PROP_RECONNECT_COUNT:
+            return static_cast<double>(m_reconnect_count);
 
-    /// Call readFrameDirect or readFrameFiltered based on if resizing+padding is enabled
-    /// @param dst Pointer to an AVFrame for output (must be pre-allocated and configured by caller)
-    /// @return true on success, false on EOS or error
-    bool VideoCapture::readFrame(AVFrame *dst)
-    {
-        // Single indirection, no branch
-        return (this->*m_readFrameImpl)(dst);
-    }
+        // Colorimetry the conversions to BGR/RGB follow
+        case CAP_PROP_COLORSPACE:
+            return static_cast<double>(m_codec_ctx->colorspace);
 
-    /// Read the next video frame, convert it to BGR24 format, and store it in the provided AVFrame
-    /// @param dst_frame Pointer to an AVFrame that is already allocated and configured for BGR24 output
-    /// @note dst_frame must be:
-    /// @note   - allocated with av_frame_alloc()
-    /// @note   - format = AV_PIX_FMT_BGR24
-    /// @note   - av_frame_get_buffer(dst_frame, 32) already called
-    /// @return true on success (dst_frame filled with BGR24), false on EOS or error.
-    bool VideoCapture::readFrameDirect(AVFrame *dst_frame)
-    {
-        // Check if video is opened and dst_frame frame is valid
-        if (!isOpened() || !dst_frame)
-            return false;
+        case CAP_PROP_COLOR_RANGE:
+            return static_cast<double>(isFullRange(m_codec_ctx->pix_fmt, m_codec_ctx->color_range) ? AVCOL_RANGE_JPEG : m_codec_ctx->color_range);
 
-        // Allocate packet for reading encoded data
-        AVPacket *pkt = av_packet_alloc();
-        if (!pkt)
-            return false;
+        // Per-stage statistics, -1 when compiled out
+        case CAP_PROP_PACKETS_READ:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.packets_read.load(std::memory_order_relaxed)) : -1;
 
-        bool result = false;
+        case CAP_PROP_BYTES_READ:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.bytes_read.load(std::memory_order_relaxed)) : -1;
 
-        // Loop until we get a frame or reach end of file
-        for (;;)
-        {
-            // Read next packet from the video stream
-            int ret = av_read_frame(m_fmt_ctx, pkt);
+        case CAP_PROP_FRAMES_DECODED:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.decode.count()) : -1;
 
-            // If we hit end of file, flush the decoder to get any remaining frames
-            if (ret < 0)
-            {
-                if (!m_flush_pending)
-                {
-                    m_flush_pending = true;
+        case CAP_PROP_FRAMES_DROPPED:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.frames_dropped.load(std::memory_order_relaxed)) : -1;
 
-                    // Send packet to decoder with null data to signal end of stream
-                    avcodec_send_packet(m_codec_ctx, nullptr);
-                }
+        case CAP_PROP_FRAMES_CONVERTED:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.convert.count()) : -1;
 
-                // Try to receive any remaining frames from decoder after flushing
-                result = receiveAndConvert(dst_frame);
-                break;
-            }
+        case CAP_PROP_DEMUX_MSEC:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.demux_ns.load(std::memory_order_relaxed)) / 1e6 : -1;
 
-            // Filter packets by stream (only process video stream, discard all others)
-            if (pkt->stream_index == m_video_stream_index)
-            {
-                // Send packet to decoder
-                ret = avcodec_send_packet(m_codec_ctx, pkt);
+        case CAP_PROP_DECODE_MSEC:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.decode.totalNs()) / 1e6 : -1;
 
-                // Free packet's internal buffers (packet is reused in the loop)
-                av_packet_unref(pkt);
-                if (ret < 0)
-                {
-                    result = false;
-                    break;
-                }
+        case CAP_PROP_CONVERT_MSEC:
+            return CaptureStats::enabled ? static_cast<double>(m_stats.convert.totalNs()) / 1e6 : -1;
 
-                // Check if yuv->brg converter has a complete and ready frame to output
-                if (receiveAndConvert(dst_frame))
-                {
-                    result = true;
-                    break;
-                }
-                // else: need more packets, continue
-            }
-            // Packet does not belong to video stream, ignore it and read next
-            else
-            {
-                // Free packet's internal buffers since we're not using it
-                av_packet_unref(pkt);
-            }
+        default:
+            return -1;
         }
-
-        // Free packet memory
-        av_packet_free(&pkt);
-
-        return result;
     }
 
-    /// Internal helper to receive a decoded frame and convert it to BGR24 format
-    /// @param dst_frame Pointer to an AVFrame that is already allocated and configured for BGR24 output
-    /// @return true if a frame was received and converted, false if no frame is available (EAGAIN) or end of stream (EOF)
-    bool VideoCapture::receiveAndConvert(AVFrame *dst_frame)
+    /// Set video capture property value (OpenCV-compatible), seeking for position properties
+    /// @param propId Property identifier from cv::VideoCaptureProperties enum (CAP_PROP_POS_FRAMES, CAP_PROP_POS_MSEC, CAP_PROP_POS_AVI_RATIO)
+    /// @param value New property value
+    /// @return true if the property was set, false if it is not supported or seeking failed
+    /// @note The next frame read is the exact target frame: decoding restarts at the preceding keyframe and frames before the target are discarded unconverted
+    /// @note With a frame index the keyframe and exact frame timestamp are looked up instead of derived from the frame rate
+    bool VideoCapture::set(int propId, double value)
     {
-        // Poll decoder for a decoded frame
-        int ret = avcodec_receive_frame(m_codec_ctx, m_yuv_frame);
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        if (!isOpened() || value < 0)
+            return false;
+
+        AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
+        const AVRational frame_rate = frameRate();
+        const int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
 
-        // If we got a frame, convert it to BGR24 and return true
-        if (ret == 0)
+        // Timestamps computed from frame indices or milliseconds may be off by rounding, accept frames within half a frame
+        const int64_t tolerance = frame_rate.num > 0 ? av_rescale_q(1, av_inv_q(frame_rate), stream->time_base) / 2 : 0;
+
+        switch (propId)
         {
-            // Update position tracking
-            m_frame_count++;
-            m_last_pts = m_yuv_frame->pts;
-
-            // Convert YUV -> BGR24 into caller's buffer (no extra copy afterward)
-            sws_scale(
-                m_sws_ctx,
-                m_yuv_frame->data,
-                m_yuv_frame->linesize,
-                0,
-                m_height,
-                dst_frame->data,
-                dst_frame->linesize);
-            // Copy basic timing info if you care about PTS, etc.
-            dst_frame->pts = m_yuv_frame->pts;
-            return true;
+        case cv::CAP_PROP_POS_FRAMES:
+        {
+            const int64_t frame_index = std::llround(value);
+            if (!m_index.empty())
+            {
+                FrameIndex::SeekPoint point;
+                return m_index.seekPoint(frame_index, point) && seek(point, frame_index, 0);
+            }
+            if (frame_rate.num <= 0)
+                return false;
+            const int64_t target_pts = start_time + av_rescale_q(frame_index, av_inv_q(frame_rate), stream->time_base);
+            return seek({target_pts, target_pts, -1, 0}, frame_index, tolerance);
+        }
+
+        case cv::CAP_PROP_POS_MSEC:
+        {
+            // Same absolute time base as get(CAP_PROP_POS_MSEC)
+            const int64_t target_pts = av_rescale_q(std::llround(value * 1000.0), AVRational{1, AV_TIME_BASE}, stream->time_base);
+            if (!m_index.empty())
+                return set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(m_index.frameAtPts(target_pts - tolerance)));
+            return seek({target_pts, target_pts, -1, 0}, -1, tolerance);
+        }
+
+        case cv::CAP_PROP_POS_AVI_RATIO:
+        {
+            const double total = get(cv::CAP_PROP_FRAME_COUNT);
+            if (total <= 0 || value > 1)
+                return false;
+            return set(cv::CAP_PROP_POS_FRAMES, std::floor(value * total));
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    /// Seek so that the next read returns the target frame
+    /// @param point Target frame timestamp and the keyframe to seek to (key_pos < 0 if unknown)
+    /// @param frame_index Index of the target frame, or -1 to derive it from the timestamp of the frame found
+    /// @param tolerance Frames up to this many time base units before point.frame_pts count as the target
+    /// @return true if positioned on the target frame, false if the stream cannot seek or the target is past the end
+    /// @note A target past the end decodes to the end of the stream, the previous position is then restored (see restorePosition())
+    bool VideoCapture::seek(const FrameIndex::SeekPoint &point, int64_t frame_index, int64_t tolerance)
+    {
+        // Decoder state is about to be reset, frames decoded ahead are no longer valid
+        stopPrefetch();
+
+        // Position jumps, so this is no longer one sequential pass to index
+        m_index.cancelRecording();
+
+        const int64_t frame_count = m_frame_count;
+        const int64_t last_pts = m_last_pts;
+        const bool unread = m_position_unread;
+        bool moved = false;
+        const bool found = seekTo(point, frame_index, tolerance, moved);
+        if (!found && moved)
+            restorePosition(frame_count, last_pts, unread);
+
+        // Prefetch resumes from the new position
+        if (m_options.prefetch > 0)
+            startPrefetch(m_options.prefetch);
+
+        return found;
+    }
+
+    /// Jump to the keyframe at or before a target and decode-and-discard up to the target frame (prefetch stopped)
+    /// @param point Target frame timestamp and the keyframe to seek to (key_pos < 0 if unknown)
+    /// @param frame_index Index of the target frame, or -1 to derive it from the timestamp of the frame found
+    /// @param tolerance Frames up to this many time base units before point.frame_pts count as the target
+    /// @param moved Receives true if the demuxer was moved, i.e. the read position is lost when the target is not found
+    /// @return true if positioned on the target frame
+    bool VideoCapture::seekTo(const FrameIndex::SeekPoint &point, int64_t frame_index, int64_t tolerance, bool &moved)
+    {
+        // Jump to the keyframe at or before the target; byte offsets help demuxers without a seek index
+        bool seeked = av_seek_frame(m_fmt_ctx, m_video_stream_index, point.key_pts, AVSEEK_FLAG_BACKWARD) >= 0;
+        if (!seeked && point.key_pos >= 0 && !(m_fmt_ctx->iformat->flags & AVFMT_NO_BYTE_SEEK))
+            seeked = av_seek_frame(m_fmt_ctx, m_video_stream_index, point.key_pos, AVSEEK_FLAG_BYTE) >= 0;
+        moved = seeked;
+        if (!seeked)
+            return false;
+
+        avcodec_flush_buffers(m_codec_ctx);
+        m_flush_pending = false;
+        m_seek_frame_pending = false;
+
+        // Decode and discard frames before the target, without download, conversion or output buffers
+        while (decodeFrame())
+        {
+            const int64_t pts = m_yuv_frame->pts != AV_NOPTS_VALUE ? m_yuv_frame->pts : m_yuv_frame->best_effort_timestamp;
+            if (pts == AV_NOPTS_VALUE || pts + tolerance >= point.frame_pts)
+            {
+                // Keep the target frame for the next read
+                m_seek_frame_pending = true;
+                m_position_unread = true;
+                m_last_pts = pts;
+                // Frames dropped by skip_frame may put the first decoded frame past the target
+                if (frame_index < 0 || (pts != AV_NOPTS_VALUE && pts > point.frame_pts + tolerance))
+                    frame_index = frameNumberAt(pts, frame_index);
+                m_frame_count = frame_index;
+
+                // Sampling restarts at the target frame
+                m_step_phase = 0;
+                m_sample_origin = AV_NOPTS_VALUE;
+                return true;
+            }
         }
-        // EAGAIN or EOF: no frame right now
         return false;
     }
 
-    /// Read the next video frame and process it through the filter graph
-    /// @param dst_frame Pointer to an AVFrame for BGR24 output
+    /// Return to a read position the demuxer was moved away from (failed seek, index scan), by the timestamp of its frame (prefetch stopped)
+    /// @param frame_count m_frame_count of the position
+    /// @param last_pts m_last_pts of the position
+    /// @param unread m_position_unread of the position: the frame at last_pts is the next one to read, not the last one read
+    /// @return true if reading continues at the position, false if it cannot be reached (the capture is then at the end of the stream,
+    ///         and positions report it there)
+    bool VideoCapture::restorePosition(int64_t frame_count, int64_t last_pts, bool unread)
+    {
+        AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
+        const int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        const int step_phase = m_step_phase;
+        const int64_t sample_origin = m_sample_origin;
+        const int64_t sample_count = m_sample_count;
+
+        // The frame after the last one read, the first one if none was read
+        bool restored = false;
+        if (last_pts != AV_NOPTS_VALUE || frame_count == 0)
+        {
+            const int64_t pts = last_pts == AV_NOPTS_VALUE ? start_time : unread ? last_pts : last_pts + 1;
+            bool moved = false;
+            restored = seekTo({pts, pts, -1, 0}, frame_count, 0, moved);
+        }
+
+        if (restored)
+        {
+            // Same position as before, sampling continues where it was
+            m_frame_count = frame_count;
+            m_step_phase = step_phase;
+            m_sample_origin = sample_origin;
+            m_sample_count = sample_count;
+            m_position_unread = unread;
+        }
+        else
+        {
+            // Nothing left to read, the position reports the end of the stream instead of the position left
+            const double total = get(cv::CAP_PROP_FRAME_COUNT);
+            m_frame_count = std::max<int64_t>(frame_count, total > 0 ? std::llround(total) : frame_count);
+            m_seek_frame_pending = false;
+            m_position_unread = false;
+        }
+        m_last_pts = last_pts;
+        return restored;
+    }
+
+    /// Build the frame index by scanning all packets of the video stream (no decoding), then restore the read position
+    /// @return true if the index was built (and saved to the sidecar when opened with frame_index), false otherwise
+    /// @note Makes every later set() of a position a direct seek to the right keyframe, and CAP_PROP_FRAME_COUNT exact
+    bool VideoCapture::buildIndex()
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        if (!isOpened())
+            return false;
+
+        const int64_t position = m_frame_count;
+        const int64_t last_pts = m_last_pts;
+        const bool unread = m_position_unread;
+        AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
+
+        // The scan moves the demuxer, nothing else may read from it meanwhile
+        stopPrefetch();
+        m_index.beginRecording(indexStreamInfo());
+
+        const int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        bool ok = av_seek_frame(m_fmt_ctx, m_video_stream_index, start_time, AVSEEK_FLAG_BACKWARD) >= 0;
+
+        AVPacket *pkt = m_packet;
+        int ret = AVERROR_EOF;
+        while (ok && (ret = av_read_frame(m_fmt_ctx, pkt)) >= 0)
+        {
+            if (pkt->stream_index == m_video_stream_index)
+                m_index.addPacket(pkt->pts, pkt->pos, pkt->flags & AV_PKT_FLAG_KEY);
+            av_packet_unref(pkt);
+        }
+
+        ok = ok && ret == AVERROR_EOF && m_index.finishRecording();
+        if (!ok)
+            m_index.clear();
+        else if (m_options.frame_index)
+            m_index.save(m_index_path, m_filename);
+
+        // Continue where the caller left off (restarts prefetch); without index and frame rate by the timestamp of the position
+        if (!set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(position)))
+        {
+            stopPrefetch();
+            restorePosition(position, last_pts, unread);
+            if (m_options.prefetch > 0)
+                startPrefetch(m_options.prefetch);
+        }
+        return ok;
+    }
+
+    /// Parameters of the opened video stream stored with the frame index
+    FrameIndex::StreamInfo VideoCapture::indexStreamInfo() const
+    {
+        FrameIndex::StreamInfo info;
+        info.stream_index = m_video_stream_index;
+        info.width = m_width;
+        info.height = m_height;
+        info.pix_fmt = m_src_pix_fmt;
+        info.time_base_num = m_fmt_ctx->streams[m_video_stream_index]->time_base.num;
+        info.time_base_den = m_fmt_ctx->streams[m_video_stream_index]->time_base.den;
+        return info;
+    }
+
+    /// Nominal frame rate of the video stream
+    /// @return Average frame rate, or the real base frame rate if unknown ({0, 1} if neither is known)
+    AVRational VideoCapture::frameRate() const
+    {
+        AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
+        if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0)
+            return stream->avg_frame_rate;
+        if (stream->r_frame_rate.num > 0 && stream->r_frame_rate.den > 0)
+            return stream->r_frame_rate;
+        return AVRational{0, 1};
+    }
+
+    /// Number of the frame presented at a timestamp
+    /// @param pts Presentation timestamp in video stream time base
+    /// @param fallback Value returned if pts is AV_NOPTS_VALUE or the frame rate is unknown (and there is no frame index)
+    /// @return Frame number from the frame index if available, derived from the nominal frame rate otherwise
+    int64_t VideoCapture::frameNumberAt(int64_t pts, int64_t fallback) const
+    {
+        if (pts == AV_NOPTS_VALUE)
+            return fallback;
+        if (!m_index.empty())
+            return m_index.frameAtPts(pts);
+
+        AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
+        const AVRational frame_rate = frameRate();
+        if (frame_rate.num <= 0)
+            return fallback;
+        const int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        return av_rescale_q(pts - start_time, stream->time_base, av_inv_q(frame_rate));
+    }
+
+    /// Convert a frame PTS to milliseconds
+    /// @param pts Presentation timestamp in video stream time base
+    /// @return Timestamp in milliseconds, or -1 if not opened or pts is AV_NOPTS_VALUE
+    double VideoCapture::ptsToMsec(int64_t pts) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        if (!isOpened() || pts == AV_NOPTS_VALUE)
+            return -1;
+        AVStream *stream = m_fmt_ctx->streams[m_video_stream_index];
+        double time_sec = pts * av_q2d(stream->time_base);
+        return time_sec * 1000.0; // Convert to milliseconds
+    }
+
+    /// Call readFrameDirect or readFramePrefetched based on if prefetch is enabled
+    /// @param dst Pointer to an AVFrame for output (must be allocated with av_frame_alloc() by caller)
     /// @return true on success, false on EOS or error
-    bool VideoCapture::readFrameFiltered(AVFrame *dst_frame)
+    /// @note When prefetch is enabled, any buffer held by dst is replaced by the prefetched frame buffer
+    bool VideoCapture::readFrame(AVFrame *dst)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        // Single indirection, no branch
+        if (!(this->*m_readFrameImpl)(dst))
+            return false;
+
+        // Update position tracking on the caller's side (decoding may run on the prefetch thread)
+        // Subsampling and latest-frame reads skip frames, so the position follows the timestamp of the frame returned
+        if (m_options.frame_step > 1 || m_options.target_fps > 0 || m_options.skip_frame > AVDISCARD_DEFAULT || m_options.latest_frame)
+            m_frame_count = frameNumberAt(dst->pts, m_frame_count + m_options.frame_step - 1) + 1;
+        else
+            m_frame_count++;
+        m_last_pts = dst->pts;
+        m_position_unread = false;
+        return true;
+    }
+
+    /// Read the next frame without waiting for the prefetch thread, e.g. from an event loop
+    /// @param dst Pointer to an AVFrame for output, see readFrame()
+    /// @return 1 if a frame was read, 0 if prefetch has no frame ready yet, -1 on EOS or error
+    /// @note Without prefetch the frame is decoded synchronously, so 0 is never returned
+    int VideoCapture::tryReadFrame(AVFrame *dst)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        if (m_readFrameImpl == &VideoCapture::readFramePrefetched && isOpened())
+        {
+            std::lock_guard<std::mutex> prefetch_lock(m_prefetch_mutex);
+            if (m_prefetch_count == 0 && !m_prefetch_eos)
+                return 0;
+        }
+
+        // A frame or EOS is pending, readFrame() does not wait (no other reader can take it, the call lock is held)
+        return readFrame(dst) ? 1 : -1;
+    }
+
+    /// Arm a one-shot notification for the next ready frame, the wake-up of tryReadFrame() polling
+    /// @param callback Called once on the prefetch thread when a frame is queued or decoding ended, or when prefetch is stopped
+    ///                 (close, seek); must not call back into this capture
+    /// @return true if armed, false if a frame or EOS is pending already or the capture does not prefetch (callback is not called)
+    /// @note Several callbacks may be armed (e.g. concurrent waiters), all of them are called
+    bool VideoCapture::notifyWhenReady(std::function<void()> callback)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        if (m_readFrameImpl != &VideoCapture::readFramePrefetched || !isOpened())
+            return false;
+
+        std::lock_guard<std::mutex> prefetch_lock(m_prefetch_mutex);
+        if (m_prefetch_count > 0 || m_prefetch_eos)
+            return false;
+        m_ready_callbacks.push_back(std::move(callback));
+        return true;
+    }
+
+    /// Read up to count frames into one contiguous buffer, each frame converted straight into its slot where possible
+    /// @param buffer Caller-owned buffer of count * outputRows() * outputRowBytes() bytes, frames are stored as packed rows
+    /// @param count Number of frames to read
+    /// @param pts Optional array of count entries receiving the PTS of each frame read (in video stream time base)
+    /// @return Number of frames read, less than count on EOS or error
+    int VideoCapture::readFrames(uint8_t *buffer, int count, int64_t *pts)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        const int linesize = outputRowBytes();
+        const size_t frame_size = static_cast<size_t>(linesize) * outputRows();
+
+        int n = 0;
+        while (n < count && readFrameInto(buffer + n * frame_size, linesize, pts ? pts + n : nullptr))
+            n++;
+        return n;
+    }
+
+    /// Read the next frame into caller-owned memory, e.g. pinned host memory or a shared-memory segment
+    /// @param data Caller-owned image of outputRows() rows (planes of NV12/YUV420P follow each other), or tensor of outputRows() rows
+    /// @param linesize Distance in bytes between rows, at least outputRowBytes() (NCHW channel planes are outputHeight() rows apart)
+    /// @param pts Optional pointer receiving the frame PTS (in video stream time base)
+    /// @return true on success, false on EOS, error or when opened with device_output
+    /// @note Frame is converted straight into data, except with prefetch or passthrough where the ready frame is copied
+    bool VideoCapture::readFrameInto(uint8_t *data, int linesize, int64_t *pts)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_call_mutex);
+        if (!isOpened() || !data || linesize < outputRowBytes() || m_options.device_output)
+            return false;
+
+        // YUV420P chroma rows are half a luma row
+        if (m_options.pixel_format == AV_PIX_FMT_YUV420P && linesize % 2)
+            return false;
+
+        AVFrame *dst = m_caller_frame;
+        if (m_readFrameImpl == &VideoCapture::readFrameDirect)
+        {
+            // Direct path converts straight into caller memory through the frame shell
+            dst->format = m_options.tensor.enabled ? AV_PIX_FMT_NONE : m_options.pixel_format;
+            dst->width = outputWidth();
+            dst->height = outputHeight();
+            fillOutputPlanes(data, linesize, dst->data, dst->linesize);
+            if (!readFrame(dst))
+            {
+                av_frame_unref(dst);
+                return false;
+            }
+
+            // Passthrough replaced the caller memory by a reference to the decoded frame, copy that
+            if (dst->buf[0])
+                copyOutputFrame(dst, data, linesize);
+        }
+        else
+        {
+            // Prefetched path hands out its own buffers, copy those into caller memory
+            dst = m_staging_frame;
+            if (!readFrame(dst))
+                return false;
+            copyOutputFrame(dst, data, linesize);
+        }
+
+        if (pts)
+            *pts = dst->pts;
+
+        // Release the buffer reference, or reset the shell (it never owns the caller's memory)
+        av_frame_unref(dst);
+        return true;
+    }
+
+    /// Point plane pointers at an output image stored in one buffer
+    /// @param data Start of the buffer of outputRows() rows
+    /// @param linesize Distance in bytes between rows of the first plane
+    /// @param planes Receives the plane pointers (unused planes are set to nullptr)
+    /// @param linesizes Receives the plane line sizes
+    /// @note Chroma planes follow the luma rows as in the OpenCV NV12 / I420 layout; I420 chroma rows are half a luma row
+    void VideoCapture::fillOutputPlanes(uint8_t *data, int linesize, uint8_t *planes[4], int linesizes[4]) const
+    {
+        for (int p = 0; p < 4; p++)
+        {
+            planes[p] = nullptr;
+            linesizes[p] = 0;
+        }
+        planes[0] = data;
+        linesizes[0] = linesize;
+        if (m_options.tensor.enabled)
+            return;
+
+        uint8_t *chroma = data + static_cast<size_t>(linesize) * outputHeight();
+        if (m_options.pixel_format == AV_PIX_FMT_NV12)
+        {
+            planes[1] = chroma;
+            linesizes[1] = linesize;
+        }
+        else if (m_options.pixel_format == AV_PIX_FMT_YUV420P)
+        {
+            linesizes[1] = linesizes[2] = linesize / 2;
+            planes[1] = chroma;
+            planes[2] = chroma + static_cast<size_t>(linesizes[1]) * (outputHeight() / 2);
+        }
+    }
+
+    /// Copy an output frame into one caller buffer
+    /// @param src Output frame (converted, passed through or tensor)
+    /// @param data Start of the buffer of outputRows() rows
+    /// @param linesize Distance in bytes between rows of the first plane
+    void VideoCapture::copyOutputFrame(const AVFrame *src, uint8_t *data, int linesize) const
+    {
+        if (m_options.tensor.enabled)
+        {
+            av_image_copy_plane(data, linesize, src->data[0], src->linesize[0], outputRowBytes(), outputRows());
+            return;
+        }
+
+        uint8_t *planes[4];
+        int linesizes[4];
+        fillOutputPlanes(data, linesize, planes, linesizes);
+        const uint8_t *src_planes[4] = {src->data[0], src->data[1], src->data[2], src->data[3]};
+        av_image_copy(planes, linesizes, src_planes, src->linesize, m_options.pixel_format, outputWidth(), outputHeight());
+    }
+
+    /// Attach a pooled buffer of output size to a frame which has no buffer yet
+    /// @param dst Pointer to an AVFrame allocated with av_frame_alloc()
+    /// @return true on success, false on allocation failure
+    /// @note Tensor frames have format AV_PIX_FMT_NONE, data[0] holds outputRows() rows of m_output_linesize bytes
+    bool VideoCapture::allocOutputFrame(AVFrame *dst)
     {
-        // Check if video is opened and filter graph is initialized
-        if (!isOpened() || !m_filter_graph || !dst_frame)
+        dst->buf[0] = av_buffer_pool_get(m_frame_pool);
+        if (!dst->buf[0])
             return false;
 
-        // Allocate packet for reading encoded data
-        AVPacket *pkt = av_packet_alloc();
-        if (!pkt)
+        dst->format = m_options.tensor.enabled ? AV_PIX_FMT_NONE : m_options.pixel_format;
+        dst->width = outputWidth();
+        dst->height = outputHeight();
+        fillOutputPlanes(dst->buf[0]->data, m_output_linesize, dst->data, dst->linesize);
+        return true;
+    }
+
+    /// Read the next video frame, convert it to the output pixel format, and store it in the provided AVFrame
+    /// @param dst_frame Pointer to an AVFrame for output
+    /// @note dst_frame must be allocated with av_frame_alloc(), and either:
+    /// @note   - have no buffer yet (a pooled buffer of output size is attached here), or
+    /// @note   - format = output pixel format and av_frame_get_buffer(dst_frame, 32) already called
+    /// @note A decoded frame already in output format and size replaces dst_frame buffers (passthrough, no conversion)
+    /// @note With tensor output, dst_frame must have no buffer yet (fed by the pool) or point at outputRows() x outputRowBytes() memory
+    /// @note With device_output, dst_frame buffers are replaced by a reference to the decoded hardware frame
+    /// @return true on success (dst_frame filled), false on EOS or error.
+    bool VideoCapture::readFrameDirect(AVFrame *dst_frame)
+    {
+        // Check if video is opened and dst_frame frame is valid
+        if (!isOpened() || !dst_frame)
             return false;
 
+        return nextDecodedFrame() && convertDecodedFrame(m_yuv_frame, dst_frame);
+    }
+
+    /// Decode the next frame to return into m_yuv_frame, skipping frames not sampled
+    /// @return true if a frame is ready in m_yuv_frame, false on end of stream or error
+    bool VideoCapture::nextDecodedFrame()
+    {
+        // A seek leaves the frame at the target position decoded but not yet returned
+        if (m_seek_frame_pending)
+            m_seek_frame_pending = false;
+        else if (!decodeFrame())
+            return false;
+
+        // Frames not sampled are dropped here, before hardware download and conversion
+        while (!sampleDecodedFrame())
+        {
+            m_stats.addDropped();
+            if (!decodeFrame())
+                return false;
+        }
+        return true;
+    }
+
+    /// Decide whether the frame in m_yuv_frame is returned with frame_step / target_fps subsampling
+    /// @return true if the frame is returned, false if it is skipped
+    bool VideoCapture::sampleDecodedFrame()
+    {
+        // Every frame_step-th decoded frame, starting with the first one
+        if (m_options.frame_step > 1)
+        {
+            const bool take = m_step_phase == 0;
+            m_step_phase = (m_step_phase + 1) % m_options.frame_step;
+            if (!take)
+                return false;
+        }
+
+        // First frame at or after each sampling instant, target_fps apart (frames without timestamp are always taken)
+        const int64_t pts = m_yuv_frame->pts != AV_NOPTS_VALUE ? m_yuv_frame->pts : m_yuv_frame->best_effort_timestamp;
+        if (m_sample_rate.num > 0 && pts != AV_NOPTS_VALUE)
+        {
+            if (m_sample_origin != AV_NOPTS_VALUE && pts >= m_sample_origin && pts < nextSamplePts())
+                return false;
+
+            // Sampling instants are computed from the first sample, so rounding does not accumulate;
+            // the grid restarts at the first frame, after a gap longer than one interval or a backward jump
+            m_sample_count++;
+            if (m_sample_origin == AV_NOPTS_VALUE || pts < m_sample_origin || nextSamplePts() <= pts)
+            {
+                m_sample_origin = pts;
+                m_sample_count = 1;
+            }
+        }
+        return true;
+    }
+
+    /// Timestamp of the next target_fps sampling instant
+    int64_t VideoCapture::nextSamplePts() const
+    {
+        const AVRational time_base = m_fmt_ctx->streams[m_video_stream_index]->time_base;
+        return m_sample_origin + av_rescale_q(m_sample_count, av_inv_q(m_sample_rate), time_base);
+    }
+
+    /// Decode the next video frame into m_yuv_frame, without any conversion
+    /// @return true if a frame was decoded, false on end of stream or error
+    bool VideoCapture::decodeFrame()
+    {
+        // Packet reused by every read, unreferenced again after each use
+        AVPacket *pkt = m_packet;
         bool result = false;
 
-        // Loop until we get a processed frame or reach end of file
+        // Decode time of the frame is the time spent here minus the time spent in the demuxer
+        const int64_t start = statsClock();
+        int64_t demux_ns = 0;
+
+        // Loop until we get a frame or reach end of file
         for (;;)
         {
+            // Drain frames the decoder already holds before feeding it more data
+            int ret = avcodec_receive_frame(m_codec_ctx, m_yuv_frame);
+            if (ret == 0)
+            {
+                result = true;
+                break;
+            }
+
+            // EOF after flushing, or a decoding error
+            if (ret != AVERROR(EAGAIN))
+                break;
+
             // Read next packet from the video stream
-            int ret = av_read_frame(m_fmt_ctx, pkt);
+            const int64_t demux_start = statsClock();
+            armIoDeadline();
+            ret = av_read_frame(m_fmt_ctx, pkt);
+
+            // A failed or stalled network source is reopened, decoding continues with the new connection
+            const bool reconnected = ret < 0 && !m_flush_pending && (ret != AVERROR_EOF || m_options.live) && m_options.reconnect_attempts != 0 &&
+                                     !ioAborted() && reconnectInput();
+            demux_ns += statsClock() - demux_start;
+            if (reconnected)
+                continue;
 
-            // If we hit end of file, flush the decoder and filter graph
+            // If we hit end of file, flush the decoder to get any remaining frames
             if (ret < 0)
             {
-                if (!m_flush_pending)
-                {
-                    m_flush_pending = true;
-                    // Send null packet to decoder to signal end of stream
-                    avcodec_send_packet(m_codec_ctx, nullptr);
-                }
+                if (m_flush_pending)
+                    break;
+                m_flush_pending = true;
 
-                // Try to receive any remaining frames from decoder
-                ret = avcodec_receive_frame(m_codec_ctx, m_yuv_frame);
-                if (ret == 0)
-                {
-                    // Push to filter graph
-                    if (av_buffersrc_add_frame_flags(m_buffersrc_ctx, m_yuv_frame, AV_BUFFERSRC_FLAG_KEEP_REF) >= 0)
-                    {
-                        // Try to pull from filter graph
-                        ret = av_buffersink_get_frame(m_buffersink_ctx, dst_frame);
-                        if (ret >= 0)
-                        {
-                            result = true;
-                            break;
-                        }
-                    }
-                }
-                else
+                // A sequential pass from the start just completed, keep its index for later opens
+                if (m_index.isRecording())
                 {
-                    // Flush filter graph
-                    if (av_buffersrc_add_frame_flags(m_buffersrc_ctx, nullptr, 0) >= 0)
-                    {
-                        ret = av_buffersink_get_frame(m_buffersink_ctx, dst_frame);
-                        if (ret >= 0)
-                        {
-                            result = true;
-                        }
-                    }
-                    break;
+                    if (ret == AVERROR_EOF && m_index.finishRecording())
+                        m_index.save(m_index_path, m_filename);
+                    else
+                        m_index.clear();
                 }
+
+                // Send packet to decoder with null data to signal end of stream
+                avcodec_send_packet(m_codec_ctx, nullptr);
+                continue;
             }
 
-            // Filter packets by stream (only process video stream)
+            // Filter packets by stream (only process video stream, discard all others)
+            m_stats.addPacket(pkt->size, pkt->stream_index == m_video_stream_index);
             if (pkt->stream_index == m_video_stream_index)
             {
+                m_index.addPacket(pkt->pts, pkt->pos, pkt->flags & AV_PKT_FLAG_KEY);
+
                 // Send packet to decoder
                 ret = avcodec_send_packet(m_codec_ctx, pkt);
-                av_packet_unref(pkt);
 
+                // Free packet's internal buffers (packet is reused by the next read)
+                av_packet_unref(pkt);
                 if (ret < 0)
-                {
-                    result = false;
                     break;
-                }
-
-                // Try to receive decoded frame
-                ret = avcodec_receive_frame(m_codec_ctx, m_yuv_frame);
-                if (ret == 0)
-                {
-                    // Push decoded YUV frame to filter graph
-                    if (av_buffersrc_add_frame_flags(m_buffersrc_ctx, m_yuv_frame, AV_BUFFERSRC_FLAG_KEEP_REF) >= 0)
-                    {
-                        // Pull processed BGR frame from filter graph
-                        ret = av_buffersink_get_frame(m_buffersink_ctx, dst_frame);
-                        if (ret >= 0)
-                        {
-                            result = true;
-                            break;
-                        }
-                        // EAGAIN means need more frames, continue loop
-                    }
-                }
-                // EAGAIN means need more packets, continue loop
             }
+            // Packet does not belong to video stream, ignore it and read next
             else
             {
-                // Not a video packet, ignore it
+                // Free packet's internal buffers since we're not using it
                 av_packet_unref(pkt);
             }
         }
 
-        av_packet_free(&pkt);
+        m_stats.addDemux(demux_ns);
+        if (result)
+            m_stats.decode.add(statsClock() - start - demux_ns);
         return result;
     }
 
-    /// Create and initialize the FFmpeg filter graph for resizing and format conversion
-    /// @return true on successful initialization, false on failure
-    bool VideoCapture::initFilterGraph()
+    /// Convert a decoded frame to the output format
+    /// @param decoded Decoded frame (m_yuv_frame, or a frame queued by the pipelined decode stage), its buffers may be moved into dst_frame
+    /// @param dst_frame Pointer to an AVFrame for output, see readFrameDirect()
+    /// @return true if the frame was converted, false on error
+    bool VideoCapture::convertDecodedFrame(AVFrame *decoded, AVFrame *dst_frame)
     {
-        // Allocate filter graph
-        m_filter_graph = avfilter_graph_alloc();
-        if (!m_filter_graph)
+        const int64_t start = statsClock();
+
+        // Hand decoded hardware frame over as-is, the data stays in device memory
+        if (m_options.device_output)
         {
+            av_frame_unref(dst_frame);
+            av_frame_move_ref(dst_frame, decoded);
+            m_stats.convert.add(statsClock() - start);
+            return true;
+        }
+
+        // Get decoded frame in system memory (downloaded from the GPU for hardware decoding)
+        AVFrame *yuv_frame = transferDecodedFrame(decoded);
+        if (!yuv_frame)
             return false;
+
+        // Renditions first, passthrough may hand the decoded buffers over to dst_frame
+        AVBufferRef *renditions = nullptr;
+        if (!m_renditions.empty() && !(renditions = convertRenditions(yuv_frame)))
+            return false;
+
+        // Decoded frame is already what the caller asked for, hand its buffers over as-is
+        bool ok = passthroughFrame(yuv_frame, dst_frame);
+        if (!ok)
+        {
+            // A passed-through frame may share its buffers with the decoder, never convert into those
+            if (dst_frame->buf[0] && !av_frame_is_writable(dst_frame))
+                av_frame_unref(dst_frame);
+
+            // Attach output buffer on first use of this frame
+            ok = (dst_frame->data[0] || allocOutputFrame(dst_frame)) && convertFrame(yuv_frame, dst_frame);
         }
 
-        // Create buffer source
-        const AVFilter *buffersrc = avfilter_get_by_name("buffer");
-        if (!buffersrc)
+        // Renditions travel with the main output frame (prefetch ring, caller) and are released with it
+        if (renditions && ok)
         {
-            return false;
+            av_buffer_unref(&dst_frame->opaque_ref);
+            dst_frame->opaque_ref = renditions;
+        }
+        else
+            av_buffer_unref(&renditions);
+        if (ok)
+            m_stats.convert.add(statsClock() - start);
+        return ok;
+    }
+
+    /// Convert a decoded frame into every rendition
+    /// @param src Decoded frame in system memory
+    /// @return Pooled rendition set to attach to the output frame as opaque_ref, nullptr on error
+    /// @note Rendition frames of a set given back to the pool keep their buffers until the set is reused
+    AVBufferRef *VideoCapture::convertRenditions(const AVFrame *src)
+    {
+        AVBufferRef *set_ref = av_buffer_pool_get(m_rendition_set_pool);
+        if (!set_ref)
+            return nullptr;
+        RenditionSet *set = reinterpret_cast<RenditionSet *>(set_ref->data);
+        set->count = 0;
+        for (Rendition &rendition : m_renditions)
+        {
+            AVFrame *&frame = set->frames[set->count];
+            if (!frame)
+                frame = allocFrame();
+            if (!frame)
+            {
+                av_buffer_unref(&set_ref);
+                return nullptr;
+            }
+            av_frame_unref(frame);
+            if (!convertRendition(rendition, src, frame))
+            {
+                av_buffer_unref(&set_ref);
+                return nullptr;
+            }
+            set->count++;
         }
+        return set_ref;
+    }
 
-        // Build source args
-        std::ostringstream args;
-        args << "video_size=" << m_codec_ctx->width << "x" << m_codec_ctx->height
-             << ":pix_fmt=" << m_codec_ctx->pix_fmt
-             << ":time_base=" << m_fmt_ctx->streams[m_video_stream_index]->time_base.num << "/" << m_fmt_ctx->streams[m_video_stream_index]->time_base.den
-             << ":pixel_aspect=" << m_codec_ctx->sample_aspect_ratio.num << "/"
-             << (m_codec_ctx->sample_aspect_ratio.den ? m_codec_ctx->sample_aspect_ratio.den : 1);
+    /// Convert a decoded frame into one rendition
+    /// @param rendition Rendition to produce
+    /// @param src Decoded frame in system memory
+    /// @param dst Empty frame receiving a pooled buffer, or a reference to src if it already has the rendition format and size
+    /// @return true on success, false on allocation failure or if swscale cannot convert from the decoded format
+    bool VideoCapture::convertRendition(Rendition &rendition, const AVFrame *src, AVFrame *dst)
+    {
+        const AVPixelFormat format = rendition.spec.pixel_format;
+        if (src->format == format && src->width == rendition.width && src->height == rendition.height)
+            return av_frame_ref(dst, src) >= 0;
 
-        // Setup buffer source with properties string
-        if (avfilter_graph_create_filter(&m_buffersrc_ctx, buffersrc, "in",
-                                         args.str().c_str(), nullptr, m_filter_graph) < 0)
+        if (!rendition.sws_ctx || rendition.sws_src_pix_fmt != src->format)
         {
+            sws_freeContext(rendition.sws_ctx);
+            rendition.sws_src_pix_fmt = static_cast<AVPixelFormat>(src->format);
+            rendition.sws_ctx = sws_getContext(src->width, src->height, rendition.sws_src_pix_fmt, rendition.scaled_width, rendition.scaled_height,
+                                               format, SWS_BILINEAR, nullptr, nullptr, nullptr);
+            if (!rendition.sws_ctx)
+                return false;
+            setSwsColorimetry(rendition.sws_ctx, rendition.sws_src_pix_fmt, format, src->colorspace, src->color_range);
+        }
+
+        dst->buf[0] = av_buffer_pool_get(rendition.pool);
+        if (!dst->buf[0])
             return false;
+        dst->format = format;
+        dst->width = rendition.width;
+        dst->height = rendition.height;
+        av_image_fill_arrays(dst->data, dst->linesize, dst->buf[0]->data, format, rendition.width, rendition.height, 32);
+
+        uint8_t *dst_data[4];
+        planesAt(dst, rendition.pad_x, rendition.pad_y, dst_data);
+        sws_scale(rendition.sws_ctx, src->data, src->linesize, 0, src->height, dst_data, dst->linesize);
+        if (rendition.scaled_width != rendition.width || rendition.scaled_height != rendition.height)
+            clearLetterboxBorder(dst, rendition.scaled_width, rendition.scaled_height, rendition.pad_x, rendition.pad_y);
+        dst->pts = src->pts;
+        return true;
+    }
+
+    /// Free the conversion contexts and buffer pools of all renditions (buffers still referenced are freed once released)
+    void VideoCapture::freeRenditions()
+    {
+        for (Rendition &rendition : m_renditions)
+        {
+            sws_freeContext(rendition.sws_ctx);
+            av_buffer_pool_uninit(&rendition.pool);
         }
+        m_renditions.clear();
+        av_buffer_pool_uninit(&m_rendition_set_pool);
+    }
+
+    /// Rendition of a frame read from a capture opened with renditions
+    /// @param frame Frame returned by readFrame()
+    /// @param index Rendition index in VideoCaptureOptions::renditions order
+    /// @return Rendition frame owned by frame (valid until frame is unreferenced), nullptr if frame has no such rendition
+    const AVFrame *VideoCapture::renditionFrame(const AVFrame *frame, int index)
+    {
+        const RenditionSet *set = frame && frame->opaque_ref ? reinterpret_cast<const RenditionSet *>(frame->opaque_ref->data) : nullptr;
+        return set && index >= 0 && index < set->count ? set->frames[index] : nullptr;
+    }
+
+    /// Convert a decoded frame to the output pixel format or tensor output, resized straight into the letterbox interior of dst
+    /// @param src Decoded frame in system memory
+    /// @param dst_frame Pointer to an AVFrame with a buffer of outputRows() x outputRowBytes()
+    /// @return true on success, false if no conversion context could be created for the source format
+    bool VideoCapture::convertFrame(const AVFrame *src, AVFrame *dst_frame)
+    {
+        const AVPixelFormat src_format = static_cast<AVPixelFormat>(src->format);
 
-        // Create buffer sink
-        const AVFilter *buffersink = avfilter_get_by_name("buffersink");
-        if (!buffersink)
+        // Unscaled YUV -> BGR24 / RGB24 on the specialized kernel, re-selected when the source format or colorimetry changes
+        if (m_direct_color)
         {
+            if (!m_color_converter.matches(src_format, src->colorspace, src->color_range))
+                m_color_converter.init(src_format, m_convert_pix_fmt, src->colorspace, src->color_range);
+            if (m_color_converter.valid())
+            {
+                uint8_t *src_data[4], *dst_data[4];
+                planesAt(src, m_crop_x, m_crop_y, src_data);
+                planesAt(dst_frame, m_pad_x, m_pad_y, dst_data);
+                const uint8_t *const planes[3] = {src_data[0], src_data[1], src_data[2]};
+                m_color_converter.convert(planes, src->linesize, m_crop_width, m_crop_height, dst_data[0], dst_frame->linesize[0]);
+                if (m_scaled_width != outputWidth() || m_scaled_height != outputHeight())
+                    clearLetterboxBorder(dst_frame, m_scaled_width, m_scaled_height, m_pad_x, m_pad_y);
+                dst_frame->pts = src->pts;
+                return true;
+            }
+        }
+
+        // Downloaded software format (or a decoded format differing from the one expected at open) is known only now,
+        // keeps the existing context while it stays the same
+        if (!updateSwsContext(src_format, src->colorspace, src->color_range))
             return false;
+
+        // Tensor output: YUV -> planar RGB (+ resize) into the internal frame, then normalize + reorder into dst in one pass
+        if (m_tensor_frame)
+        {
+            if (!scaleInto(src, m_tensor_frame))
+                return false;
+
+            // GBRP plane order is G, B, R
+            static const int rgb_order[3] = {2, 0, 1};
+            static const int bgr_order[3] = {1, 0, 2};
+            const int *order = m_options.tensor.rgb ? rgb_order : bgr_order;
+            const uint8_t *const planes[3] = {m_tensor_frame->data[order[0]], m_tensor_frame->data[order[1]], m_tensor_frame->data[order[2]]};
+            const int linesizes[3] = {m_tensor_frame->linesize[order[0]], m_tensor_frame->linesize[order[1]], m_tensor_frame->linesize[order[2]]};
+            m_tensor_converter.convert(planes, linesizes, outputWidth(), outputHeight(), dst_frame->data[0], dst_frame->linesize[0]);
+
+            dst_frame->pts = src->pts;
+            return true;
         }
 
-        // Setup buffer sink
-        if (avfilter_graph_create_filter(&m_buffersink_ctx, buffersink, "out",
-                                         nullptr, nullptr, m_filter_graph) < 0)
+        // Convert YUV -> output format (+ resize) into caller's buffer, single pass with no intermediate frame
+        if (!scaleInto(src, dst_frame))
+            return false;
+
+        // Letterbox padding
+        if (m_scaled_width != outputWidth() || m_scaled_height != outputHeight())
+            clearLetterboxBorder(dst_frame, m_scaled_width, m_scaled_height, m_pad_x, m_pad_y);
+
+        // Copy basic timing info if you care about PTS, etc.
+        dst_frame->pts = src->pts;
+        return true;
+    }
+
+    /// Create the swscale context for a source pixel format and colorimetry, unless the current one already converts from it
+    /// @param src_format Pixel format of the frames to convert
+    /// @param colorspace Colorspace tag of the frames, selecting the YUV -> RGB matrix
+    /// @param range Range tag of the frames
+    /// @return true on success, false if swscale cannot convert from src_format
+    /// @note With convert_threads > 1 the context scales horizontal slices of each frame on that many threads
+    bool VideoCapture::updateSwsContext(AVPixelFormat src_format, AVColorSpace colorspace, AVColorRange range)
+    {
+        if (m_sws_ctx && m_sws_src_pix_fmt == src_format && m_sws_colorspace == colorspace && m_sws_color_range == range)
+            return true;
+
+        sws_freeContext(m_sws_ctx);
+        m_sws_src_pix_fmt = src_format;
+        m_sws_colorspace = colorspace;
+        m_sws_color_range = range;
+        m_sws_ctx = sws_alloc_context();
+        if (!m_sws_ctx)
+            return false;
+        av_opt_set_int(m_sws_ctx, "srcw", m_crop_width, 0);
+        av_opt_set_int(m_sws_ctx, "srch", m_crop_height, 0);
+        av_opt_set_int(m_sws_ctx, "src_format", src_format, 0);
+        av_opt_set_int(m_sws_ctx, "dstw", m_scaled_width, 0);
+        av_opt_set_int(m_sws_ctx, "dsth", m_scaled_height, 0);
+        av_opt_set_int(m_sws_ctx, "dst_format", m_convert_pix_fmt, 0);
+        av_opt_set_int(m_sws_ctx, "sws_flags", SWS_BILINEAR, 0);
+        av_opt_set_int(m_sws_ctx, "threads", std::max(m_options.convert_threads, 1), 0);
+        ScopedThreadAffinity pin(m_thread_affinity); // slice threads start in sws_init_context()
+        if (sws_init_context(m_sws_ctx, nullptr, nullptr) < 0)
         {
+            sws_freeContext(m_sws_ctx);
+            m_sws_ctx = nullptr;
             return false;
         }
+        setSwsColorimetry(m_sws_ctx, src_format, m_convert_pix_fmt, colorspace, range);
+        return true;
+    }
 
-        // Set output pixel format to BGR24
-        enum AVPixelFormat pix_fmts[] = {AV_PIX_FMT_BGR24, AV_PIX_FMT_NONE};
-        if (av_opt_set_int_list(m_buffersink_ctx, "pix_fmts", pix_fmts,
-                                AV_PIX_FMT_NONE, AV_OPT_SEARCH_CHILDREN) < 0)
+    /// Scale a frame into the letterbox interior of a frame of output size
+    /// @param src Decoded frame in system memory (reference counted)
+    /// @param dst_frame Frame of outputWidth() x outputHeight() in m_convert_pix_fmt
+    /// @return true on success, false if scaling failed
+    bool VideoCapture::scaleInto(const AVFrame *src, const AVFrame *dst_frame)
+    {
+        // Region of interest: swscale reads from the crop origin, pixels outside it are never converted
+        uint8_t *src_data[4];
+        planesAt(src, m_crop_x, m_crop_y, src_data);
+        uint8_t *dst_data[4];
+        planesAt(dst_frame, m_pad_x, m_pad_y, dst_data);
+        if (m_options.convert_threads <= 1)
         {
-            return false;
+            sws_scale(m_sws_ctx, src_data, src->linesize, 0, m_crop_height, dst_data, dst_frame->linesize);
+            return true;
+        }
+
+        // Cropped source as a frame referencing the decoded buffers (frames without buffers would be copied)
+        if (m_crop_width != src->width || m_crop_height != src->height)
+        {
+            AVFrame *src_view = m_sws_src_view_frame;
+            if (av_frame_ref(src_view, src) < 0)
+                return false;
+            src_view->width = m_crop_width;
+            src_view->height = m_crop_height;
+            for (int p = 0; p < 4; p++)
+                src_view->data[p] = src_data[p];
+            src = src_view;
         }
 
-        // Create filter chain: buffer -> scale -> pad -> format -> buffersink
-        AVFilterContext *last_filter = m_buffersrc_ctx;
+        // Slice threading is only done by the frame API, which takes the interior as a view frame of scaled size,
+        // its buffer reference does not own the memory (pooled, tensor or caller memory)
+        AVFrame *view = m_sws_view_frame;
+        view->format = m_convert_pix_fmt;
+        view->width = m_scaled_width;
+        view->height = m_scaled_height;
+        for (int p = 0; p < 4; p++)
+        {
+            view->data[p] = dst_data[p];
+            view->linesize[p] = dst_frame->linesize[p];
+        }
+        view->buf[0] = av_buffer_create(dst_data[0], 1, [](void *, uint8_t *) {}, nullptr, 0);
+        const bool ok = view->buf[0] && sws_scale_frame(m_sws_ctx, view, src) >= 0;
+        av_frame_unref(view);
+        av_frame_unref(m_sws_src_view_frame);
+        return ok;
+    }
 
-        // Scale filter: scale to target size maintaining aspect ratio
-        std::ostringstream scale_args;
-        scale_args << m_target_width << ":" << m_target_height
-                   << ":force_original_aspect_ratio=decrease";
+    /// Fill the letterbox border around the scaled image with black
+    /// @param dst_frame Pointer to an AVFrame with an output buffer (main output or rendition)
+    /// @param scaled_width Width of the scaled image inside the frame
+    /// @param scaled_height Height of the scaled image inside the frame
+    /// @param pad_x Left border in pixels
+    /// @param pad_y Top border in pixels
+    /// @note Done for every frame since frames handed to the caller are writable and may come back through the pool modified
+    void VideoCapture::clearLetterboxBorder(AVFrame *dst_frame, int scaled_width, int scaled_height, int pad_x, int pad_y)
+    {
+        const int right = pad_x + scaled_width;
+        const int bottom = pad_y + scaled_height;
 
-        // Create and setup scale filter
-        const AVFilter *scale_filter = avfilter_get_by_name("scale");
-        AVFilterContext *scale_ctx = nullptr;
-        if (avfilter_graph_create_filter(&scale_ctx, scale_filter, "scale",
-                                         scale_args.str().c_str(), nullptr, m_filter_graph) < 0)
+        // Top, bottom, left and right border rectangles as x, y, width, height
+        const int borders[4][4] = {
+            {0, 0, dst_frame->width, pad_y},
+            {0, bottom, dst_frame->width, dst_frame->height - bottom},
+            {0, pad_y, pad_x, scaled_height},
+            {right, pad_y, dst_frame->width - right, scaled_height}};
+
+        for (const auto &border : borders)
         {
-            return false;
+            if (border[2] <= 0 || border[3] <= 0)
+                continue;
+
+            uint8_t *data[4];
+            planesAt(dst_frame, border[0], border[1], data);
+            const ptrdiff_t linesize[4] = {dst_frame->linesize[0], dst_frame->linesize[1], dst_frame->linesize[2], dst_frame->linesize[3]};
+
+            // Limited range black for YUV/gray output, as produced by swscale; zero for RGB
+            av_image_fill_black(data, linesize, static_cast<AVPixelFormat>(dst_frame->format), AVCOL_RANGE_MPEG, border[2], border[3]);
         }
+    }
 
-        // Link scale filter to buffer source
-        if (avfilter_link(last_filter, 0, scale_ctx, 0) < 0)
+    /// Plane pointers of a frame at a pixel position
+    /// @param frame Frame with a software pixel format
+    /// @param x Column in pixels, rounded down to a multiple of the horizontal chroma subsampling factor
+    /// @param y Row in pixels, rounded down to a multiple of the vertical chroma subsampling factor
+    /// @param data Receives the plane pointers (nullptr for planes the frame does not have)
+    /// @note Rounding keeps luma and chroma of the position aligned, e.g. an odd crop origin of a 4:2:0 frame starts one pixel earlier
+    void VideoCapture::planesAt(const AVFrame *frame, int x, int y, uint8_t *data[4])
+    {
+        const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+        int pixsteps[4];
+        int pixstep_comps[4];
+        av_image_fill_max_pixsteps(pixsteps, pixstep_comps, desc);
+
+        // Chroma planes of YUV formats are subsampled
+        const bool yuv = !(desc->flags & AV_PIX_FMT_FLAG_RGB);
+        if (yuv)
         {
+            x &= ~((1 << desc->log2_chroma_w) - 1);
+            y &= ~((1 << desc->log2_chroma_h) - 1);
+        }
+
+        for (int p = 0; p < 4; p++)
+        {
+            const bool chroma = (p == 1 || p == 2) && yuv;
+            const int px = chroma ? x >> desc->log2_chroma_w : x;
+            const int py = chroma ? y >> desc->log2_chroma_h : y;
+            data[p] = frame->data[p] ? frame->data[p] + static_cast<ptrdiff_t>(py) * frame->linesize[p] + px * pixsteps[p] : nullptr;
+        }
+    }
+
+    /// Move a decoded frame into dst when it already has the output format and size, so no conversion is needed
+    /// @param src Decoded frame in system memory
+    /// @param dst_frame Pointer to an AVFrame for output, its buffers are replaced on success
+    /// @return true if src was moved into dst_frame, false if it needs conversion
+    /// @note GRAY8 output views the luma plane of any 8-bit YUV frame
+    bool VideoCapture::passthroughFrame(AVFrame *src, AVFrame *dst_frame)
+    {
+        if (m_tensor_frame || src->width != outputWidth() || src->height != outputHeight() ||
+            m_scaled_width != outputWidth() || m_scaled_height != outputHeight())
+            return false;
+
+        const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(src->format));
+        const bool luma_view = m_options.pixel_format == AV_PIX_FMT_GRAY8 && desc &&
+                               !(desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL)) &&
+                               desc->comp[0].plane == 0 && desc->comp[0].step == 1 && desc->comp[0].depth == 8;
+        if (src->format != m_options.pixel_format && !luma_view)
             return false;
+
+        av_frame_unref(dst_frame);
+        av_frame_move_ref(dst_frame, src);
+
+        // Keep only the luma plane, chroma buffers stay referenced until the frame is released
+        if (luma_view)
+        {
+            dst_frame->format = AV_PIX_FMT_GRAY8;
+            for (int p = 1; p < AV_NUM_DATA_POINTERS; p++)
+            {
+                dst_frame->data[p] = nullptr;
+                dst_frame->linesize[p] = 0;
+            }
         }
-        last_filter = scale_ctx;
+        return true;
+    }
 
-        // Pad filter: pad to exact target size, centered
-        std::ostringstream pad_args;
-        pad_args << m_target_width << ":" << m_target_height
-                 << ":(ow-iw)/2:(oh-ih)/2";
+    /// Create hardware device context for the requested backend and attach it to the decoder
+    /// @param decoder Decoder selected for the video stream
+    /// @param hw_device Hardware device as "type[:device]", e.g. "cuda", "cuda:1", "vaapi:/dev/dri/renderD128"
+    /// @return true on success, false if the backend is unknown, unsupported by the decoder or the device cannot be opened
+    bool VideoCapture::initHwDecoder(const AVCodec *decoder, const std::string &hw_device)
+    {
+        // Split "type[:device]"
+        const size_t colon = hw_device.find(':');
+        std::string type_name = hw_device.substr(0, colon);
+        const std::string device = colon == std::string::npos ? std::string() : hw_device.substr(colon + 1);
+
+        // NVDEC is exposed by FFmpeg through the CUDA device type
+        if (type_name == "nvdec")
+            type_name = "cuda";
+
+        const AVHWDeviceType type = av_hwdevice_find_type_by_name(type_name.c_str());
+        if (type == AV_HWDEVICE_TYPE_NONE)
+            return false;
 
-        // Create and setup pad filter
-        const AVFilter *pad_filter = avfilter_get_by_name("pad");
-        AVFilterContext *pad_ctx = nullptr;
-        if (avfilter_graph_create_filter(&pad_ctx, pad_filter, "pad",
-                                         pad_args.str().c_str(), nullptr, m_filter_graph) < 0)
+        // Find the hardware pixel format this decoder produces for the device type
+        for (int i = 0;; i++)
         {
+            const AVCodecHWConfig *config = avcodec_get_hw_config(decoder, i);
+            if (!config)
+                return false;
+            if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) && config->device_type == type)
+            {
+                m_hw_pix_fmt = config->pix_fmt;
+                break;
+            }
+        }
+
+        // Open the device
+        if (av_hwdevice_ctx_create(&m_hw_device_ctx, type, device.empty() ? nullptr : device.c_str(), nullptr, 0) < 0)
             return false;
+
+        m_codec_ctx->hw_device_ctx = av_buffer_ref(m_hw_device_ctx);
+        if (!m_codec_ctx->hw_device_ctx)
+            return false;
+        m_codec_ctx->opaque = this;
+        m_codec_ctx->get_format = &VideoCapture::getHwFormat;
+        return true;
+    }
+
+    /// FFmpeg get_format callback: pick the hardware pixel format, or fall back to software decoding if not offered
+    /// @param ctx Codec context (opaque points to the owning VideoCapture)
+    /// @param fmts List of formats offered by the decoder, terminated by AV_PIX_FMT_NONE
+    /// @return Selected pixel format
+    AVPixelFormat VideoCapture::getHwFormat(AVCodecContext *ctx, const AVPixelFormat *fmts)
+    {
+        const VideoCapture *self = static_cast<const VideoCapture *>(ctx->opaque);
+        for (const AVPixelFormat *p = fmts; *p != AV_PIX_FMT_NONE; p++)
+        {
+            if (*p == self->m_hw_pix_fmt)
+                return *p;
         }
 
-        // Link pad filter to scale filter
-        if (avfilter_link(last_filter, 0, pad_ctx, 0) < 0)
+        // Hardware format not offered (e.g. unsupported profile), use first software format
+        for (const AVPixelFormat *p = fmts; *p != AV_PIX_FMT_NONE; p++)
         {
-            return false;
+            if (!(av_pix_fmt_desc_get(*p)->flags & AV_PIX_FMT_FLAG_HWACCEL))
+                return *p;
         }
-        last_filter = pad_ctx;
+        return AV_PIX_FMT_NONE;
+    }
+
+    /// Return a decoded frame in system memory
+    /// @param decoded Decoded frame
+    /// @return decoded for software decoded frames, m_sw_frame with downloaded data for hardware frames, nullptr on download failure
+    AVFrame *VideoCapture::transferDecodedFrame(AVFrame *decoded)
+    {
+        if (m_hw_pix_fmt == AV_PIX_FMT_NONE || decoded->format != m_hw_pix_fmt)
+            return decoded;
+
+        av_frame_unref(m_sw_frame);
+        if (av_hwframe_transfer_data(m_sw_frame, decoded, 0) < 0)
+            return nullptr;
+        av_frame_copy_props(m_sw_frame, decoded);
+        return m_sw_frame;
+    }
 
-        // Format filter: convert to BGR24
-        const AVFilter *format_filter = avfilter_get_by_name("format");
-        AVFilterContext *format_ctx = nullptr;
-        if (avfilter_graph_create_filter(&format_ctx, format_filter, "format",
-                                         "pix_fmts=bgr24", nullptr, m_filter_graph) < 0)
+    /// Resolve the CPUs of the threads created by the capture from cpu_affinity and numa_node into m_thread_affinity
+    /// @param options Open-time options
+    /// @return false for CPUs the system does not have, a NUMA node that does not exist or a node sharing no CPU with cpu_affinity
+    bool VideoCapture::resolveThreadAffinity(const VideoCaptureOptions &options)
+    {
+        m_thread_affinity = options.cpu_affinity;
+        std::sort(m_thread_affinity.begin(), m_thread_affinity.end());
+        m_thread_affinity.erase(std::unique(m_thread_affinity.begin(), m_thread_affinity.end()), m_thread_affinity.end());
+        if (!m_thread_affinity.empty() && m_thread_affinity.front() < 0)
+            return false;
+        if (options.numa_node != -1)
         {
+            const std::vector<int> node_cpus = numaNodeCpus(options.numa_node);
+            if (m_thread_affinity.empty())
+                m_thread_affinity = node_cpus;
+            else
+            {
+                std::vector<int> both;
+                std::set_intersection(m_thread_affinity.begin(), m_thread_affinity.end(), node_cpus.begin(), node_cpus.end(), std::back_inserter(both));
+                m_thread_affinity.swap(both);
+            }
+            if (m_thread_affinity.empty())
+                return false;
+        }
+        else if (m_thread_affinity.empty())
+            return true;
+
+        // Apply once on this thread to reject CPUs the system does not have (and platforms without affinity) at open
+        std::vector<int> previous;
+        if (!setThreadAffinity(m_thread_affinity, &previous))
+            return false;
+        setThreadAffinity(previous);
+        return true;
+    }
+
+    /// Open the input of m_filename (or m_memory_input) with the I/O interrupt callback and live source options
+    /// @param fmt_ctx Receives the opened format context, header read but streams not probed
+    /// @return true on success, false if the source cannot be opened (fmt_ctx is left nullptr)
+    bool VideoCapture::openInput(AVFormatContext **fmt_ctx)
+    {
+        *fmt_ctx = avformat_alloc_context();
+        if (!*fmt_ctx)
             return false;
+        (*fmt_ctx)->interrupt_callback.callback = &VideoCapture::interruptCallback;
+        (*fmt_ctx)->interrupt_callback.opaque = this;
+        armIoDeadline();
+
+        // Memory input: the demuxer reads through callbacks over the buffer instead of opening a protocol
+        if (m_memory_input)
+        {
+            m_memory_io = m_memory_input->createIOContext();
+            if (!m_memory_io)
+            {
+                avformat_free_context(*fmt_ctx);
+                *fmt_ctx = nullptr;
+                return false;
+            }
+            (*fmt_ctx)->pb = m_memory_io;
         }
 
-        // Link format filter to pad filter
-        if (avfilter_link(last_filter, 0, format_ctx, 0) < 0)
+        // Live sources: no demuxer buffering and short probing, frames are handed out as soon as they arrive
+        AVDictionary *format_opts = nullptr;
+        if (m_options.live)
+        {
+            av_dict_set(&format_opts, "fflags", "nobuffer", 0);
+            av_dict_set(&format_opts, "probesize", "32768", 0);
+            av_dict_set(&format_opts, "analyzeduration", "500000", 0);
+        }
+        if (!m_options.rtsp_transport.empty())
+            av_dict_set(&format_opts, "rtsp_transport", m_options.rtsp_transport.c_str(), 0);
+
+        // Explicit probing limits override the live ones; small values shorten opening of files with complete headers
+        if (m_options.probesize > 0)
+            av_dict_set_int(&format_opts, "probesize", m_options.probesize, 0);
+        if (m_options.analyze_duration_ms > 0)
+            av_dict_set_int(&format_opts, "analyzeduration", static_cast<int64_t>(m_options.analyze_duration_ms) * 1000, 0);
+
+        // A format hint skips format detection, which reads and scores the first probesize bytes
+        const AVInputFormat *input_format = nullptr;
+        if (!m_options.input_format.empty())
         {
+            input_format = av_find_input_format(m_options.input_format.c_str());
+            if (!input_format)
+            {
+                av_dict_free(&format_opts);
+                avformat_free_context(*fmt_ctx);
+                *fmt_ctx = nullptr;
+                MemoryInput::freeIOContext(&m_memory_io);
+                return false;
+            }
+        }
+
+        // Frees the context on failure
+        const int ret = avformat_open_input(fmt_ctx, m_filename.c_str(), input_format, &format_opts);
+        av_dict_free(&format_opts);
+        if (ret < 0)
+            MemoryInput::freeIOContext(&m_memory_io);
+        return ret >= 0;
+    }
+
+    /// Reopen a failed or stalled source with exponential backoff, keeping decoder, conversion and output buffers
+    /// @return true if reconnected to a stream with unchanged parameters, false if attempts ran out, the stream changed or prefetch is stopping
+    /// @note A stream with different codec parameters (e.g. resolution) ends the capture: read() fails and the caller reopens
+    bool VideoCapture::reconnectInput()
+    {
+        // Memory input does not drop out, a failed read is a corrupt file
+        if (m_memory_input)
             return false;
+
+        const AVCodecParameters *par = m_fmt_ctx->streams[m_video_stream_index]->codecpar;
+        int delay_ms = m_options.reconnect_delay_ms;
+        for (int attempt = 0; m_options.reconnect_attempts < 0 || attempt < m_options.reconnect_attempts; attempt++)
+        {
+            // Back off, interrupted by close() or stopPrefetch()
+            const auto wake = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+            while (std::chrono::steady_clock::now() < wake)
+            {
+                if (ioAborted())
+                    return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            // Doubling starts from at least 100 ms, so a zero delay only makes the first attempt immediate
+            delay_ms = std::min(std::max(delay_ms, 100), 5000) * 2;
+
+            AVFormatContext *fmt_ctx = nullptr;
+            if (!openInput(&fmt_ctx))
+                continue;
+            // Probed like reopen(): fast_open trusts a header carrying codec parameters
+            const int stream_index = !needsStreamInfo(fmt_ctx) || (armIoDeadline(), avformat_find_stream_info(fmt_ctx, nullptr) >= 0)
+                                         ? av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0)
+                                         : -1;
+            if (stream_index < 0)
+            {
+                avformat_close_input(&fmt_ctx);
+                continue;
+            }
+
+            // Decoder and conversion are configured for the old parameters
+            if (!sameCodecParameters(par, fmt_ctx->streams[stream_index]->codecpar))
+            {
+                avformat_close_input(&fmt_ctx);
+                return false;
+            }
+
+            // Switch over, references to the old stream state (pending frames, index pass) are dropped
+            avformat_close_input(&m_fmt_ctx);
+            m_fmt_ctx = fmt_ctx;
+            m_video_stream_index = stream_index;
+            avcodec_flush_buffers(m_codec_ctx);
+            m_index.cancelRecording();
+            m_reconnect_count++;
+            return true;
         }
-        last_filter = format_ctx;
+        return false;
+    }
+
+    /// Whether stream probing (avformat_find_stream_info, decoding ahead) is needed to set up decoding of an opened input
+    /// @param fmt_ctx Input with its header read
+    /// @return false with fast_open if the header of the best video stream carries codec and frame size, true otherwise
+    bool VideoCapture::needsStreamInfo(AVFormatContext *fmt_ctx) const
+    {
+        if (!m_options.fast_open)
+            return true;
+        const int best = av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        const AVCodecParameters *par = best >= 0 ? fmt_ctx->streams[best]->codecpar : nullptr;
+        return !par || par->codec_id == AV_CODEC_ID_NONE || par->width <= 0 || par->height <= 0;
+    }
 
-        // Link buffersink to total combined filter chain
-        if (avfilter_link(last_filter, 0, m_buffersink_ctx, 0) < 0)
+    /// Start the I/O timeout for the next blocking demuxer call (no-op without timeout)
+    void VideoCapture::armIoDeadline()
+    {
+        if (m_io_timeout_ms > 0)
+            m_io_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_io_timeout_ms);
+    }
+
+    /// FFmpeg interrupt callback, polled by blocking I/O of the demuxer
+    /// @param opaque VideoCapture instance
+    /// @return 1 to abort the blocking call (deadline passed, capture closing or prefetch stopping), 0 to continue
+    int VideoCapture::interruptCallback(void *opaque)
+    {
+        const VideoCapture *self = static_cast<const VideoCapture *>(opaque);
+        if (self->ioAborted())
+            return 1;
+        return self->m_io_timeout_ms > 0 && std::chrono::steady_clock::now() > self->m_io_deadline;
+    }
+
+    /// Allocate the prefetch ring and start the background decode thread
+    /// @param depth Maximum number of decoded frames queued ahead of the reader
+    void VideoCapture::startPrefetch(int depth)
+    {
+        m_prefetch_ring.resize(static_cast<size_t>(depth));
+        for (auto &frame : m_prefetch_ring)
+            frame = allocFrame();
+        m_prefetch_head = 0;
+        m_prefetch_count = 0;
+        m_prefetch_stop = false;
+        m_prefetch_eos = false;
+        m_decode_eos = false;
+
+        // Pipelined conversion: decoding moves to its own thread, the prefetch thread only converts
+        // Frames cycle between the free list, the decoded queue and the converting thread (one at a time)
+        if (m_options.convert_threads > 0)
         {
-            return false;
+            m_decoded_free.resize(DECODED_QUEUE_DEPTH + 1);
+            for (auto &frame : m_decoded_free)
+                frame = allocFrame();
+            m_decode_thread = std::thread(&VideoCapture::decodeLoop, this);
         }
+        m_prefetch_thread = std::thread(&VideoCapture::prefetchLoop, this);
+    }
 
-        // Configure the graph
-        if (avfilter_graph_config(m_filter_graph, nullptr) < 0)
+    /// Stop the background decode thread (if running) and free all queued frames
+    void VideoCapture::stopPrefetch()
+    {
+        if (m_prefetch_thread.joinable())
         {
-            return false;
+            {
+                std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+                m_prefetch_stop = true;
+            }
+            m_prefetch_not_full.notify_all();
+            m_decoded_not_empty.notify_all();
+            m_decoded_not_full.notify_all();
+
+            // The thread may be blocked on network input, interrupt that too
+            // Own flag, so this does not clear an abort close() raised from another thread meanwhile
+            m_prefetch_abort = true;
+            m_prefetch_thread.join();
+            if (m_decode_thread.joinable())
+                m_decode_thread.join();
+            m_prefetch_abort = false;
+        }
+
+        // Waiters re-check and find the capture closed or the ring restarted
+        fireReadyCallbacks();
+
+        for (auto &frame : m_decoded_queue)
+            av_frame_free(&frame);
+        m_decoded_queue.clear();
+        for (auto &frame : m_decoded_free)
+            av_frame_free(&frame);
+        m_decoded_free.clear();
+
+        for (auto &frame : m_prefetch_ring)
+            av_frame_free(&frame);
+        m_prefetch_ring.clear();
+        m_prefetch_head = 0;
+        m_prefetch_count = 0;
+    }
+
+    /// Call the callbacks armed by notifyWhenReady() once; called without m_prefetch_mutex held, since a callback may block
+    /// (e.g. on the Python GIL) while its owner holds other locks
+    void VideoCapture::fireReadyCallbacks()
+    {
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+            if (m_ready_callbacks.empty())
+                return;
+            callbacks.swap(m_ready_callbacks);
         }
+        for (auto &callback : callbacks)
+            callback();
+    }
 
+    /// Prefetch thread body: decode frames into free ring slots until EOS, error or stop request
+    void VideoCapture::prefetchLoop()
+    {
+        if (!m_thread_affinity.empty())
+            setThreadAffinity(m_thread_affinity);
+        const size_t depth = m_prefetch_ring.size();
+        for (;;)
+        {
+            // Wait for a free slot
+            AVFrame *slot = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+                // Latest-frame reads never let the source wait: a full ring drops its oldest frame instead
+                if (m_options.latest_frame && m_prefetch_count == depth)
+                {
+                    av_frame_unref(m_prefetch_ring[m_prefetch_head]);
+                    m_prefetch_head = (m_prefetch_head + 1) % depth;
+                    m_prefetch_count--;
+                    m_stats.addDropped();
+                }
+                m_prefetch_not_full.wait(lock, [&]
+                                         { return m_prefetch_stop || m_prefetch_count < depth; });
+                if (m_prefetch_stop)
+                    break;
+                slot = m_prefetch_ring[(m_prefetch_head + m_prefetch_count) % depth];
+            }
+
+            // Decode (or convert a frame of the decode stage) outside the lock: the free slot is not visible to the reader until pushed
+            bool ok = m_decode_thread.joinable() ? convertQueuedFrame(slot) : readFrameDirect(slot);
+
+            {
+                std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+                if (ok)
+                    m_prefetch_count++;
+                else
+                    m_prefetch_eos = true;
+            }
+            m_prefetch_not_empty.notify_one();
+            fireReadyCallbacks();
+
+            if (!ok)
+                break;
+        }
+    }
+
+    /// Decode stage of pipelined conversion: decode frames into the decoded queue until EOS, error or stop request
+    void VideoCapture::decodeLoop()
+    {
+        if (!m_thread_affinity.empty())
+            setThreadAffinity(m_thread_affinity);
+        for (;;)
+        {
+            AVFrame *decoded = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+                m_decoded_not_full.wait(lock, [&]
+                                        { return m_prefetch_stop || m_decoded_queue.size() < DECODED_QUEUE_DEPTH; });
+                if (m_prefetch_stop)
+                    break;
+                decoded = m_decoded_free.back();
+                m_decoded_free.pop_back();
+            }
+
+            // The decoded frame leaves m_yuv_frame, its buffers are released or passed through once converted
+            const bool ok = decoded && nextDecodedFrame();
+            if (ok)
+                av_frame_move_ref(decoded, m_yuv_frame);
+
+            {
+                std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+                if (ok)
+                    m_decoded_queue.push_back(decoded);
+                else
+                {
+                    m_decoded_free.push_back(decoded);
+                    m_decode_eos = true;
+                }
+            }
+            m_decoded_not_empty.notify_one();
+
+            if (!ok)
+                break;
+        }
+    }
+
+    /// Conversion stage of pipelined conversion: convert the oldest frame of the decode stage into dst_frame
+    /// @param dst_frame Free ring slot, see readFrameDirect()
+    /// @return true on success, false when the decode stage reached EOS or conversion failed
+    bool VideoCapture::convertQueuedFrame(AVFrame *dst_frame)
+    {
+        AVFrame *decoded = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+            m_decoded_not_empty.wait(lock, [&]
+                                     { return m_prefetch_stop || m_decode_eos || !m_decoded_queue.empty(); });
+            if (m_decoded_queue.empty())
+                return false;
+            decoded = m_decoded_queue.front();
+            m_decoded_queue.pop_front();
+        }
+        m_decoded_not_full.notify_one();
+
+        const bool ok = convertDecodedFrame(decoded, dst_frame);
+        av_frame_unref(decoded);
+        {
+            std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+            m_decoded_free.push_back(decoded);
+        }
+        return ok;
+    }
+
+    /// Pop the next decoded frame produced by the prefetch thread
+    /// @param dst_frame Pointer to an AVFrame; any buffer it holds is replaced by the prefetched frame buffer
+    /// @return true on success, false on EOS or error
+    bool VideoCapture::readFramePrefetched(AVFrame *dst_frame)
+    {
+        if (!isOpened() || !dst_frame)
+            return false;
+
+        {
+            std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+            m_prefetch_not_empty.wait(lock, [&]
+                                      { return m_prefetch_count > 0 || m_prefetch_eos; });
+            if (m_prefetch_count == 0)
+                return false;
+
+            // Latest-frame reads drop the stale frames queued before the newest one
+            if (m_options.latest_frame)
+            {
+                for (; m_prefetch_count > 1; m_prefetch_count--)
+                {
+                    av_frame_unref(m_prefetch_ring[m_prefetch_head]);
+                    m_prefetch_head = (m_prefetch_head + 1) % m_prefetch_ring.size();
+                    m_stats.addDropped();
+                }
+            }
+
+            // Hand the ready frame over to the caller, leaving an empty slot for the prefetch thread
+            AVFrame *slot = m_prefetch_ring[m_prefetch_head];
+            av_frame_unref(dst_frame);
+            av_frame_move_ref(dst_frame, slot);
+            m_prefetch_head = (m_prefetch_head + 1) % m_prefetch_ring.size();
+            m_prefetch_count--;
+        }
+        m_prefetch_not_full.notify_one();
         return true;
     }
 
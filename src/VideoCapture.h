@@ -10,66 +10,305 @@
 extern "C"
 {
 #include <libavcodec/avcodec.h>
-#include <libavfilter/avfilter.h>
 #include <libavformat/avformat.h>
-#include <libavfilter/buffersink.h>
-#include <libavfilter/buffersrc.h>
+#include <libavutil/buffer.h>
 #include <libavutil/frame.h>
+#include <libavutil/hwcontext.h>
 #include <libavutil/opt.h>
 #include <libswscale/swscale.h>
 }
 
+#include "CaptureStats.h"
+#include "ColorConvert.h"
+#include "FrameIndex.h"
+#include "MemoryInput.h"
+#include "TensorConvert.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace DG
 {
+    /// VideoCapture properties beyond the OpenCV ones (cv::VideoCaptureProperties), read with get()
+    enum VideoCaptureExtraProperties
+    {
+        CAP_PROP_RECONNECT_COUNT = 1000, //!< (read-only) Number of times the source was reconnected since open
+        CAP_PROP_PACKETS_READ = 1001,    //!< (read-only) Video packets read since open (-1 if statistics are compiled out, as for all below)
+        CAP_PROP_BYTES_READ = 1002,      //!< (read-only) Bytes of all packets read from the source since open
+        CAP_PROP_FRAMES_DECODED = 1003,  //!< (read-only) Frames decoded since open, including frames skipped by subsampling and seeks
+        CAP_PROP_FRAMES_DROPPED = 1004,  //!< (read-only) Decoded frames not returned: skipped by frame_step / target_fps or stale with latest_frame
+        CAP_PROP_FRAMES_CONVERTED = 1005, //!< (read-only) Output frames converted since open
+        CAP_PROP_DEMUX_MSEC = 1006,      //!< (read-only) Total time spent reading packets (I/O, demuxing, reconnecting) in milliseconds
+        CAP_PROP_DECODE_MSEC = 1007,     //!< (read-only) Total time spent decoding in milliseconds
+        CAP_PROP_CONVERT_MSEC = 1008,    //!< (read-only) Total time spent converting in milliseconds (download, renditions, scaling, tensor)
+        CAP_PROP_COLORSPACE = 1009,      //!< (read-only) Colorspace tag of the decoded frames (AVColorSpace: 1 = BT.709, 2 = unspecified, 9 = BT.2020, ...)
+        CAP_PROP_COLOR_RANGE = 1010,     //!< (read-only) Sample range of the decoded frames (AVColorRange: 1 = limited, 2 = full, JPEG pixel formats report full)
+    };
+
+    AVFrame *allocFrame();     //!< av_frame_alloc() counted by allocationCount()
+    AVPacket *allocPacket();   //!< av_packet_alloc() counted by allocationCount()
+    int64_t allocationCount(); //!< Number of frames and packets allocated by the library so far (steady-state reads allocate none)
+
+    /// Additional output converted from the same decoded frame as the main output, see VideoCaptureOptions::renditions
+    struct RenditionSpec
+    {
+        int width = 0;          //!< Output width (0 = decoded width, no resize)
+        int height = 0;         //!< Output height (0 = decoded height, no resize)
+        bool letterbox = true;  //!< Keep the aspect ratio, centered with black borders; false stretches to width x height
+        AVPixelFormat pixel_format = AV_PIX_FMT_BGR24; //!< BGR24, RGB24, GRAY8, NV12 or YUV420P
+    };
+
+    constexpr int MAX_RENDITIONS = 8; //!< Maximum number of VideoCaptureOptions::renditions
+
+    /// Open-time options for VideoCapture
+    struct VideoCaptureOptions
+    {
+        int target_width = 0;       //!< Target width for resized output (0 = no resize)
+        int target_height = 0;      //!< Target height for resized output (0 = no resize)
+        AVPixelFormat pixel_format = AV_PIX_FMT_BGR24; //!< Output pixel format: BGR24, RGB24, GRAY8, NV12 or YUV420P (must stay BGR24 for tensor and device output)
+        int prefetch = 0;           //!< Number of frames decoded ahead on a background thread (0 = decode synchronously in readFrame)
+        std::string hw_device;      //!< Hardware decoder as "type[:device]", e.g. "cuda", "vaapi:/dev/dri/renderD128" (empty = CPU decoding)
+        bool device_output = false; //!< Return decoded hardware frames as-is, left in device memory (requires hw_device, no resize)
+        TensorFormat tensor;        //!< Model-ready tensor output instead of BGR24 frames (tensor.enabled = false: BGR24)
+        bool frame_index = false;   //!< Keep a keyframe index in a sidecar file: loaded at open (skipping stream probing), built by the first sequential pass or buildIndex()
+        std::string index_path;     //!< Sidecar file of the frame index (empty = filename + ".dgidx")
+        int frame_step = 1;         //!< Return every frame_step-th decoded frame; skipped frames are neither downloaded nor converted
+        double target_fps = 0;      //!< Return the first frame at or after each 1 / target_fps interval, by timestamp (0 = every frame)
+        AVDiscard skip_frame = AVDISCARD_DEFAULT; //!< Frames dropped by the decoder itself: AVDISCARD_NONREF (non-reference frames) or AVDISCARD_NONKEY (keyframes only)
+        bool live = false;          //!< Low-latency live source (RTSP/RTMP/HLS): no demuxer buffering, short probing, slice threading only, low-delay decoding
+        std::string rtsp_transport; //!< RTSP lower transport, e.g. "tcp" or "udp" (empty = FFmpeg default)
+        int timeout_ms = 0;         //!< Abort blocking network I/O after this many milliseconds without data (0 = none, 5000 for live sources)
+        bool latest_frame = false;  //!< Reads return the newest decoded frame, dropping stale ones (enables prefetch of at least 2 frames)
+        int reconnect_attempts = 0; //!< Reopen attempts after the source fails or stalls, per outage (0 = none, -1 = unlimited); implies a 5 s stall timeout
+        int reconnect_delay_ms = 500; //!< Delay before the first reopen attempt of an outage, doubled per failed attempt (from at least 100 ms) up to 10 s
+        int decoder_threads = 0;    //!< Decoder threads (0 = one per CPU core); VideoCaptureGroup sets the default to share cores between streams
+        int thread_type = 0;        //!< Decoder threading model: FF_THREAD_FRAME, FF_THREAD_SLICE or both (0 = both, slice only for live sources); frame threading delays output by one frame per thread
+        std::vector<int> cpu_affinity; //!< CPUs the threads of the capture run on: decoder, prefetch, decode stage and swscale slice threads (empty = any; Linux and Windows)
+        int numa_node = -1;         //!< Run those threads on the CPUs of this NUMA node, intersected with cpu_affinity if both are set (-1 = any; Linux and Windows)
+        int convert_threads = 0;    //!< Pipelined conversion: frame N is converted while frame N+1 decodes, swscale slice-threaded over this many threads (0 = convert after decoding; implies prefetch >= 2)
+        int crop_x = 0;             //!< Left edge of the region of interest in decoded pixels
+        int crop_y = 0;             //!< Top edge of the region of interest in decoded pixels
+        int crop_width = 0;         //!< Width of the region of interest, only its pixels are converted and resized (0 = up to the right edge)
+        int crop_height = 0;        //!< Height of the region of interest (0 = up to the bottom edge); set both sizes or none
+        int64_t probesize = 0;      //!< Bytes read to detect the format and probe streams (0 = FFmpeg default, 32 KB for live sources)
+        int analyze_duration_ms = 0; //!< Stream duration analyzed while probing, in milliseconds (0 = FFmpeg default, 500 ms for live sources)
+        std::string input_format;   //!< Container format name skipping format detection, e.g. "mp4", "matroska", "h264" (empty = detect)
+        bool fast_open = false;     //!< Skip stream probing (decoding ahead) when the header carries the video codec parameters, as in MP4 and MKV
+        std::vector<RenditionSpec> renditions; //!< Extra outputs of the whole decoded frame (crop applies to the main output only), read with renditionFrame(); not with device_output
+        bool memory_map = false;    //!< Demux a local file from a read-only memory mapping instead of file reads (sources that cannot be mapped are read as usual)
+        int lowres = 0;             //!< Decoder-side downscale by 2^lowres for codecs that support it (MJPEG, MPEG-1/2/4, H.263, DV); -1 = largest factor not below the resize target (0 = full resolution)
+    };
+
     /// C++ VideoCapture class following OpenCV-like interface for video reading using FFmpeg
     /// Exposed to the user via Python bindings in python/video_capture_bindings.cpp
+    ///
+    /// Thread safety: public methods may be called from any thread and are serialized per object, so one capture
+    /// read from several threads hands out each frame once. For parallel decoding use one capture per thread.
+    /// close() from another thread interrupts a read or open blocked on network input before taking over the object.
     class VideoCapture
     {
     public:
         VideoCapture() = default;
         explicit VideoCapture(const char *filename);
         explicit VideoCapture(const char *filename, int target_width, int target_height);
+        explicit VideoCapture(const char *filename, const VideoCaptureOptions &options);
         ~VideoCapture();
 
         bool open(const char *filename, int target_width = 0, int target_height = 0);
+        bool open(const char *filename, const VideoCaptureOptions &options);
+        bool openBuffer(const uint8_t *data, size_t size, const VideoCaptureOptions &options = VideoCaptureOptions(),
+                        std::shared_ptr<const void> owner = nullptr); //!< Open a media file held in memory, data must stay valid until close() (owner is released then)
+        bool reopen(const char *filename); //!< Switch to the next segment of a playlist, keeping decoder and conversion state if its stream parameters match
         void close();
+        void interrupt(); //!< Interrupt input blocked in another thread ahead of close(), which clears the request
         bool isOpened() const;
 
         double get(int propId) const;
+        bool set(int propId, double value);
+        bool buildIndex(); //!< Scan the file for a frame index making position seeks direct, saved to the sidecar with frame_index
+        double ptsToMsec(int64_t pts) const; //!< Convert a frame PTS in video stream time base to milliseconds
+
+        const VideoCaptureOptions &options() const { return m_options; }
+        std::unique_lock<std::recursive_mutex> lockCalls() const { return std::unique_lock<std::recursive_mutex>(m_call_mutex); } //!< Hold the call lock across several calls, e.g. a read and the output accessors describing its frame
 
-        int outputWidth() const { return m_target_width > 0 ? m_target_width : m_width; }
-        int outputHeight() const { return m_target_height > 0 ? m_target_height : m_height; }
+        int outputWidth() const { return m_target_width > 0 && m_target_height > 0 ? m_target_width : m_crop_width; }
+        int outputHeight() const { return m_target_width > 0 && m_target_height > 0 ? m_target_height : m_crop_height; }
+        int outputRowBytes() const; //!< Size in bytes of one packed output row (first image plane, tensor row of one channel plane for NCHW)
+        int outputRows() const;     //!< Number of output rows per frame (outputHeight(), 3/2 of it for NV12/YUV420P, times 3 for NCHW tensors)
 
         bool readFrame(AVFrame *dst);
+        int tryReadFrame(AVFrame *dst);                            //!< Read a frame only if one is ready: 1 = read, 0 = none ready yet (prefetch only), -1 = EOS or error
+        bool notifyWhenReady(std::function<void()> callback);      //!< Call callback once, on the prefetch thread, when the next frame is ready or prefetch stops
+        bool readFrameInto(uint8_t *data, int linesize, int64_t *pts = nullptr);
+        int readFrames(uint8_t *buffer, int count, int64_t *pts = nullptr);
+        static const AVFrame *renditionFrame(const AVFrame *frame, int index); //!< Rendition index of a frame read with renditions (nullptr if it has none)
+        const CaptureStats &stats() const { return m_stats; } //!< Per-stage counters and latencies since open, updated while reading (all zero if compiled out)
+        void resetStats() { m_stats.reset(); }                 //!< Restart the counters, e.g. at the start of a measurement window
+        void addDroppedFrames(uint64_t n = 1) { m_stats.addDropped(n); } //!< Count frames read but dropped by the consumer, e.g. a group queue evicting stale frames
 
     private:
         // Common functions and variables
-        bool receiveAndConvert(AVFrame *dst);
+        bool decodeFrame();                                  //!< Decode the next video frame into m_yuv_frame, without conversion
+        bool nextDecodedFrame();                             //!< Decode the next frame to return into m_yuv_frame (pending seek target, subsampling applied)
+        bool convertDecodedFrame(AVFrame *decoded, AVFrame *dst); //!< Hand over or convert a decoded frame into dst
+        bool updateSwsContext(AVPixelFormat src_format, AVColorSpace colorspace, AVColorRange range); //!< Create the swscale context for a source format and colorimetry unless the current one matches
+        bool scaleInto(const AVFrame *src, const AVFrame *dst); //!< Scale the crop region of src into the letterbox interior of dst (slice-threaded with convert_threads > 1)
+        bool seek(const FrameIndex::SeekPoint &point, int64_t frame_index, int64_t tolerance); //!< Seek to the preceding keyframe and decode-and-discard up to the target frame
+        bool seekTo(const FrameIndex::SeekPoint &point, int64_t frame_index, int64_t tolerance, bool &moved); //!< seek() without prefetch restart and position restore
+        bool restorePosition(int64_t frame_count, int64_t last_pts, bool unread); //!< Return to a read position after the demuxer moved away, or mark the end of the stream
+        FrameIndex::StreamInfo indexStreamInfo() const;      //!< Parameters of the opened video stream stored with the frame index
+        int64_t frameNumberAt(int64_t pts, int64_t fallback) const; //!< Frame number presented at pts (from the index or the frame rate)
+        bool sampleDecodedFrame();                           //!< Apply frame_step / target_fps to the frame in m_yuv_frame, false if it is skipped
+        int64_t nextSamplePts() const;                       //!< Timestamp of the next target_fps sampling instant
+        AVRational frameRate() const;                        //!< Nominal frame rate of the video stream ({0, 1} if unknown)
+        bool convertFrame(const AVFrame *src, AVFrame *dst); //!< Convert decoded frame to BGR24 or tensor output, resized into the letterbox interior of dst
+        static void clearLetterboxBorder(AVFrame *dst, int scaled_width, int scaled_height, int pad_x, int pad_y); //!< Fill the border around the scaled image with black
+        bool passthroughFrame(AVFrame *src, AVFrame *dst);   //!< Move a decoded frame already in output format and size into dst, skipping conversion
+        bool allocOutputFrame(AVFrame *dst); //!< Attach a pooled output buffer of outputRows() x outputRowBytes() to an empty frame
+        void fillOutputPlanes(uint8_t *data, int linesize, uint8_t *planes[4], int linesizes[4]) const; //!< Plane pointers of an output image stored in one buffer of outputRows() rows
+        void copyOutputFrame(const AVFrame *src, uint8_t *data, int linesize) const;                   //!< Copy an output frame into one buffer of outputRows() rows
+        static void planesAt(const AVFrame *frame, int x, int y, uint8_t *data[4]);                    //!< Plane pointers of a frame at pixel position (x, y)
 
+        VideoCaptureOptions m_options;                                                     //!< Options the video was opened with
         AVFormatContext *m_fmt_ctx = nullptr;                                              //!< FFmpeg format context for input video
         AVCodecContext *m_codec_ctx = nullptr;                                             //!< FFmpeg codec context for decoding video frames
         SwsContext *m_sws_ctx = nullptr;                                                   //!< Swscale context for pixel format conversion
         AVFrame *m_yuv_frame = nullptr;                                                    //!< Internal frame for decoded YUV data
+        AVPacket *m_packet = nullptr;                                                      //!< Internal packet reused by every demuxer read
+        AVFrame *m_staging_frame = nullptr;                                                //!< Internal frame receiving buffers handed out by prefetched reads before copying into caller memory
+        AVFrame *m_caller_frame = nullptr;                                                 //!< Internal frame shell pointing at caller memory in readFrameInto (holds no buffer reference)
+        AVBufferPool *m_frame_pool = nullptr;                                              //!< Pool of output buffers, buffers return here when the last frame reference is released
+        int m_output_linesize = 0;                                                         //!< Linesize in bytes of pooled output buffers (images: outputRowBytes(), 32-byte aligned; tensor: outputRowBytes())
         int m_video_stream_index = -1;                                                     //!< Index of the video stream in the input file (file contains multiple streams like audio/subtitles)
-        int m_width = 0;                                                                   //!< Video width in pixels (from codec parameters)
-        int m_height = 0;                                                                  //!< Video height in pixels (from codec parameters)
+        int m_width = 0;                                                                   //!< Video width in pixels (from codec parameters, before lowres)
+        int m_height = 0;                                                                  //!< Video height in pixels (from codec parameters, before lowres)
         AVPixelFormat m_src_pix_fmt = AV_PIX_FMT_NONE;                                     //!< Source pixel format of the video frames (from codec parameters)
+        AVPixelFormat m_convert_pix_fmt = AV_PIX_FMT_BGR24;                                //!< Pixel format swscale converts to (output pixel format, or planar GBRP for tensor output)
         bool m_flush_pending = false;                                                      //!< Flag to indicate if we've sent the flush packet to the decoder after reaching end of file
+        FrameIndex m_index;                                                                //!< Frame index for direct seeks (empty if not built or loaded)
+        std::string m_filename;                                                            //!< Source the video was opened from
+        std::string m_index_path;                                                          //!< Sidecar file of the frame index (empty without frame_index)
+        int m_step_phase = 0;                                                              //!< Decoded frames since the last frame_step sample, modulo frame_step
+        AVRational m_sample_rate = {0, 1};                                                 //!< target_fps as a rational ({0, 1} = disabled)
+        int64_t m_sample_origin = AV_NOPTS_VALUE;                                          //!< Timestamp of the first target_fps sample of the current grid
+        int64_t m_sample_count = 0;                                                        //!< Number of target_fps samples taken on the current grid
+        bool m_seek_frame_pending = false;                                                 //!< Set by seek() when m_yuv_frame holds the target frame, which the next read returns
         int64_t m_frame_count = 0;                                                         //!< Current frame position (number of frames read so far)
         int64_t m_last_pts = AV_NOPTS_VALUE;                                               //!< PTS of the last decoded frame
-        bool (VideoCapture::*m_readFrameImpl)(AVFrame *) = &VideoCapture::readFrameDirect; //!< Pointer to the current read frame implementation (direct or filtered)
-
-        // Functions only used WITHOUT filter graph
-        bool readFrameDirect(AVFrame *dst); //!< Read frame without resizing, direct YUV->BGR conversion
-
-        // Functions + variables for filter graph, used only when resizing+padding is enabled
-        bool initFilterGraph();                      //!< Initialize FFmpeg filter graph for resizing and format conversion
-        bool readFrameFiltered(AVFrame *dst);        //!< Read frame with resizing and format conversion
-        AVFilterGraph *m_filter_graph = nullptr;     //!< FFmpeg filter graph for resizing and format conversion
-        AVFilterContext *m_buffersrc_ctx = nullptr;  //!< Buffer source filter context (input to the graph)
-        AVFilterContext *m_buffersink_ctx = nullptr; //!< Buffer sink filter context (output from the graph)
-        int m_target_width = 0;                      //!< Target width for resized output
-        int m_target_height = 0;                     //!< Target height for resized output
+        bool m_position_unread = false;                                                    //!< The frame at m_last_pts was positioned by a seek and is not read yet
+        bool (VideoCapture::*m_readFrameImpl)(AVFrame *) = &VideoCapture::readFrameDirect; //!< Pointer to the current read frame implementation (direct or prefetched)
+        CaptureStats m_stats;                                                              //!< Per-stage counters, written by the thread running each stage
+
+        // Functions + variables for decoding + conversion on the caller's (or prefetch) thread
+        bool readFrameDirect(AVFrame *dst); //!< Read frame with single-pass YUV->BGR conversion (+ letterbox resize)
+        int m_target_width = 0;             //!< Target width for resized output
+        int m_target_height = 0;            //!< Target height for resized output
+        int m_scaled_width = 0;             //!< Width of the aspect-preserving scaled image inside the output frame
+        int m_scaled_height = 0;            //!< Height of the aspect-preserving scaled image inside the output frame
+        int m_pad_x = 0;                    //!< Left letterbox border in pixels
+        int m_pad_y = 0;                    //!< Top letterbox border in pixels
+        int m_crop_x = 0;                   //!< Left edge of the converted region of the decoded frame (decoded pixels)
+        int m_crop_y = 0;                   //!< Top edge of the converted region of the decoded frame (decoded pixels)
+        int m_crop_width = 0;               //!< Width of the converted region (the decoded width without crop)
+        int m_crop_height = 0;              //!< Height of the converted region (the decoded height without crop)
+        int m_lowres = 0;                   //!< Decoder downscale shift in effect: decoded frames and the crop region are 2^m_lowres times smaller
+        std::vector<int> m_thread_affinity; //!< CPUs of the threads created by the capture, from cpu_affinity and numa_node (empty = not pinned)
+
+        // Functions + variables for renditions, used only when renditions are requested
+        /// State of one rendition of VideoCaptureOptions::renditions
+        struct Rendition
+        {
+            RenditionSpec spec;                              //!< Requested output
+            int width = 0;                                   //!< Output width in pixels
+            int height = 0;                                  //!< Output height in pixels
+            int scaled_width = 0;                            //!< Width of the scaled image inside the output frame
+            int scaled_height = 0;                           //!< Height of the scaled image inside the output frame
+            int pad_x = 0;                                   //!< Left border in pixels
+            int pad_y = 0;                                   //!< Top border in pixels
+            SwsContext *sws_ctx = nullptr;                   //!< Conversion from the decoded format (created with the first frame)
+            AVPixelFormat sws_src_pix_fmt = AV_PIX_FMT_NONE; //!< Source pixel format sws_ctx converts from
+            AVBufferPool *pool = nullptr;                    //!< Pool of output buffers
+        };
+        AVBufferRef *convertRenditions(const AVFrame *src);                        //!< Convert a decoded frame into a pooled set of rendition frames
+        bool convertRendition(Rendition &rendition, const AVFrame *src, AVFrame *dst); //!< Convert a decoded frame into one rendition frame
+        void freeRenditions();                                                     //!< Free rendition contexts and pools
+        std::vector<Rendition> m_renditions;       //!< Renditions converted from every decoded frame
+        AVBufferPool *m_rendition_set_pool = nullptr; //!< Pool of rendition sets attached to output frames as opaque_ref
+
+        // Variables for tensor output, used only when tensor.enabled is set
+        TensorConverter m_tensor_converter; //!< Fused normalize + layout + type conversion kernels selected for the running CPU
+        AVFrame *m_tensor_frame = nullptr;  //!< Internal planar GBRP frame of output size swscale writes before tensor conversion (letterbox border stays black)
+
+        // Variables for specialized color conversion, used for unscaled YUV -> BGR24 / RGB24 output
+        ColorConverter m_color_converter; //!< Kernel for the current source format and colorimetry, selected at open and on change (invalid = swscale)
+        bool m_direct_color = false;      //!< Output is converted without scaling, tensor output or slice threading, so the kernels may apply
+
+        // Functions + variables for hardware decoding, used only when hw_device is set
+        bool initHwDecoder(const AVCodec *decoder, const std::string &hw_device);     //!< Create hardware device context and attach it to m_codec_ctx
+        AVFrame *transferDecodedFrame(AVFrame *decoded);                              //!< Return decoded frame in system memory, downloading it from the GPU if needed
+        static AVPixelFormat getHwFormat(AVCodecContext *ctx, const AVPixelFormat *fmts); //!< FFmpeg get_format callback selecting m_hw_pix_fmt
+        AVBufferRef *m_hw_device_ctx = nullptr;                                       //!< Hardware device context (nullptr for CPU decoding)
+        AVPixelFormat m_hw_pix_fmt = AV_PIX_FMT_NONE;                                 //!< Pixel format of frames decoded on the hardware device
+        AVFrame *m_sw_frame = nullptr;                                                //!< Internal frame for decoded data downloaded to system memory
+
+        // Functions + variables for background prefetch, used only when prefetch > 0
+        void startPrefetch(int depth);                  //!< Allocate the frame ring and start the prefetch thread
+        void stopPrefetch();                            //!< Stop the prefetch thread and free all queued frames
+        void prefetchLoop();                            //!< Prefetch thread body: decode frames into the ring until EOS or stop
+        bool readFramePrefetched(AVFrame *dst);         //!< Pop the next ready frame from the ring (the newest one with latest_frame)
+        std::thread m_prefetch_thread;                  //!< Background thread driving readFrameDirect
+        std::mutex m_prefetch_mutex;                    //!< Protects ring indices and state flags below
+        std::condition_variable m_prefetch_not_empty;   //!< Signaled when a frame is pushed or the thread finished
+        std::condition_variable m_prefetch_not_full;    //!< Signaled when a frame is popped or stop is requested
+        std::vector<AVFrame *> m_prefetch_ring;         //!< Bounded ring of decoded BGR24 frames
+        size_t m_prefetch_head = 0;                     //!< Index of the oldest ready frame in the ring
+        size_t m_prefetch_count = 0;                    //!< Number of ready frames in the ring
+        bool m_prefetch_stop = false;                   //!< Set by stopPrefetch() to make the thread exit
+        bool m_prefetch_eos = false;                    //!< Set by the thread when decoding reached EOS or error
+        std::vector<std::function<void()>> m_ready_callbacks; //!< One-shot callbacks armed by notifyWhenReady(), fired outside the lock
+        void fireReadyCallbacks();                      //!< Take the armed callbacks under the lock and call them after unlocking
+
+        // Functions + variables for pipelined conversion, used only when convert_threads > 0 (the prefetch thread then only converts)
+        void decodeLoop();                              //!< Decode thread body: decode frames into the decoded queue until EOS or stop
+        bool convertQueuedFrame(AVFrame *dst);          //!< Convert the oldest frame of the decoded queue into dst
+        std::thread m_decode_thread;                    //!< Decode stage thread feeding the prefetch (conversion) thread
+        std::condition_variable m_decoded_not_empty;    //!< Signaled when a decoded frame is queued or decoding finished
+        std::condition_variable m_decoded_not_full;     //!< Signaled when a decoded frame is taken or stop is requested
+        std::deque<AVFrame *> m_decoded_queue;          //!< Decoded frames waiting for conversion (protected by m_prefetch_mutex)
+        std::vector<AVFrame *> m_decoded_free;          //!< Empty frames the decode stage decodes into, recycled after conversion (protected by m_prefetch_mutex)
+        bool m_decode_eos = false;                      //!< Set by the decode thread when decoding reached EOS or error
+        AVFrame *m_sws_view_frame = nullptr;            //!< Frame shell of the letterbox interior for slice-threaded scaling (convert_threads > 1)
+        AVFrame *m_sws_src_view_frame = nullptr;        //!< Frame referencing the cropped region of the source for slice-threaded scaling (convert_threads > 1 with crop)
+        AVPixelFormat m_sws_src_pix_fmt = AV_PIX_FMT_NONE; //!< Source pixel format m_sws_ctx converts from
+        AVColorSpace m_sws_colorspace = AVCOL_SPC_UNSPECIFIED; //!< Source colorspace m_sws_ctx converts from
+        AVColorRange m_sws_color_range = AVCOL_RANGE_UNSPECIFIED; //!< Source range m_sws_ctx converts from
+
+        // Functions + variables for interrupting blocking demuxer I/O
+        bool openSource(const VideoCaptureOptions &options);   //!< Open m_filename or m_memory_input once the capture is closed
+        bool resolveThreadAffinity(const VideoCaptureOptions &options); //!< Set m_thread_affinity from cpu_affinity and numa_node
+        bool openInput(AVFormatContext **fmt_ctx);             //!< Open the input with the interrupt callback and live source options
+        bool needsStreamInfo(AVFormatContext *fmt_ctx) const;       //!< Whether an opened input needs stream probing (always without fast_open)
+        bool reconnectInput();                                 //!< Reopen a failed source with backoff, keeping decoder and conversion state
+        void armIoDeadline();                                  //!< Start the I/O timeout for the next blocking demuxer call
+        static int interruptCallback(void *opaque);            //!< FFmpeg interrupt callback: abort on deadline or stop request
+        int m_io_timeout_ms = 0;                               //!< I/O timeout in milliseconds (0 = none)
+        std::chrono::steady_clock::time_point m_io_deadline;   //!< Deadline of the current blocking demuxer call
+        std::atomic<bool> m_io_abort{false};                   //!< Set by close() to interrupt a read blocked on input in another thread, cleared by close() only
+        std::atomic<bool> m_prefetch_abort{false};             //!< Set by stopPrefetch() to interrupt the prefetch thread blocked on input
+        bool ioAborted() const { return m_io_abort || m_prefetch_abort; } //!< Blocking input is to be interrupted
+        std::atomic<int> m_reconnect_count{0};                 //!< Successful reconnects since open (incremented on the decoding thread)
+        std::unique_ptr<MemoryInput> m_memory_input;           //!< Buffer or mapped file demuxed instead of m_filename (nullptr = protocol input)
+        AVIOContext *m_memory_io = nullptr;                    //!< Reader of m_memory_input attached to m_fmt_ctx
+
+        mutable std::recursive_mutex m_call_mutex; //!< Serializes public methods called from different threads (recursive: public methods call each other)
     };
 
 } // namespace DG
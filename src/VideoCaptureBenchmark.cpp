@@ -0,0 +1,515 @@
+//
+// Native benchmark and regression harness of the VideoCapture read paths
+//
+// Copyright 2026 DeGirum Corporation
+//
+// Usage: video_capture_benchmark [options] video...
+//
+// Every video is read with every combination of output size, read mode and decoder thread count. Each case is run
+// --repeat times and the median run is reported as JSON in the Google Benchmark layout ("context" and "benchmarks",
+// real_time / cpu_time in ns per frame), so its compare.py can diff two result files. With --baseline, cases slower
+// than the baseline by more than --max-regression fail the run.
+//
+
+#include "VideoCapture.h"
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace DG;
+
+namespace
+{
+    const int BATCH_SIZE = 8;     //!< Frames per readFrames() call of the batch mode
+    const int PREFETCH_DEPTH = 4; //!< Prefetch depth of the prefetch and pipelined modes
+
+    /// Read modes: how frames are requested from the capture
+    const char *const MODES[] = {
+        "direct",    // readFrame(), decode and convert on the calling thread
+        "prefetch",  // readFrame() with frames decoded ahead on the prefetch thread
+        "pipelined", // readFrame() with conversion overlapped with decoding (convert_threads)
+        "batch",     // readFrames() of BATCH_SIZE frames into one buffer
+        "into",      // readFrameInto() converting straight into a caller buffer
+        "tensor",    // readFrame() of NCHW float32 tensors
+        "yuv420p",   // readFrame() of YUV420P frames, no color conversion for YUV420P sources without resize
+    };
+
+    /// Command-line settings
+    struct Settings
+    {
+        std::vector<std::string> videos;
+        std::vector<std::pair<int, int>> sizes = {{0, 0}, {640, 640}}; //!< Output sizes (0x0 = native)
+        std::vector<std::string> modes;                                //!< Read modes (empty = all)
+        std::vector<int> threads = {0};                                //!< Decoder thread counts
+        int64_t max_frames = 0;                                        //!< Frames timed per run (0 = whole video)
+        int repeat = 3;                                                //!< Runs per case, the median is reported
+        std::string output;                                            //!< JSON output file (empty = stdout)
+        std::string baseline;                                          //!< JSON result file compared against (empty = none)
+        double max_regression = 0.10;                                  //!< Allowed ns/frame increase over the baseline
+    };
+
+    /// One benchmark case
+    struct Case
+    {
+        std::string video;
+        std::string codec;
+        int width;
+        int height;
+        std::string mode;
+        int threads;
+
+        std::string name() const
+        {
+            const size_t slash = video.find_last_of("/\\");
+            std::ostringstream s;
+            s << (slash == std::string::npos ? video : video.substr(slash + 1)) << '/' << codec << '/';
+            if (width > 0 && height > 0)
+                s << width << 'x' << height;
+            else
+                s << "native";
+            s << '/' << mode << "/threads:" << threads;
+            return s.str();
+        }
+    };
+
+    /// Measurements of one run
+    struct Run
+    {
+        int64_t frames = 0;        //!< Frames read in the timed window
+        double wall_ns = 0;        //!< Elapsed time of the timed window
+        double cpu_ns = 0;         //!< Process CPU time (all threads) of the timed window
+        int64_t allocations = 0;   //!< Frames and packets allocated by the library in the timed window
+        double demux_ns = 0;       //!< Time spent demuxing, from the per-stage counters
+        double decode_ns = 0;      //!< Time spent decoding
+        double convert_ns = 0;     //!< Time spent converting
+        double decode_p99_us = 0;  //!< 99th percentile of the decode latency
+        double convert_p99_us = 0; //!< 99th percentile of the convert latency
+        uint64_t dropped = 0;      //!< Decoded frames not returned
+    };
+
+    double wallNs()
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /// Process CPU time of all threads in nanoseconds
+    double cpuNs()
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+            return 0;
+        const auto ticks = [](const FILETIME &t) { return (static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+        return static_cast<double>(ticks(kernel) + ticks(user)) * 100.0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+        const auto ns = [](const timeval &t) { return static_cast<double>(t.tv_sec) * 1e9 + static_cast<double>(t.tv_usec) * 1e3; };
+        return ns(usage.ru_utime) + ns(usage.ru_stime);
+#endif
+    }
+
+    /// Peak resident set size of the process so far in MiB
+    double peakRssMb()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return 0;
+        return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#ifdef __APPLE__
+        return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0); // bytes
+#else
+        return static_cast<double>(usage.ru_maxrss) / 1024.0; // KiB
+#endif
+#endif
+    }
+
+    /// Name of the codec of the best video stream of a file
+    /// @return Codec name, "unknown" if the file cannot be probed
+    std::string probeCodec(const std::string &video)
+    {
+        AVFormatContext *format = nullptr;
+        std::string codec = "unknown";
+        if (avformat_open_input(&format, video.c_str(), nullptr, nullptr) < 0)
+            return codec;
+        if (avformat_find_stream_info(format, nullptr) >= 0)
+        {
+            const int stream = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+            if (stream >= 0)
+                codec = avcodec_get_name(format->streams[stream]->codecpar->codec_id);
+        }
+        avformat_close_input(&format);
+        return codec;
+    }
+
+    /// Capture options of a case
+    VideoCaptureOptions caseOptions(const Case &c)
+    {
+        VideoCaptureOptions options;
+        options.target_width = c.width;
+        options.target_height = c.height;
+        options.decoder_threads = c.threads;
+        if (c.mode == "prefetch")
+            options.prefetch = PREFETCH_DEPTH;
+        else if (c.mode == "pipelined")
+        {
+            options.prefetch = PREFETCH_DEPTH;
+            options.convert_threads = 2;
+        }
+        else if (c.mode == "tensor")
+            options.tensor.enabled = true;
+        else if (c.mode == "yuv420p")
+            options.pixel_format = AV_PIX_FMT_YUV420P;
+        return options;
+    }
+
+    /// Open a capture for a case and time reading its frames
+    /// @param c Case to run
+    /// @param max_frames Frames to time (0 = up to the end of the video)
+    /// @param run Receives the measurements
+    /// @return false if the video cannot be opened or no frame was read
+    bool runCase(const Case &c, int64_t max_frames, Run &run)
+    {
+        VideoCapture capture;
+        if (!capture.open(c.video.c_str(), caseOptions(c)))
+            return false;
+        const int64_t limit = max_frames > 0 ? max_frames : INT64_MAX;
+        const size_t frame_size = static_cast<size_t>(capture.outputRows()) * static_cast<size_t>(capture.outputRowBytes());
+
+        AVFrame *frame = allocFrame();
+        if (!frame)
+            return false;
+
+        // Warm-up: the first frame includes decoder, scaler and buffer pool setup, which open-to-first-frame latency
+        // benchmarks measure separately
+        if (!capture.readFrame(frame))
+        {
+            av_frame_free(&frame);
+            return false;
+        }
+        av_frame_unref(frame);
+        std::vector<uint8_t> buffer(c.mode == "batch" ? BATCH_SIZE * frame_size : c.mode == "into" ? frame_size : 0);
+
+        capture.resetStats();
+        const int64_t allocations = allocationCount();
+        const double wall_start = wallNs();
+        const double cpu_start = cpuNs();
+
+        int64_t frames = 0;
+        if (c.mode == "batch")
+        {
+            while (frames < limit)
+            {
+                const int count = static_cast<int>(std::min<int64_t>(BATCH_SIZE, limit - frames));
+                const int n = capture.readFrames(buffer.data(), count);
+                frames += n;
+                if (n < count)
+                    break;
+            }
+        }
+        else if (c.mode == "into")
+        {
+            while (frames < limit && capture.readFrameInto(buffer.data(), capture.outputRowBytes()))
+                frames++;
+        }
+        else
+        {
+            while (frames < limit && capture.readFrame(frame))
+                frames++;
+        }
+
+        run.wall_ns = wallNs() - wall_start;
+        run.cpu_ns = cpuNs() - cpu_start;
+        run.allocations = allocationCount() - allocations;
+        run.frames = frames;
+
+        const CaptureStats &stats = capture.stats();
+        run.demux_ns = static_cast<double>(stats.demux_ns.load());
+        run.decode_ns = static_cast<double>(stats.decode.totalNs());
+        run.convert_ns = static_cast<double>(stats.convert.totalNs());
+        run.decode_p99_us = stats.decode.percentileUs(0.99);
+        run.convert_p99_us = stats.convert.percentileUs(0.99);
+        run.dropped = stats.frames_dropped.load();
+
+        av_frame_free(&frame);
+        capture.close();
+        return frames > 0;
+    }
+
+    std::string jsonString(const std::string &s)
+    {
+        std::string out = "\"";
+        for (const char ch : s)
+        {
+            if (ch == '"' || ch == '\\')
+            {
+                out += '\\';
+                out += ch;
+            }
+            else if (static_cast<unsigned char>(ch) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(ch)));
+                out += escaped;
+            }
+            else
+                out += ch;
+        }
+        return out + "\"";
+    }
+
+    /// One JSON object per line, so result files stay diffable and --baseline can read them back without a JSON parser
+    std::string resultJson(const Case &c, const Run &run, double peak_rss_mb)
+    {
+        const double frames = static_cast<double>(run.frames);
+        const double ns_per_frame = run.wall_ns / frames;
+        char numbers[768];
+        std::snprintf(numbers, sizeof(numbers),
+                      "\"run_type\": \"iteration\", \"iterations\": %lld, \"real_time\": %.1f, \"cpu_time\": %.1f, \"time_unit\": \"ns\", "
+                      "\"width\": %d, \"height\": %d, \"decoder_threads\": %d, \"fps\": %.2f, \"ns_per_frame\": %.1f, "
+                      "\"allocs_per_frame\": %.3f, \"peak_rss_mb\": %.1f, \"demux_ns_per_frame\": %.1f, \"decode_ns_per_frame\": %.1f, "
+                      "\"convert_ns_per_frame\": %.1f, \"decode_p99_us\": %.1f, \"convert_p99_us\": %.1f, \"frames_dropped\": %llu",
+                      static_cast<long long>(run.frames), ns_per_frame, run.cpu_ns / frames, c.width, c.height, c.threads,
+                      frames * 1e9 / run.wall_ns, ns_per_frame, static_cast<double>(run.allocations) / frames, peak_rss_mb,
+                      run.demux_ns / frames, run.decode_ns / frames, run.convert_ns / frames, run.decode_p99_us, run.convert_p99_us,
+                      static_cast<unsigned long long>(run.dropped));
+        return "{\"name\": " + jsonString(c.name()) + ", \"video\": " + jsonString(c.video) + ", \"codec\": " + jsonString(c.codec) +
+               ", \"mode\": " + jsonString(c.mode) + ", " + numbers + "}";
+    }
+
+    /// Read the ns/frame of every case of a result file written by this tool
+    /// @return Map of case names to ns/frame, empty if the file cannot be read
+    std::map<std::string, double> readBaseline(const std::string &path)
+    {
+        std::map<std::string, double> results;
+        std::ifstream file(path);
+        std::string line;
+        const std::string name_key = "{\"name\": \"";
+        const std::string time_key = "\"ns_per_frame\": ";
+        while (std::getline(file, line))
+        {
+            const size_t name = line.find(name_key);
+            const size_t time = line.find(time_key);
+            if (name == std::string::npos || time == std::string::npos)
+                continue;
+            const size_t begin = name + name_key.size();
+            const size_t end = line.find('"', begin);
+            if (end == std::string::npos)
+                continue;
+            results[line.substr(begin, end - begin)] = std::atof(line.c_str() + time + time_key.size());
+        }
+        return results;
+    }
+
+    std::vector<std::string> splitList(const std::string &list)
+    {
+        std::vector<std::string> items;
+        std::string item;
+        std::istringstream s(list);
+        while (std::getline(s, item, ','))
+            if (!item.empty())
+                items.push_back(item);
+        return items;
+    }
+
+    void printUsage(const char *program)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s [options] video...\n"
+                     "  --sizes WxH,...        output sizes, 0x0 = native (default 0x0,640x640)\n"
+                     "  --modes m,...          read modes: direct, prefetch, pipelined, batch, into, tensor, yuv420p (default all)\n"
+                     "  --threads n,...        decoder thread counts, 0 = one per core (default 0)\n"
+                     "  --frames N             frames timed per run, 0 = whole video (default 0)\n"
+                     "  --repeat N             runs per case, the median is reported (default 3)\n"
+                     "  --output FILE          write the JSON results to FILE (default stdout)\n"
+                     "  --baseline FILE        compare ns/frame against an earlier result file\n"
+                     "  --max-regression F     allowed slowdown over the baseline as a fraction (default 0.10)\n",
+                     program);
+    }
+
+    /// Parse the command line
+    /// @return false on invalid arguments
+    bool parseArgs(int argc, char **argv, Settings &settings)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0)
+            {
+                settings.videos.push_back(arg);
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            const std::string value = argv[++i];
+            if (arg == "--sizes")
+            {
+                settings.sizes.clear();
+                for (const auto &size : splitList(value))
+                {
+                    int width = 0, height = 0;
+                    if (std::sscanf(size.c_str(), "%dx%d", &width, &height) != 2 || width < 0 || height < 0)
+                        return false;
+                    settings.sizes.emplace_back(width, height);
+                }
+            }
+            else if (arg == "--modes")
+            {
+                settings.modes = splitList(value);
+                for (const auto &mode : settings.modes)
+                    if (std::find_if(std::begin(MODES), std::end(MODES), [&](const char *m) { return mode == m; }) == std::end(MODES))
+                        return false;
+            }
+            else if (arg == "--threads")
+            {
+                settings.threads.clear();
+                for (const auto &threads : splitList(value))
+                    settings.threads.push_back(std::atoi(threads.c_str()));
+            }
+            else if (arg == "--frames")
+                settings.max_frames = std::atoll(value.c_str());
+            else if (arg == "--repeat")
+                settings.repeat = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--output")
+                settings.output = value;
+            else if (arg == "--baseline")
+                settings.baseline = value;
+            else if (arg == "--max-regression")
+                settings.max_regression = std::atof(value.c_str());
+            else
+                return false;
+        }
+        if (settings.modes.empty())
+            settings.modes.assign(std::begin(MODES), std::end(MODES));
+        return !settings.videos.empty() && !settings.sizes.empty() && !settings.threads.empty();
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Settings settings;
+    if (!parseArgs(argc, argv, settings))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    av_log_set_level(AV_LOG_ERROR);
+    const std::map<std::string, double> baseline = settings.baseline.empty() ? std::map<std::string, double>() : readBaseline(settings.baseline);
+    if (!settings.baseline.empty() && baseline.empty())
+    {
+        std::fprintf(stderr, "Cannot read baseline results from %s\n", settings.baseline.c_str());
+        return 1;
+    }
+
+    std::vector<std::string> results;
+    int failures = 0;
+    int regressions = 0;
+    for (const auto &video : settings.videos)
+    {
+        const std::string codec = probeCodec(video);
+        for (const auto &size : settings.sizes)
+            for (const auto &mode : settings.modes)
+                for (const int threads : settings.threads)
+                {
+                    const Case c{video, codec, size.first, size.second, mode, threads};
+                    std::vector<Run> runs;
+                    for (int r = 0; r < settings.repeat; r++)
+                    {
+                        Run run;
+                        if (!runCase(c, settings.max_frames, run))
+                            break;
+                        runs.push_back(run);
+                    }
+                    if (runs.empty())
+                    {
+                        std::fprintf(stderr, "FAILED  %s: cannot open or read\n", c.name().c_str());
+                        failures++;
+                        continue;
+                    }
+
+                    // Median by ns/frame, robust against a run disturbed by other processes
+                    std::sort(runs.begin(), runs.end(), [](const Run &a, const Run &b) {
+                        return a.wall_ns / static_cast<double>(a.frames) < b.wall_ns / static_cast<double>(b.frames);
+                    });
+                    const Run &median = runs[runs.size() / 2];
+                    const double ns_per_frame = median.wall_ns / static_cast<double>(median.frames);
+                    results.push_back(resultJson(c, median, peakRssMb()));
+                    std::fprintf(stderr, "%-64s %9.1f fps %11.0f ns/frame\n", c.name().c_str(), 1e9 / ns_per_frame, ns_per_frame);
+
+                    const auto reference = baseline.find(c.name());
+                    if (reference != baseline.end() && reference->second > 0 && ns_per_frame > reference->second * (1.0 + settings.max_regression))
+                    {
+                        std::fprintf(stderr, "REGRESSION  %s: %.0f ns/frame, baseline %.0f ns/frame (+%.1f%%)\n", c.name().c_str(), ns_per_frame,
+                                     reference->second, (ns_per_frame / reference->second - 1.0) * 100.0);
+                        regressions++;
+                    }
+                }
+    }
+
+    // Context in the Google Benchmark layout
+    char date[32] = "";
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    std::ostringstream json;
+    json << "{\n  \"context\": {\"date\": \"" << date << "\", \"executable\": " << jsonString(argv[0])
+         << ", \"num_cpus\": " << std::thread::hardware_concurrency() << ", \"library_build_type\": "
+#ifdef NDEBUG
+         << "\"release\""
+#else
+         << "\"debug\""
+#endif
+         << ", \"capture_stats\": " << (CaptureStats::enabled ? "true" : "false") << ", \"repetitions\": " << settings.repeat
+         << "},\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+        json << "    " << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+    json << "  ]\n}\n";
+
+    if (settings.output.empty())
+        std::fputs(json.str().c_str(), stdout);
+    else
+    {
+        std::ofstream file(settings.output);
+        file << json.str();
+        if (!file)
+        {
+            std::fprintf(stderr, "Cannot write %s\n", settings.output.c_str());
+            return 1;
+        }
+    }
+
+    if (regressions > 0)
+        std::fprintf(stderr, "%d case(s) slower than the baseline by more than %.0f%%\n", regressions, settings.max_regression * 100.0);
+    return failures > 0 || regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,269 @@
+//
+// Multi-stream decoding over a shared worker thread pool
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#include "VideoCaptureGroup.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace DG
+{
+    /// Create an empty group, worker threads start with the first stream added
+    /// @param num_threads Number of worker threads shared by all streams (0 = number of CPU cores)
+    /// @param decoder_threads Decoder threads of each capture not setting its own (1 = parallelism only across streams)
+    /// @param queue_depth Number of frames read ahead per stream
+    VideoCaptureGroup::VideoCaptureGroup(int num_threads, int decoder_threads, int queue_depth)
+        : m_num_threads(num_threads > 0 ? num_threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()))),
+          m_decoder_threads(std::max(1, decoder_threads)),
+          m_queue_depth(std::max(1, queue_depth))
+    {
+    }
+
+    /// Destructor stops the workers and closes all captures
+    VideoCaptureGroup::~VideoCaptureGroup()
+    {
+        close();
+    }
+
+    /// Open a video source and start reading it on the worker pool
+    /// @param filename Path or URL of the video source
+    /// @param options Capture options; prefetch and pipelined conversion are replaced by the group queue, the default decoder threads
+    ///                (0) by the group's decoder_threads; thread_type, cpu_affinity and numa_node apply to the stream's decoder threads
+    /// @return Stream id (0, 1, ... in order of adding), or -1 if the source could not be opened
+    /// @note latest_frame keeps its meaning: the stream queue drops stale frames instead of pausing the stream
+    /// @note An explicit decoder_threads is kept, so one high-resolution stream can decode on many cores next to light ones
+    int VideoCaptureGroup::add(const char *filename, const VideoCaptureOptions &options)
+    {
+        VideoCaptureOptions stream_options = options;
+        stream_options.prefetch = 0;
+        stream_options.latest_frame = false;
+        stream_options.convert_threads = 0;
+        if (stream_options.decoder_threads <= 0)
+            stream_options.decoder_threads = m_decoder_threads;
+
+        // Opening probes the source, do it before the stream becomes visible to the workers
+        auto stream = std::make_unique<Stream>();
+        stream->capture = std::make_shared<VideoCapture>();
+        if (!stream->capture->open(filename, stream_options))
+            return -1;
+        stream->latest = options.latest_frame;
+        stream->ring.resize(static_cast<size_t>(m_queue_depth));
+        for (auto &frame : stream->ring)
+            frame = allocFrame();
+        if (std::find(stream->ring.begin(), stream->ring.end(), nullptr) != stream->ring.end())
+        {
+            for (auto &frame : stream->ring)
+                av_frame_free(&frame);
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_workers.empty())
+        {
+            m_stop = false;
+            for (int i = 0; i < m_num_threads; i++)
+                m_workers.emplace_back(&VideoCaptureGroup::workerLoop, this);
+        }
+
+        const int stream_id = static_cast<int>(m_streams.size());
+        m_streams.push_back(std::move(stream));
+        schedule(*m_streams.back(), stream_id);
+        return stream_id;
+    }
+
+    /// Stop the workers, free all queued frames and close all captures
+    /// @note A capture still held through capture(), readAny() or readAll() is closed once the last holder releases it
+    void VideoCaptureGroup::close()
+    {
+        // Workers reading a stalled network stream would only return after the I/O timeout (or never), interrupt them
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            for (auto &stream : m_streams)
+                stream->capture->interrupt();
+        }
+        m_work_ready.notify_all();
+        for (auto &worker : m_workers)
+            worker.join();
+        m_workers.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &stream : m_streams)
+        {
+            for (auto &frame : stream->ring)
+                av_frame_free(&frame);
+        }
+        m_streams.clear();
+        m_run_queue.clear();
+        m_next_any = 0;
+
+        // Readers waiting for frames see no streams left
+        m_frame_ready.notify_all();
+    }
+
+    /// Number of streams added
+    int VideoCaptureGroup::size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<int>(m_streams.size());
+    }
+
+    /// Capture of a stream, e.g. to get() its properties
+    /// @param stream_id Stream id returned by add()
+    /// @return Capture, kept open while held even if the group is closed meanwhile; nullptr if stream_id is invalid or the group closed
+    /// @note Position properties change while the workers read ahead
+    std::shared_ptr<const VideoCapture> VideoCaptureGroup::capture(int stream_id) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (stream_id < 0 || stream_id >= static_cast<int>(m_streams.size()))
+            return nullptr;
+        return m_streams[static_cast<size_t>(stream_id)]->capture;
+    }
+
+    /// Read the next ready frame of any stream, visiting streams round-robin so none starves
+    /// @param stream_id Receives the id of the stream the frame belongs to (-1 if no frame was read)
+    /// @param dst Pointer to an AVFrame; any buffer it holds is replaced by the ready frame buffer
+    /// @param timeout_ms Maximum time to wait for a frame in milliseconds (-1 = until all streams ended)
+    /// @param capture Receives the capture the frame was read from, which gives its output format (nullptr = not needed)
+    /// @return true on success, false on timeout or if all streams ended
+    bool VideoCaptureGroup::readAny(int &stream_id, AVFrame *dst, int timeout_ms, std::shared_ptr<const VideoCapture> *capture)
+    {
+        stream_id = -1;
+        if (!dst)
+            return false;
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;)
+        {
+            bool all_ended = true;
+            const size_t n = m_streams.size();
+            for (size_t i = 0; i < n; i++)
+            {
+                const size_t id = (m_next_any + i) % n;
+                Stream &stream = *m_streams[id];
+                if (stream.count > 0)
+                {
+                    m_next_any = id + 1;
+                    stream_id = static_cast<int>(id);
+                    if (capture)
+                        *capture = stream.capture;
+                    return popFrame(stream, stream_id, dst);
+                }
+                all_ended = all_ended && stream.ended;
+            }
+            if (all_ended)
+                return false;
+
+            if (timeout_ms < 0)
+                m_frame_ready.wait(lock);
+            else if (m_frame_ready.wait_until(lock, deadline) == std::cv_status::timeout)
+                return false;
+        }
+    }
+
+    /// Read the next frame of every stream, waiting for each stream in turn
+    /// @param count Number of streams to read, from stream id 0 (typically size(); streams added meanwhile are not read)
+    /// @param dst Array of count AVFrame pointers; any buffer a frame holds is replaced by the ready frame buffer
+    /// @param ok Array of count flags receiving true for each stream a frame was read from, false for ended or missing streams
+    /// @param captures Array of count pointers receiving the capture of each frame read (nullptr = not needed)
+    /// @return Number of frames read, 0 when all streams ended
+    int VideoCaptureGroup::readAll(int count, AVFrame *const *dst, bool *ok, std::shared_ptr<const VideoCapture> *captures)
+    {
+        int frames = 0;
+        const size_t n = static_cast<size_t>(std::max(count, 0));
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::fill(ok, ok + n, false);
+        for (size_t id = 0; id < n; id++)
+        {
+            m_frame_ready.wait(lock, [&]
+                               { return id >= m_streams.size() || m_streams[id]->count > 0 || m_streams[id]->ended; });
+            if (id >= m_streams.size())
+                break;
+            ok[id] = dst[id] && m_streams[id]->count > 0 && popFrame(*m_streams[id], static_cast<int>(id), dst[id]);
+            if (ok[id] && captures)
+                captures[id] = m_streams[id]->capture;
+            frames += ok[id];
+        }
+        return frames;
+    }
+
+    /// Worker thread body: read one frame of the next scheduled stream, reschedule the stream while its ring has room
+    void VideoCaptureGroup::workerLoop()
+    {
+        for (;;)
+        {
+            // Wait for a stream to read from and take a free slot of its ring
+            Stream *stream = nullptr;
+            int stream_id = -1;
+            AVFrame *slot = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_work_ready.wait(lock, [&]
+                                  { return m_stop || !m_run_queue.empty(); });
+                if (m_stop)
+                    break;
+                stream_id = m_run_queue.front();
+                m_run_queue.pop_front();
+                stream = m_streams[static_cast<size_t>(stream_id)].get();
+
+                // Latest-frame streams never pause, the stale frame makes room (counted like the drops of a prefetch ring)
+                const size_t depth = stream->ring.size();
+                if (stream->count == depth)
+                {
+                    av_frame_unref(stream->ring[stream->head]);
+                    stream->head = (stream->head + 1) % depth;
+                    stream->count--;
+                    stream->capture->addDroppedFrames();
+                }
+                slot = stream->ring[(stream->head + stream->count) % depth];
+            }
+
+            // Demux, decode and convert outside the lock; the slot is not visible to readers until queued
+            const bool ok = stream->capture->readFrame(slot);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                stream->scheduled = false;
+                if (ok)
+                    stream->count++;
+                else
+                    stream->ended = true;
+                schedule(*stream, stream_id);
+            }
+            m_frame_ready.notify_all();
+        }
+    }
+
+    /// Put a stream into the run queue if it can take another frame and is not queued or running already
+    /// @param stream Stream to schedule (m_mutex must be held)
+    /// @param stream_id Id of the stream
+    void VideoCaptureGroup::schedule(Stream &stream, int stream_id)
+    {
+        if (stream.scheduled || stream.ended || (stream.count == stream.ring.size() && !stream.latest))
+            return;
+        stream.scheduled = true;
+        m_run_queue.push_back(stream_id);
+        m_work_ready.notify_one();
+    }
+
+    /// Hand the oldest ready frame of a stream over to the caller, which frees a slot for the workers
+    /// @param stream Stream with at least one ready frame (m_mutex must be held)
+    /// @param stream_id Id of the stream
+    /// @param dst Pointer to an AVFrame; any buffer it holds is replaced by the ready frame buffer
+    /// @return true
+    bool VideoCaptureGroup::popFrame(Stream &stream, int stream_id, AVFrame *dst)
+    {
+        AVFrame *slot = stream.ring[stream.head];
+        av_frame_unref(dst);
+        av_frame_move_ref(dst, slot);
+        stream.head = (stream.head + 1) % stream.ring.size();
+        stream.count--;
+        schedule(stream, stream_id);
+        return true;
+    }
+
+} // namespace DG
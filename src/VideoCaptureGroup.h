@@ -0,0 +1,76 @@
+//
+// Multi-stream decoding over a shared worker thread pool
+//
+// Copyright 2026 DeGirum Corporation
+//
+
+#ifndef VIDEO_CAPTURE_GROUP_H
+#define VIDEO_CAPTURE_GROUP_H
+
+#include "VideoCapture.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DG
+{
+    /// Group of captures decoded by one fixed pool of worker threads
+    ///
+    /// Each stream is one job at a time: a worker takes a stream from the run queue, reads (demux, decode, convert)
+    /// one frame into the stream's ready queue and puts the stream back while its queue has room.
+    /// CPU usage is bounded by the pool size instead of growing with the number of streams.
+    class VideoCaptureGroup
+    {
+    public:
+        explicit VideoCaptureGroup(int num_threads = 0, int decoder_threads = 1, int queue_depth = 2);
+        ~VideoCaptureGroup();
+
+        VideoCaptureGroup(const VideoCaptureGroup &) = delete;
+        VideoCaptureGroup &operator=(const VideoCaptureGroup &) = delete;
+
+        int add(const char *filename, const VideoCaptureOptions &options = VideoCaptureOptions());
+        void close();
+        int size() const;
+        std::shared_ptr<const VideoCapture> capture(int stream_id) const;
+
+        bool readAny(int &stream_id, AVFrame *dst, int timeout_ms = -1, std::shared_ptr<const VideoCapture> *capture = nullptr);
+        int readAll(int count, AVFrame *const *dst, bool *ok, std::shared_ptr<const VideoCapture> *captures = nullptr);
+
+    private:
+        /// One capture with its queue of frames read ahead by the workers
+        struct Stream
+        {
+            std::shared_ptr<VideoCapture> capture; //!< Opened capture, only read by the worker holding the stream job (shared with callers
+                                                   //!< converting its frames, so it outlives a concurrent close())
+            std::vector<AVFrame *> ring;           //!< Bounded ring of ready frames
+            size_t head = 0;                       //!< Index of the oldest ready frame in the ring
+            size_t count = 0;                      //!< Number of ready frames in the ring
+            bool scheduled = false;                //!< Stream is in the run queue or being read by a worker
+            bool ended = false;                    //!< Capture reached EOS or failed, no more frames are read
+            bool latest = false;                   //!< latest_frame: a full ring drops its oldest frame instead of pausing the stream
+        };
+
+        void workerLoop();                                       //!< Worker thread body: read one frame of the next scheduled stream
+        void schedule(Stream &stream, int stream_id);            //!< Put a stream with room in its ring into the run queue (lock held)
+        bool popFrame(Stream &stream, int stream_id, AVFrame *dst); //!< Move the oldest ready frame of a stream into dst (lock held)
+
+        int m_num_threads;                               //!< Number of worker threads
+        int m_decoder_threads;                           //!< Decoder threads of captures not setting their own
+        int m_queue_depth;                               //!< Ready frames queued per stream
+        std::vector<std::unique_ptr<Stream>> m_streams;  //!< Streams by id (pointers stay valid when the vector grows)
+        std::deque<int> m_run_queue;                     //!< Ids of streams waiting for a worker
+        std::vector<std::thread> m_workers;              //!< Worker threads, started with the first stream
+        mutable std::mutex m_mutex;                      //!< Protects everything above except Stream::capture
+        std::condition_variable m_work_ready;            //!< Signaled when a stream is scheduled or stop is requested
+        std::condition_variable m_frame_ready;           //!< Signaled when a frame is queued or a stream ended
+        bool m_stop = false;                             //!< Set by close() to make the workers exit
+        size_t m_next_any = 0;                           //!< Stream readAny() looks at first, rotated for fairness
+    };
+
+} // namespace DG
+
+#endif // VIDEO_CAPTURE_GROUP_H
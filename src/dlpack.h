@@ -0,0 +1,68 @@
+//
+// Minimal DLPack tensor ABI extraction
+// Extracted from dlpack/dlpack.h (https://github.com/dmlc/dlpack) to avoid an extra dependency
+//
+// Copyright (c) 2017 by Contributors
+// Licensed under Apache 2.0 License
+//
+
+#ifndef DLPACK_H
+#define DLPACK_H
+
+#include <cstdint>
+
+extern "C"
+{
+    /// @brief The device type in DLDevice.
+    typedef enum
+    {
+        kDLCPU = 1,  //!< CPU device
+        kDLCUDA = 2, //!< CUDA GPU device
+    } DLDeviceType;
+
+    /// @brief A Device for Tensor and operator.
+    typedef struct
+    {
+        DLDeviceType device_type; //!< The device type used in the device.
+        int32_t device_id;        //!< The device index. For vanilla CPU memory, pinned memory, or managed memory, this is set to 0.
+    } DLDevice;
+
+    /// @brief The type code options DLDataType.
+    typedef enum
+    {
+        kDLInt = 0U,   //!< signed integer
+        kDLUInt = 1U,  //!< unsigned integer
+        kDLFloat = 2U, //!< IEEE floating point
+    } DLDataTypeCode;
+
+    /// @brief The data type the tensor can hold. The data type is assumed to follow the native endian-ness.
+    typedef struct
+    {
+        uint8_t code;   //!< Type code of base types (DLDataTypeCode)
+        uint8_t bits;   //!< Number of bits, common choices are 8, 16, 32.
+        uint16_t lanes; //!< Number of lanes in the type, used for vector types.
+    } DLDataType;
+
+    /// @brief Plain C Tensor object, does not manage memory.
+    typedef struct
+    {
+        void *data;           //!< The data pointer points to the allocated data.
+        DLDevice device;      //!< The device of the tensor
+        int32_t ndim;         //!< Number of dimensions
+        DLDataType dtype;     //!< The data type of the pointer
+        int64_t *shape;       //!< The shape of the tensor
+        int64_t *strides;     //!< Strides of the tensor (in number of elements, not bytes), can be NULL for compact row-major tensors
+        uint64_t byte_offset; //!< The offset in bytes to the beginning pointer to data
+    } DLTensor;
+
+    /// @brief C Tensor object, manage memory of DLTensor. This data structure is intended to facilitate the borrowing
+    /// of DLTensor by another framework. It is not meant to transfer the tensor.
+    typedef struct DLManagedTensor
+    {
+        DLTensor dl_tensor;                          //!< DLTensor which is being memory managed
+        void *manager_ctx;                           //!< The context of the original host framework of DLManagedTensor
+        void (*deleter)(struct DLManagedTensor *self); //!< Destructor - this should be called to destruct manager_ctx which backs the DLManagedTensor
+    } DLManagedTensor;
+}
+
+#endif // DLPACK_H
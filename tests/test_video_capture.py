@@ -15,7 +15,7 @@ DEFAULT_VIDEO = os.path.join(os.path.dirname(os.path.abspath(__file__)), "assets
 
 # Import the module
 try:
-    from degirum_video_capture import VideoCapture, CAP_PROP_FRAME_WIDTH, CAP_PROP_FRAME_HEIGHT
+    from degirum_video_capture import VideoCapture, VideoCaptureGroup, SharedFramePublisher, SharedFrameSubscriber, CAP_PROP_FRAME_WIDTH, CAP_PROP_FRAME_HEIGHT, CAP_PROP_POS_FRAMES, CAP_PROP_POS_MSEC, CAP_PROP_FRAME_COUNT, CAP_PROP_FPS, CAP_PROP_RECONNECT_COUNT, CAP_PROP_FRAMES_DECODED, CAP_PROP_FRAMES_DROPPED, CAP_PROP_FRAMES_CONVERTED, CAP_PROP_DECODE_MSEC, CAP_PROP_COLORSPACE, CAP_PROP_COLOR_RANGE, allocation_count
     print("✓ Successfully imported VideoCapture")
 except ImportError as e:
     print(f"✗ Failed to import VideoCapture: {e}")
@@ -154,6 +154,1255 @@ def test_manual_reading(video_path, width=640, height=640):
         capture.close()
 
 
+def test_prefetch_reading(video_path, width=640, height=640):
+    """Test that prefetch mode returns the same frames as synchronous reading"""
+    print(f"\n=== Testing Prefetch Reading ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as sync_capture, \
+             VideoCapture(video_path, width, height, prefetch=4) as prefetch_capture:
+            if not sync_capture.isOpened() or not prefetch_capture.isOpened():
+                print(f"✗ Failed to open video: {video_path}")
+                return False
+
+            frame_count = 0
+            while True:
+                sync_ok, sync_frame = sync_capture.read()
+                prefetch_ok, prefetch_frame = prefetch_capture.read()
+                assert sync_ok == prefetch_ok, "Prefetch and synchronous reads should end at the same frame"
+                if not sync_ok:
+                    break
+                assert np.array_equal(sync_frame, prefetch_frame), f"Frame {frame_count} differs in prefetch mode"
+                frame_count += 1
+
+        print(f"✓ Prefetch reading test passed ({frame_count} frames)")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in prefetch reading test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_batch_reading(video_path, width=640, height=640, batch_size=4):
+    """Test that read_batch returns the same frames as consecutive read calls"""
+    print(f"\n=== Testing Batch Reading ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as single_capture, \
+             VideoCapture(video_path, width, height) as batch_capture:
+            if not single_capture.isOpened() or not batch_capture.isOpened():
+                print(f"✗ Failed to open video: {video_path}")
+                return False
+
+            frame_count = 0
+            while True:
+                frames, timestamps = batch_capture.read_batch(batch_size)
+                assert frames.flags['C_CONTIGUOUS'], "Batch should be a contiguous array"
+                assert frames.shape[1:] == (height, width, 3), f"Batch frame shape should be ({height}, {width}, 3)"
+                assert len(timestamps) == len(frames), "Timestamps should match frame count"
+
+                for frame in frames:
+                    success, expected = single_capture.read()
+                    assert success, "Batch returned more frames than read()"
+                    assert np.array_equal(frame, expected), f"Frame {frame_count} differs in batch mode"
+                    frame_count += 1
+
+                if len(frames) < batch_size:
+                    break
+
+            assert not single_capture.read()[0], "Batch returned fewer frames than read()"
+
+        print(f"✓ Batch reading test passed ({frame_count} frames)")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in batch reading test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_read_into(video_path, width=640, height=640):
+    """Test decoding into caller-supplied arrays, including padded rows"""
+    print(f"\n=== Testing Read Into ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as reference_capture, \
+             VideoCapture(video_path, width, height) as capture:
+            if not reference_capture.isOpened() or not capture.isOpened():
+                print(f"✗ Failed to open video: {video_path}")
+                return False
+
+            contiguous = np.zeros((height, width, 3), dtype=np.uint8)
+            padded = np.zeros((height, width + 16, 3), dtype=np.uint8)[:, :width]
+
+            for i in range(5):
+                out = contiguous if i % 2 == 0 else padded
+                assert capture.read_into(out), f"Failed to read frame {i} into array"
+                success, expected = reference_capture.read()
+                assert success and np.array_equal(out, expected), f"Frame {i} differs in read_into"
+
+            try:
+                capture.read_into(np.zeros((height, width), dtype=np.uint8))
+                assert False, "read_into should reject arrays of wrong shape"
+            except ValueError:
+                pass
+
+        print("✓ Read into test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in read into test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_tensor_output(video_path, width=640, height=640):
+    """Test tensor output layouts and dtypes against BGR frames"""
+    print(f"\n=== Testing Tensor Output ===")
+
+    mean = (123.675, 116.28, 103.53)
+    std = (58.395, 57.12, 57.375)
+
+    try:
+        with VideoCapture(video_path, width, height) as bgr_capture, \
+             VideoCapture(video_path, width, height, tensor=True, layout="nhwc", dtype=np.uint8, channel_order="bgr") as raw_capture, \
+             VideoCapture(video_path, width, height, tensor=True, mean=mean, std=std) as nchw_capture, \
+             VideoCapture(video_path, width, height, tensor=True, dtype=np.float16, mean=mean, std=std) as half_capture:
+            if not all(c.isOpened() for c in (bgr_capture, raw_capture, nchw_capture, half_capture)):
+                print(f"✗ Failed to open video: {video_path}")
+                return False
+
+            for i in range(5):
+                _, bgr = bgr_capture.read()
+                _, raw = raw_capture.read()
+                _, nchw = nchw_capture.read()
+                _, half = half_capture.read()
+
+                assert raw.shape == (height, width, 3) and raw.dtype == np.uint8, "uint8 NHWC tensor has wrong shape or dtype"
+                assert nchw.shape == (3, height, width) and nchw.dtype == np.float32, "float32 NCHW tensor has wrong shape or dtype"
+                assert half.shape == (3, height, width) and half.dtype == np.float16, "float16 NCHW tensor has wrong shape or dtype"
+                assert nchw.flags['C_CONTIGUOUS'], "Tensor should be contiguous"
+
+                # Planar and packed RGB conversions in swscale may round differently
+                diff = np.abs(raw.astype(np.int16) - bgr.astype(np.int16))
+                assert diff.max() <= 2, f"Frame {i}: uint8 tensor differs from BGR frame by {diff.max()}"
+
+                # Normalization of the same pixels: RGB planes from the BGR uint8 tensor
+                rgb = raw[:, :, ::-1].transpose(2, 0, 1).astype(np.float32)
+                expected = (rgb - np.array(mean, dtype=np.float32)[:, None, None]) / np.array(std, dtype=np.float32)[:, None, None]
+                assert np.allclose(nchw, expected, atol=1e-4), f"Frame {i}: float32 tensor normalization is wrong"
+                assert np.allclose(half.astype(np.float32), expected, atol=1e-2), f"Frame {i}: float16 tensor normalization is wrong"
+
+            frames, _ = nchw_capture.read_batch(2)
+            assert frames.shape == (2, 3, height, width) and frames.dtype == np.float32, "Tensor batch has wrong shape or dtype"
+
+            out = np.empty((3, height, width), dtype=np.float32)
+            assert nchw_capture.read_into(out), "Failed to read tensor into array"
+
+        print("✓ Tensor output test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in tensor output test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_pixel_formats(video_path, width=640, height=640):
+    """Test RGB24, GRAY8, NV12 and YUV420P output against BGR frames and each other"""
+    print(f"\n=== Testing Pixel Formats ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as bgr_capture, \
+             VideoCapture(video_path, width, height, pixel_format="rgb24") as rgb_capture, \
+             VideoCapture(video_path, width, height, pixel_format="nv12") as nv12_capture:
+            for i in range(3):
+                _, bgr = bgr_capture.read()
+                _, rgb = rgb_capture.read()
+                assert np.array_equal(rgb, bgr[:, :, ::-1]), f"Frame {i}: RGB24 frame is not the channel-swapped BGR24 frame"
+
+                success, (y, uv) = nv12_capture.read()
+                assert success and y.shape == (height, width) and uv.shape == (height // 2, width // 2, 2), \
+                    "NV12 planes have wrong shape"
+
+        # Native size: gray views the decoded luma plane, YUV420P passes decoded frames through
+        with VideoCapture(video_path, pixel_format="gray") as gray_capture, \
+             VideoCapture(video_path, pixel_format="yuv420p") as yuv_capture, \
+             VideoCapture(video_path, pixel_format="yuv420p") as packed_capture:
+            frame_width = int(gray_capture.get(CAP_PROP_FRAME_WIDTH))
+            frame_height = int(gray_capture.get(CAP_PROP_FRAME_HEIGHT))
+            packed = np.empty((frame_height * 3 // 2, frame_width), dtype=np.uint8)
+
+            for i in range(3):
+                _, gray = gray_capture.read()
+                _, (y, u, v) = yuv_capture.read()
+                assert gray.shape == (frame_height, frame_width), "GRAY8 frame has wrong shape"
+                assert np.array_equal(gray, y), f"Frame {i}: GRAY8 frame differs from the YUV420P luma plane"
+
+                assert packed_capture.read_into(packed), f"Failed to read frame {i} into I420 array"
+                quarter = frame_height // 4
+                assert np.array_equal(packed[:frame_height], y), f"Frame {i}: I420 luma rows differ"
+                assert np.array_equal(packed[frame_height:frame_height + quarter].reshape(u.shape), u), f"Frame {i}: I420 U plane differs"
+                assert np.array_equal(packed[frame_height + quarter:].reshape(v.shape), v), f"Frame {i}: I420 V plane differs"
+
+            frames, _ = gray_capture.read_batch(2)
+            assert frames.shape == (2, frame_height, frame_width), "GRAY8 batch has wrong shape"
+
+        # Odd sizes have no NV12 layout; the failed open leaves nothing half set up to read from
+        odd_capture = VideoCapture(video_path, width + 1, height, pixel_format="nv12")
+        assert not odd_capture.isOpened(), "NV12 capture with odd width opened"
+        success, frame = odd_capture.read()
+        assert not success and frame is None, "Read from a failed NV12 open returned a frame"
+
+        print("✓ Pixel formats test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in pixel formats test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_seeking(video_path, width=640, height=640, frame_total=30):
+    """Test that seeking by frame index and timestamp lands on the exact frame"""
+    print(f"\n=== Testing Seeking ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            if not capture.isOpened():
+                print(f"✗ Failed to open video: {video_path}")
+                return False
+
+            frames = []
+            timestamps = []
+            for _ in range(frame_total):
+                success, frame = capture.read()
+                if not success:
+                    break
+                frames.append(frame)
+                timestamps.append(capture.get(CAP_PROP_POS_MSEC))
+
+            for target in (len(frames) * 2 // 3, 0, len(frames) // 3):
+                assert capture.set(CAP_PROP_POS_FRAMES, target), f"Failed to seek to frame {target}"
+                assert capture.get(CAP_PROP_POS_FRAMES) == target, "Position should be the target frame after seek"
+                success, frame = capture.read()
+                assert success and np.array_equal(frame, frames[target]), f"Seek to frame {target} returned a different frame"
+                assert capture.get(CAP_PROP_POS_FRAMES) == target + 1, "Position should advance after read"
+
+            target = len(frames) // 2
+            assert capture.set(CAP_PROP_POS_MSEC, timestamps[target]), f"Failed to seek to {timestamps[target]} ms"
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, frames[target]), f"Seek to {timestamps[target]} ms returned a different frame"
+
+            # A target past the end fails and keeps the read position: read() and POS_FRAMES still agree
+            position = int(capture.get(CAP_PROP_POS_FRAMES))
+            assert not capture.set(CAP_PROP_POS_FRAMES, 1000000), "Seek past the end succeeded"
+            assert capture.get(CAP_PROP_POS_FRAMES) == position, "Failed seek changed the position"
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, frames[position]), "Read after a failed seek did not continue at the position"
+
+        # Seeking restarts the prefetch thread at the new position
+        with VideoCapture(video_path, width, height, prefetch=4) as capture:
+            target = len(frames) // 2
+            assert capture.set(CAP_PROP_POS_FRAMES, target), "Failed to seek with prefetch"
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, frames[target]), "Seek with prefetch returned a different frame"
+            assert not capture.set(CAP_PROP_POS_FRAMES, 1000000), "Seek past the end succeeded with prefetch"
+            assert capture.get(CAP_PROP_POS_FRAMES) == target + 1, "Failed seek changed the position with prefetch"
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, frames[target + 1]), "Read after a failed seek with prefetch did not continue at the position"
+
+        print(f"✓ Seeking test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in seeking test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_frame_index(video_path, width=640, height=640, frame_total=30):
+    """Test that the frame index sidecar is built, reloaded and used for exact seeks"""
+    print(f"\n=== Testing Frame Index ===")
+
+    import tempfile
+
+    index_path = os.path.join(tempfile.mkdtemp(), "video.dgidx")
+    try:
+        # First full pass builds and saves the index
+        frames = []
+        with VideoCapture(video_path, width, height, frame_index=True, index_path=index_path) as capture:
+            if not capture.isOpened():
+                print(f"✗ Failed to open video: {video_path}")
+                return False
+            while True:
+                success, frame = capture.read()
+                if not success:
+                    break
+                if len(frames) < frame_total:
+                    frames.append(frame)
+                total = capture.get(CAP_PROP_POS_FRAMES)
+        assert os.path.isfile(index_path), "Index sidecar should be written after a full pass"
+
+        # Reopen loads the sidecar, frame count is exact and seeks land on the target frame
+        with VideoCapture(video_path, width, height, frame_index=True, index_path=index_path) as capture:
+            assert capture.get(CAP_PROP_FRAME_COUNT) == total, "Indexed frame count should match the frames read"
+            for target in (len(frames) - 1, 0, len(frames) // 2):
+                assert capture.set(CAP_PROP_POS_FRAMES, target), f"Failed indexed seek to frame {target}"
+                success, frame = capture.read()
+                assert success and np.array_equal(frame, frames[target]), f"Indexed seek to frame {target} returned a different frame"
+
+        # Explicit scan keeps the read position
+        with VideoCapture(video_path, width, height) as capture:
+            capture.read()
+            assert capture.build_index(), "Failed to build index"
+            assert capture.get(CAP_PROP_FRAME_COUNT) == total, "Scanned frame count should match the frames read"
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, frames[1]), "build_index() should keep the read position"
+
+        print(f"✓ Frame index test passed ({int(total)} frames indexed)")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in frame index test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+    finally:
+        if os.path.exists(index_path):
+            os.remove(index_path)
+        os.rmdir(os.path.dirname(index_path))
+
+
+def test_frame_subsampling(video_path, width=640, height=640, frame_total=30):
+    """Test that frame_step, target_fps and skip_frame return the expected subset of frames"""
+    print(f"\n=== Testing Frame Subsampling ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            if not capture.isOpened():
+                print(f"✗ Failed to open video: {video_path}")
+                return False
+            fps = capture.get(CAP_PROP_FPS)
+            frames = []
+            for _ in range(frame_total):
+                success, frame = capture.read()
+                if not success:
+                    break
+                frames.append(frame)
+
+        # Every third frame, position counts the skipped frames
+        with VideoCapture(video_path, width, height, frame_step=3) as capture:
+            for i in range(0, len(frames), 3):
+                success, frame = capture.read()
+                assert success and np.array_equal(frame, frames[i]), f"frame_step=3 read {i // 3} should be frame {i}"
+                assert capture.get(CAP_PROP_POS_FRAMES) == i + 1, "Position should count skipped frames"
+
+        # Half the source rate picks every other frame
+        with VideoCapture(video_path, width, height, target_fps=fps / 2) as capture:
+            for i in range(0, len(frames), 2):
+                success, frame = capture.read()
+                assert success and np.array_equal(frame, frames[i]), f"target_fps read {i // 2} should be frame {i}"
+
+        # Keyframes only: the first frame of the stream is a keyframe
+        with VideoCapture(video_path, width, height, skip_frame="nonkey") as capture:
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, frames[0]), "skip_frame='nonkey' should return the first keyframe"
+
+        for bad in ({"frame_step": 0}, {"target_fps": -1.0}):
+            assert not VideoCapture().open(video_path, width, height, **bad), f"open() should reject {bad}"
+
+        print(f"✓ Frame subsampling test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in frame subsampling test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_live_mode(video_path, width=640, height=640):
+    """Test live low-latency options and latest-frame reads"""
+    print(f"\n=== Testing Live Mode ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            success, first = capture.read()
+            assert success, "Failed to read reference frame"
+
+        # Live tuning changes buffering and threading, not the frames
+        with VideoCapture(video_path, width, height, live=True, timeout_ms=2000) as capture:
+            assert capture.isOpened(), "Failed to open in live mode"
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, first), "Live mode returned a different first frame"
+
+        # Frame position of each timestamp in a plain sequential read
+        positions = {}
+        with VideoCapture(video_path, width, height) as capture:
+            while capture.read()[0]:
+                positions[capture.get(CAP_PROP_POS_MSEC)] = capture.get(CAP_PROP_POS_FRAMES)
+
+        # Latest-frame reads skip stale frames but never go backwards, and the position counts the skipped frames
+        with VideoCapture(video_path, width, height, latest_frame=True) as capture:
+            last_msec = -1.0
+            n = 0
+            while True:
+                success, frame = capture.read()
+                if not success:
+                    break
+                msec = capture.get(CAP_PROP_POS_MSEC)
+                assert msec > last_msec, "Latest-frame reads should return frames in increasing time"
+                assert capture.get(CAP_PROP_POS_FRAMES) == positions[msec], \
+                    f"Latest-frame position {capture.get(CAP_PROP_POS_FRAMES)} at {msec} ms, sequential read gives {positions[msec]}"
+                last_msec = msec
+                n += 1
+                time.sleep(0.005)
+            assert n > 0, "Latest-frame mode should return frames"
+
+        print(f"✓ Live mode test passed ({n} latest frames)")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in live mode test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_reconnect(video_path, width=640, height=640):
+    """Test that a live source ending is reconnected and decoding continues"""
+    print(f"\n=== Testing Reconnect ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            total = 0
+            while capture.read()[0]:
+                total += 1
+            assert capture.get(CAP_PROP_RECONNECT_COUNT) == 0, "Files should not reconnect at end of stream"
+
+        # A file opened as a live source reconnects at its end, like a dropped stream
+        with VideoCapture(video_path, width, height, live=True, reconnect_attempts=1, reconnect_delay_ms=0) as capture:
+            for i in range(total + 5):
+                success, frame = capture.read()
+                assert success, f"Read {i} failed, reconnect should continue the stream"
+            assert capture.get(CAP_PROP_RECONNECT_COUNT) == 1, "Reconnect should be counted"
+
+        print(f"✓ Reconnect test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in reconnect test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_capture_group(video_path, width=640, height=640, streams=3):
+    """Test that a capture group decodes several streams on a shared pool, frames tagged by stream id"""
+    print(f"\n=== Testing Capture Group ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            frames = []
+            while True:
+                success, frame = capture.read()
+                if not success:
+                    break
+                frames.append(frame)
+
+        with VideoCaptureGroup(num_threads=2) as group:
+            ids = [group.add(video_path, width, height) for _ in range(streams)]
+            assert ids == list(range(streams)), f"Stream ids should be 0..{streams - 1}, got {ids}"
+            assert group.add("nonexistent_file.mp4") == -1, "Adding an invalid source should fail"
+            assert len(group) == streams, "Failed source should not be added"
+
+            # One frame of every stream
+            first = group.read_all()
+            assert len(first) == streams, "read_all() should return one entry per stream"
+            for frame in first:
+                assert frame is not None and np.array_equal(frame, frames[0]), "read_all() should return the first frame of each stream"
+
+            # Remaining frames of all streams, each stream in order
+            counts = [1] * streams
+            while True:
+                stream_id, frame = group.read_any()
+                if frame is None:
+                    assert stream_id == -1, "No stream id without a frame"
+                    break
+                assert np.array_equal(frame, frames[counts[stream_id]]), f"Stream {stream_id} returned frame out of order"
+                counts[stream_id] += 1
+            assert counts == [len(frames)] * streams, f"Every stream should return all {len(frames)} frames, got {counts}"
+            assert group.read_all() == [None] * streams, "read_all() should return None for ended streams"
+            assert group.get(0, CAP_PROP_FRAME_WIDTH) > 0, "Stream properties should be readable"
+
+        print(f"✓ Capture group test passed ({streams} streams x {len(frames)} frames)")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in capture group test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_pipelined_conversion(video_path, width=640, height=640, frame_total=30):
+    """Test that pipelined, slice-threaded conversion returns the same frames as serial conversion"""
+    print(f"\n=== Testing Pipelined Conversion ===")
+
+    try:
+        for w, h in ((width, height), (0, 0)):
+            with VideoCapture(video_path, w, h) as capture:
+                frames = []
+                for _ in range(frame_total):
+                    success, frame = capture.read()
+                    if not success:
+                        break
+                    frames.append(frame)
+
+            for threads in (1, 4):
+                with VideoCapture(video_path, w, h, convert_threads=threads) as capture:
+                    for i, expected in enumerate(frames):
+                        success, frame = capture.read()
+                        assert success and frame.shape == expected.shape, f"convert_threads={threads} read {i} failed"
+                        # Slices may round filter taps differently at their borders
+                        diff = np.abs(frame.astype(np.int16) - expected.astype(np.int16)).max()
+                        assert diff <= 2, f"convert_threads={threads} frame {i} differs by {diff}"
+
+                    # Restart of both stages after a seek
+                    assert capture.set(CAP_PROP_POS_FRAMES, 0), "Seek with pipelined conversion failed"
+                    success, frame = capture.read()
+                    assert success and np.abs(frame.astype(np.int16) - frames[0].astype(np.int16)).max() <= 2, "Seek returned a different frame"
+
+        print(f"✓ Pipelined conversion test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in pipelined conversion test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_threaded_reading(video_path, width=640, height=640, thread_count=4):
+    """Test reading from several Python threads: one capture per thread, a shared capture and close() from another thread"""
+    print(f"\n=== Testing Threaded Reading ===")
+
+    import threading
+
+    def count_frames(capture):
+        n = 0
+        while capture.read()[0]:
+            n += 1
+        return n
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            frame_total = count_frames(capture)
+        assert frame_total > 0, "No frames read"
+
+        # One capture per thread, decoding runs in parallel without the GIL
+        counts = [0] * thread_count
+
+        def worker(i):
+            with VideoCapture(video_path, width, height) as capture:
+                counts[i] = count_frames(capture)
+
+        threads = [threading.Thread(target=worker, args=(i,)) for i in range(thread_count)]
+        start_time = time.time()
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        elapsed_time = time.time() - start_time
+        assert counts == [frame_total] * thread_count, f"Per-thread frame counts {counts}, expected {frame_total}"
+        print(f"  {thread_count} threads: {thread_count * frame_total / elapsed_time:.1f} FPS total")
+
+        # Shared capture: calls are serialized, every frame is handed out exactly once
+        for prefetch in (0, 2):
+            with VideoCapture(video_path, width, height, prefetch=prefetch) as capture:
+                shared = [0] * thread_count
+
+                def shared_worker(i):
+                    shared[i] = count_frames(capture)
+
+                threads = [threading.Thread(target=shared_worker, args=(i,)) for i in range(thread_count)]
+                for thread in threads:
+                    thread.start()
+                for thread in threads:
+                    thread.join()
+                assert sum(shared) == frame_total, f"prefetch={prefetch}: shared capture read {sum(shared)} frames, expected {frame_total}"
+
+        # close() from another thread ends a reading thread cleanly
+        capture = VideoCapture(video_path, width, height, prefetch=2)
+        reader = threading.Thread(target=count_frames, args=(capture,))
+        reader.start()
+        capture.close()
+        reader.join(timeout=10)
+        assert not reader.is_alive(), "Reader did not stop after close()"
+        assert not capture.isOpened(), "Capture still opened after close()"
+
+        print(f"✓ Threaded reading test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in threaded reading test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_steady_state_allocations(video_path, width=640, height=640, warmup=5, frame_total=30):
+    """Test that reads allocate no FFmpeg frames or packets once warmed up"""
+    print(f"\n=== Testing Steady-State Allocations ===")
+
+    try:
+        for options in ({}, {"prefetch": 2}, {"convert_threads": 2}, {"pixel_format": "nv12"}):
+            with VideoCapture(video_path, width, height, **options) as capture:
+                for _ in range(warmup):
+                    assert capture.read()[0], f"{options}: warmup read failed"
+
+                start = allocation_count()
+                for i in range(frame_total):
+                    success, frame = capture.read()
+                    assert success, f"{options}: read {i} failed"
+                    del frame
+                allocated = allocation_count() - start
+                assert allocated == 0, f"{options}: {allocated} allocations in {frame_total} reads"
+
+        # Frames kept alive need their own frame objects, released ones are reused afterwards
+        with VideoCapture(video_path, width, height) as capture:
+            kept = [capture.read()[1] for _ in range(warmup)]
+            del kept
+            start = allocation_count()
+            for _ in range(warmup):
+                assert capture.read()[0], "Read after releasing kept frames failed"
+            assert allocation_count() == start, "Released frame objects were not reused"
+
+        print(f"✓ Steady-state allocation test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in steady-state allocation test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_async_reading(video_path, width=640, height=640, stream_count=4):
+    """Test the asyncio interface: read_async(), async iteration and many captures on one loop"""
+    print(f"\n=== Testing Async Reading ===")
+
+    import asyncio
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            frames = []
+            while True:
+                success, frame = capture.read()
+                if not success:
+                    break
+                frames.append(frame)
+        assert frames, "No frames read"
+
+        async def read_all(**options):
+            with VideoCapture(video_path, width, height, **options) as capture:
+                return [frame async for frame in capture.frames()]
+
+        async def main():
+            # Prefetched captures are woken by the prefetch thread, others read in the executor
+            for options in ({"prefetch": 2}, {"convert_threads": 2}, {}):
+                result = await read_all(**options)
+                assert len(result) == len(frames), f"{options}: read {len(result)} frames, expected {len(frames)}"
+                assert all(np.array_equal(a, b) for a, b in zip(result, frames)), f"{options}: frames differ"
+
+            # Many streams multiplexed on the loop
+            results = await asyncio.gather(*(read_all(prefetch=2) for _ in range(stream_count)))
+            assert all(len(result) == len(frames) for result in results), "Concurrent streams lost frames"
+
+            # Single awaitable reads, then end of video
+            with VideoCapture(video_path, width, height, prefetch=2) as capture:
+                success, frame = await capture.read_async()
+                assert success and np.array_equal(frame, frames[0]), "read_async returned a different first frame"
+                while (await capture.read_async())[0]:
+                    pass
+                assert capture.try_read() == (-1, None), "try_read after end of video must return -1"
+
+            # Pending reads finish when the capture is closed
+            capture = VideoCapture(video_path, width, height, prefetch=2)
+            assert capture.prefetch == 2, "prefetch property mismatch"
+            waits = [asyncio.ensure_future(capture.read_async()) for _ in range(2)]
+            await asyncio.sleep(0)
+            capture.close()
+            results = await asyncio.wait_for(asyncio.gather(*waits), timeout=10)
+            assert all(isinstance(success, bool) for success, _ in results), "Waiters did not finish after close()"
+
+        asyncio.run(main())
+        print(f"✓ Async reading test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in async reading test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_crop(video_path, width=640, height=640):
+    """Test region-of-interest crop before conversion, alone and with letterbox resize"""
+    print(f"\n=== Testing Crop ===")
+
+    try:
+        with VideoCapture(video_path, pixel_format="yuv420p") as capture:
+            frame_width = int(capture.get(CAP_PROP_FRAME_WIDTH))
+            frame_height = int(capture.get(CAP_PROP_FRAME_HEIGHT))
+            _, (full_y, full_u, full_v) = capture.read()
+            _, full_bgr = VideoCapture(video_path).read()
+
+        x, y = frame_width // 4 & ~1, frame_height // 4 & ~1
+        w, h = frame_width // 2 & ~1, frame_height // 3 & ~1
+
+        # Unscaled crop is the same region cut out of the full frame
+        with VideoCapture(video_path, pixel_format="yuv420p", crop=(x, y, w, h)) as capture:
+            success, (crop_y, crop_u, crop_v) = capture.read()
+            assert success and crop_y.shape == (h, w), f"Cropped luma has shape {crop_y.shape}, expected {(h, w)}"
+            assert np.array_equal(crop_y, full_y[y:y + h, x:x + w]), "Cropped luma differs from the full frame region"
+            assert np.array_equal(crop_u, full_u[y // 2:(y + h) // 2, x // 2:(x + w) // 2]), "Cropped chroma differs from the full frame region"
+
+        for threads in (0, 2):
+            with VideoCapture(video_path, crop=(x, y, w, h), convert_threads=threads) as capture:
+                success, bgr = capture.read()
+                assert success and bgr.shape == (h, w, 3), f"convert_threads={threads}: cropped BGR frame has shape {bgr.shape}"
+                # Chroma upsampling may differ at the region border
+                diff = np.abs(bgr[2:-2, 2:-2].astype(np.int16) - full_bgr[y + 2:y + h - 2, x + 2:x + w - 2].astype(np.int16)).max()
+                assert diff <= 2, f"convert_threads={threads}: cropped BGR frame differs by {diff}"
+
+        # Odd origins of the 4:2:0 source round down to the chroma grid instead of shifting chroma against luma
+        with VideoCapture(video_path, crop=(x, y, w, h)) as even_capture, \
+             VideoCapture(video_path, crop=(x + 1, y + 1, w, h)) as odd_capture:
+            _, even_bgr = even_capture.read()
+            _, odd_bgr = odd_capture.read()
+            assert np.array_equal(odd_bgr, even_bgr), "Crop with odd origin is not the region at the rounded-down origin"
+
+        # Crop, then letterbox into the target size keeping the region aspect ratio
+        with VideoCapture(video_path, width, height, crop=(x, y, w, h)) as capture:
+            success, frame = capture.read()
+            assert success and frame.shape == (height, width, 3), "Cropped and resized frame has wrong shape"
+            # The region is wider than the square target, so the border is on top
+            assert w / h > width / height and not frame[0].any(), "Letterbox border missing above the cropped region"
+
+        # Regions outside the frame do not open, malformed ones are rejected
+        assert not VideoCapture(video_path, crop=(frame_width - 8, 0, 16, 16)).isOpened(), "Crop outside the frame opened"
+        try:
+            VideoCapture(video_path, crop=(0, 0, 16))
+            assert False, "Malformed crop accepted"
+        except ValueError:
+            pass
+
+        print(f"✓ Crop test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in crop test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_lowres_decoding(video_path, width=320, height=320):
+    """Test decoder-side downscale: automatic choice for a resize target and explicit factors"""
+    print(f"\n=== Testing Lowres Decoding ===")
+
+    try:
+        with VideoCapture(video_path) as capture:
+            frame_width = int(capture.get(CAP_PROP_FRAME_WIDTH))
+            frame_height = int(capture.get(CAP_PROP_FRAME_HEIGHT))
+
+        # Automatic factor never changes the output geometry, only its cost
+        with VideoCapture(video_path, width, height) as full_capture, \
+             VideoCapture(video_path, width, height, lowres="auto") as lowres_capture:
+            for i in range(3):
+                _, full = full_capture.read()
+                success, reduced = lowres_capture.read()
+                assert success and reduced.shape == full.shape, f"Frame {i}: lowres='auto' changed the shape to {reduced.shape}"
+                assert np.abs(reduced.astype(np.int16) - full.astype(np.int16)).mean() < 8, f"Frame {i}: lowres='auto' frame differs too much"
+
+        # Explicit factor: half size where the codec supports it, full size otherwise; source size is still reported
+        with VideoCapture(video_path, lowres=1) as capture:
+            success, frame = capture.read()
+            assert success, "Read with lowres=1 failed"
+            assert frame.shape[:2] in ((frame_height, frame_width), ((frame_height + 1) // 2, (frame_width + 1) // 2)), \
+                f"lowres=1 frame has shape {frame.shape}"
+            assert int(capture.get(CAP_PROP_FRAME_WIDTH)) == frame_width, "lowres changed the reported source width"
+
+        try:
+            VideoCapture(video_path, lowres="half")
+            assert False, "Invalid lowres accepted"
+        except ValueError:
+            pass
+
+        print(f"✓ Lowres decoding test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in lowres decoding test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_memory_input(video_path, width=640, height=640, frame_total=10):
+    """Test demuxing from an in-memory buffer and from a memory-mapped file against regular file reads"""
+    print(f"\n=== Testing Memory Input ===")
+
+    try:
+        with open(video_path, "rb") as f:
+            blob = bytearray(f.read())
+
+        with VideoCapture(video_path, width, height) as capture:
+            expected = [capture.read()[1] for _ in range(frame_total)]
+
+        for name in ("bytes", "memoryview", "bytearray"):
+            data = {"bytes": bytes(blob), "memoryview": memoryview(blob), "bytearray": blob}[name]
+            capture = VideoCapture()
+            assert capture.open_from_buffer(data, width, height), f"open_from_buffer({name}) failed"
+            with capture:
+                for i in range(frame_total):
+                    success, frame = capture.read()
+                    assert success and np.array_equal(frame, expected[i]), f"{name} frame {i} differs from the file frame"
+
+        # Seeking works on the buffer like on the file
+        capture = VideoCapture()
+        assert capture.open_from_buffer(bytes(blob), width, height, prefetch=2), "open_from_buffer with prefetch failed"
+        with capture:
+            assert capture.set(CAP_PROP_POS_FRAMES, 5), "Seek in buffer failed"
+            success, frame = capture.read()
+            assert success and np.array_equal(frame, expected[5]), "Frame after seek in buffer differs"
+
+        # The buffer is released by close(): a bytearray can be resized again
+        try:
+            blob.append(0)
+        except BufferError:
+            assert False, "Buffer still exported after close()"
+
+        with VideoCapture(video_path, width, height, memory_map=True) as capture:
+            for i in range(frame_total):
+                success, frame = capture.read()
+                assert success and np.array_equal(frame, expected[i]), f"Memory-mapped frame {i} differs from the file frame"
+
+        assert not VideoCapture().open_from_buffer(b"not a video"), "Garbage buffer opened"
+        assert not VideoCapture().open_from_buffer(bytes(blob), frame_index=True), "frame_index accepted for a buffer"
+
+        print(f"✓ Memory input test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in memory input test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_fast_open(video_path, width=640, height=640, frame_total=10):
+    """Test open-time probing options: fast open without stream probing, probing limits and format hints"""
+    print(f"\n=== Testing Fast Open ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            expected = [capture.read()[1] for _ in range(frame_total)]
+            frame_count = capture.get(CAP_PROP_FRAME_COUNT)
+            fps = capture.get(CAP_PROP_FPS)
+
+        options = [dict(fast_open=True), dict(probesize=32768, analyze_duration_ms=100)]
+        if video_path.lower().endswith(".mp4"):
+            options.append(dict(fast_open=True, input_format="mp4"))
+        for kwargs in options:
+            start = time.perf_counter()
+            with VideoCapture(video_path, width, height, **kwargs) as capture:
+                open_ms = (time.perf_counter() - start) * 1000
+                assert capture.isOpened(), f"Open with {kwargs} failed"
+                assert capture.get(CAP_PROP_FRAME_COUNT) == frame_count and capture.get(CAP_PROP_FPS) == fps, \
+                    f"Stream properties differ with {kwargs}"
+                for i in range(frame_total):
+                    success, frame = capture.read()
+                    assert success and np.array_equal(frame, expected[i]), f"Frame {i} differs with {kwargs}"
+            print(f"  {kwargs}: opened in {open_ms:.1f} ms")
+
+        assert not VideoCapture(video_path, input_format="no-such-format").isOpened(), "Unknown input_format opened"
+
+        print(f"✓ Fast open test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in fast open test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_reopen(video_path, width=640, height=640, frame_total=5):
+    """Test switching segments with reopen(), keeping decoder and conversion state for identical streams"""
+    print(f"\n=== Testing Reopen ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            expected = [capture.read()[1] for _ in range(frame_total)]
+
+        for prefetch in (0, 2):
+            with VideoCapture(video_path, width, height, prefetch=prefetch) as capture:
+                for segment in range(3):
+                    if segment > 0:
+                        allocations = allocation_count()
+                        assert capture.reopen(video_path), f"prefetch={prefetch}: reopen of segment {segment} failed"
+                        # Decoder, frames and packets are kept, only the prefetch ring is refilled
+                        assert prefetch > 0 or allocation_count() == allocations, "reopen of an identical stream allocated frames"
+                    assert capture.get(CAP_PROP_POS_FRAMES) == 0, "Position does not restart with the segment"
+                    for i in range(frame_total):
+                        success, frame = capture.read()
+                        assert success and np.array_equal(frame, expected[i]), f"prefetch={prefetch}: segment {segment} frame {i} differs"
+
+        with VideoCapture(video_path) as capture:
+            assert not capture.reopen("nonexistent_file.mp4"), "reopen of a missing file succeeded"
+            assert not capture.isOpened(), "Capture still open after a failed reopen"
+        assert not VideoCapture().reopen(video_path), "reopen of a closed capture succeeded"
+
+        print(f"✓ Reopen test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in reopen test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_renditions(video_path, width=640, height=640, frame_total=5):
+    """Test several outputs converted from one decode against separate captures of each output"""
+    print(f"\n=== Testing Renditions ===")
+
+    try:
+        with VideoCapture(video_path) as capture:
+            frame_width = int(capture.get(CAP_PROP_FRAME_WIDTH))
+            frame_height = int(capture.get(CAP_PROP_FRAME_HEIGHT))
+
+        renditions = [dict(width=0, height=0), dict(width=320, height=180, letterbox=False, pixel_format="gray")]
+        with VideoCapture(video_path, width, height) as main_capture, \
+             VideoCapture(video_path) as full_capture:
+            expected = [(main_capture.read()[1], full_capture.read()[1]) for _ in range(frame_total)]
+
+        for prefetch in (0, 2):
+            with VideoCapture(video_path, width, height, renditions=renditions, prefetch=prefetch) as capture:
+                for i in range(frame_total):
+                    success, frames = capture.read()
+                    assert success and isinstance(frames, tuple) and len(frames) == 3, f"Frame {i}: expected (main, full, gray) outputs"
+                    main, full, stretched = frames
+                    assert np.array_equal(main, expected[i][0]), f"prefetch={prefetch}: main output of frame {i} differs"
+                    assert full.shape == (frame_height, frame_width, 3), f"Full rendition has shape {full.shape}"
+                    assert np.abs(full.astype(np.int16) - expected[i][1].astype(np.int16)).max() <= 2, f"Full rendition of frame {i} differs"
+                    assert stretched.shape == (180, 320), f"Stretched rendition has shape {stretched.shape}"
+                    del frames, main, full, stretched
+
+            # Renditions stay valid when the main frame is released first
+            with VideoCapture(video_path, width, height, renditions=renditions, prefetch=prefetch) as capture:
+                _, (main, full, _) = capture.read()
+                del main
+                assert np.abs(full.astype(np.int16) - expected[0][1].astype(np.int16)).max() <= 2, "Rendition changed after the main frame was released"
+
+        for bad in ([dict(width=320)], [dict(pixel_format="p010le")], [dict(size=1)], "bgr24"):
+            try:
+                opened = VideoCapture(video_path, renditions=bad).isOpened()
+            except (ValueError, TypeError):
+                opened = False
+            assert not opened, f"Invalid renditions {bad} accepted"
+
+        # Checked once the decoder is open: the failed open leaves nothing half set up to read from
+        odd_capture = VideoCapture(video_path, width, height, renditions=[dict(width=320, height=240), dict(width=321, height=240, pixel_format="nv12")])
+        assert not odd_capture.isOpened(), "Capture with an odd-width NV12 rendition opened"
+        success, frame = odd_capture.read()
+        assert not success and frame is None, "Read from a failed rendition open returned a frame"
+
+        print(f"✓ Renditions test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in renditions test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_shared_memory(video_path, width=640, height=640, frame_total=10):
+    """Test publishing frames through a shared-memory ring to a subscriber in this and in another process"""
+    print(f"\n=== Testing Shared Memory Frames ===")
+
+    import subprocess
+    import threading
+
+    try:
+        name = f"dgvc_test_{os.getpid()}"
+        with VideoCapture(video_path, width, height) as capture:
+            expected = [capture.read()[1] for _ in range(frame_total)]
+
+        with VideoCapture(video_path, width, height) as capture, SharedFramePublisher(name, capture, slots=4) as publisher:
+            subscriber = SharedFrameSubscriber(name)
+            assert subscriber.isOpened(), "Subscriber could not open the ring"
+            assert subscriber.read(timeout_ms=0)[0] == 0, "Empty ring returned a frame"
+
+            # Frames in order, each a read-only view identical to a plain read
+            for i in range(frame_total // 2):
+                assert publisher.publish() == 1, f"Publishing frame {i} failed"
+                sequence, frame, timestamp = subscriber.read(timeout_ms=1000)
+                assert sequence == i + 1 == publisher.sequence, f"Frame {i} has sequence {sequence}"
+                assert np.array_equal(frame, expected[i]), f"Frame {i} differs from a plain read"
+                assert not frame.flags.writeable, "Shared frame is writable"
+                assert timestamp >= 0, "Frame without timestamp"
+
+            # Held frames pin their slots, the publisher gives up when all are held
+            del frame
+            for i in range(4):
+                assert publisher.publish() == 1, "Publishing into a free slot failed"
+            held = [subscriber.read(timeout_ms=1000)[1] for _ in range(4)]
+            assert publisher.publish(timeout_ms=10) == 0, "Publisher overwrote a held frame"
+            assert np.array_equal(held[-1], expected[frame_total // 2 + 3]), "Held frame changed"
+            del held
+            assert publisher.publish(timeout_ms=0) == 1, "Released slots were not reused"
+
+            # Another process reads the newest frame and checks it against the same frame read here
+            script = ("import sys, numpy as np\n"
+                      "from degirum_video_capture import SharedFrameSubscriber\n"
+                      f"s = SharedFrameSubscriber('{name}')\n"
+                      "sequence, frame, _ = s.read(timeout_ms=5000, latest=True)\n"
+                      "print(sequence, int(frame.astype(np.int64).sum()), frame.shape)\n")
+            result = subprocess.run([sys.executable, "-c", script], capture_output=True, text=True, timeout=60)
+            assert result.returncode == 0, f"Subscriber process failed: {result.stderr}"
+            sequence, checksum = (int(v) for v in result.stdout.split()[:2])
+            assert sequence == publisher.sequence, f"Subscriber process read sequence {sequence}"
+            assert checksum == int(expected[sequence - 1].astype(np.int64).sum()), "Subscriber process read different pixels"
+
+        # Closed publisher: frames left are read, then end of stream; the name is gone
+        sequence, _, _ = subscriber.read(timeout_ms=1000)
+        while sequence > 0:
+            sequence, _, _ = subscriber.read(timeout_ms=1000)
+        assert sequence == -1, "Closed ring did not report end of stream"
+        subscriber.close()
+        assert not SharedFrameSubscriber(name).isOpened(), "Closed ring can still be opened"
+
+        # A publish() waiting without limit for a slot a subscriber never releases (e.g. crashed) ends on close()
+        with VideoCapture(video_path, width, height) as capture:
+            publisher = SharedFramePublisher(name, capture, slots=1)
+            subscriber = SharedFrameSubscriber(name)
+            assert publisher.publish() == 1, "Publishing into the only slot failed"
+            held = subscriber.read(timeout_ms=1000)[1]
+            results = []
+            waiter = threading.Thread(target=lambda: results.append(publisher.publish()))
+            waiter.start()
+            time.sleep(0.1)
+            assert waiter.is_alive() and publisher.isOpened() and publisher.sequence == 1, "Publisher state unreadable while publish() waits"
+            publisher.close()
+            waiter.join(timeout=5)
+            assert not waiter.is_alive() and results == [-1], f"Waiting publish() did not end on close: {results}"
+            del held
+            subscriber.close()
+
+        try:
+            SharedFramePublisher("bad/name", VideoCapture(video_path))
+            assert False, "Invalid ring name accepted"
+        except RuntimeError:
+            pass
+
+        print(f"✓ Shared memory test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in shared memory test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_stats(video_path, width=640, height=640, frame_total=10):
+    """Test per-stage counters against the frames read with subsampling"""
+    print(f"\n=== Testing Stage Statistics ===")
+
+    try:
+        with VideoCapture(video_path, width, height, frame_step=2) as capture:
+            if not capture.stats():
+                assert capture.get(CAP_PROP_FRAMES_DECODED) == -1, "Compiled-out statistics should read -1"
+                print(f"✓ Statistics compiled out, skipped")
+                return True
+
+            assert capture.stats()["frames_converted"] == 0, "Counters should start at zero"
+            for _ in range(frame_total):
+                assert capture.read()[0], "Failed to read frame"
+            stats = capture.stats()
+
+            assert stats["frames_converted"] == frame_total == capture.get(CAP_PROP_FRAMES_CONVERTED), f"frames_converted is {stats['frames_converted']}"
+            assert stats["frames_dropped"] == frame_total - 1 == capture.get(CAP_PROP_FRAMES_DROPPED), f"frames_dropped is {stats['frames_dropped']}"
+            assert stats["frames_decoded"] == 2 * frame_total - 1 == capture.get(CAP_PROP_FRAMES_DECODED), f"frames_decoded is {stats['frames_decoded']}"
+            assert stats["packets_read"] >= stats["frames_decoded"] and stats["bytes_read"] > 0, "Packets were not counted"
+            for stage in ("decode", "convert"):
+                latency = stats[stage]
+                assert latency["count"] > 0 and latency["total_ms"] > 0, f"No {stage} time recorded"
+                assert 0 < latency["p50_us"] <= latency["p99_us"] <= latency["max_us"], f"Inconsistent {stage} percentiles {latency}"
+                assert sum(count for _, count in latency["histogram"]) == latency["count"], f"{stage} histogram does not add up"
+            assert capture.get(CAP_PROP_DECODE_MSEC) == stats["decode"]["total_ms"], "Decode time differs between get() and stats()"
+
+            # Reset starts a new measurement window
+            capture.stats(reset=True)
+            assert capture.stats()["frames_converted"] == 0, "Counters were not reset"
+            assert capture.read()[0] and capture.stats()["frames_converted"] == 1, "Counting stopped after reset"
+
+        # Prefetched reads count on the prefetch thread, groups expose each stream
+        with VideoCapture(video_path, width, height, prefetch=2, convert_threads=1) as capture:
+            for _ in range(frame_total):
+                assert capture.read()[0], "Failed to read prefetched frame"
+            assert capture.stats()["frames_converted"] >= frame_total, "Prefetched frames were not counted"
+
+        with VideoCaptureGroup(num_threads=2) as group:
+            stream_id = group.add(video_path, width, height)
+            for _ in range(frame_total):
+                assert group.read_any()[0] == stream_id, "Failed to read group frame"
+            assert group.stats(stream_id)["frames_converted"] >= frame_total, "Group stream frames were not counted"
+
+        # A latest-frame group stream nobody reads evicts its stale frames, counted as drops of the stream
+        with VideoCaptureGroup(num_threads=1, queue_depth=1) as group:
+            stream_id = group.add(video_path, width, height, latest_frame=True)
+            deadline = time.time() + 10
+            while group.stats(stream_id)["frames_converted"] < 3 and time.time() < deadline:
+                time.sleep(0.01)
+            stats = group.stats(stream_id)
+            assert 1 <= stats["frames_dropped"] < stats["frames_converted"], f"Group stream dropped {stats['frames_dropped']} of {stats['frames_converted']} frames"
+            assert group.get(stream_id, CAP_PROP_FRAMES_DROPPED) >= stats["frames_dropped"], "Group drops differ between get() and stats()"
+
+        print(f"✓ Stage statistics test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in stage statistics test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_thread_options(video_path, width=640, height=640, frame_total=10):
+    """Test decoder threading models and CPU affinity of the capture threads"""
+    print(f"\n=== Testing Threading Options ===")
+
+    try:
+        with VideoCapture(video_path, width, height) as capture:
+            expected = [capture.read()[1].copy() for _ in range(frame_total)]
+
+        # Threading model and pinning change where frames are decoded, not the frames
+        variants = [
+            dict(decoder_threads=1, thread_type="frame"),
+            dict(decoder_threads=2, thread_type="slice"),
+            dict(decoder_threads=2, thread_type="frame+slice", cpu_affinity=[0]),
+            dict(cpu_affinity=[0], prefetch=2, convert_threads=2),
+        ]
+        for variant in variants:
+            with VideoCapture(video_path, width, height, **variant) as capture:
+                assert capture.isOpened(), f"Failed to open with {variant}"
+                for i in range(frame_total):
+                    ret, frame = capture.read()
+                    assert ret and np.array_equal(frame, expected[i]), f"Frame {i} differs with {variant}"
+
+        # Nodes and CPUs the system does not have fail the open
+        assert not VideoCapture(video_path, width, height, numa_node=4095).isOpened(), "Missing NUMA node should fail the open"
+        assert not VideoCapture(video_path, width, height, cpu_affinity=[100000]).isOpened(), "Missing CPU should fail the open"
+        try:
+            VideoCapture(video_path, width, height, thread_type="fast")
+            assert False, "Unknown thread_type should be rejected"
+        except ValueError:
+            pass
+
+        # Group streams keep their own decoder threads and affinity
+        with VideoCaptureGroup(num_threads=2, decoder_threads=1) as group:
+            heavy = group.add(video_path, width, height, decoder_threads=2, cpu_affinity=[0])
+            light = group.add(video_path, width, height)
+            assert heavy >= 0 and light >= 0, "Failed to add group streams"
+            frames = {heavy: 0, light: 0}
+            while min(frames.values()) < frame_total:
+                stream_id, frame = group.read_any()
+                assert frame is not None, "Failed to read group frame"
+                if frames[stream_id] < frame_total:
+                    assert np.array_equal(frame, expected[frames[stream_id]]), f"Frame of stream {stream_id} differs"
+                frames[stream_id] += 1
+
+        print(f"✓ Threading options test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in threading options test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
+def test_color_convert(video_path, width=640, height=640, frame_total=3):
+    """Test unscaled YUV -> BGR/RGB conversion against a reference transform of the decoded planes"""
+    print(f"\n=== Testing Color Conversion ===")
+
+    # YUV -> RGB matrix (Kr, Kb) by colorspace tag, untagged and SD sources use BT.601
+    matrices = {1: (0.2126, 0.0722), 9: (0.2627, 0.0593), 10: (0.2627, 0.0593)}
+
+    def reference(y, u, v, kr, kb, full_range):
+        # Chroma of each pixel pair is the co-sited sample, as in the unscaled conversion
+        u = np.repeat(np.repeat(u, 2, axis=0), 2, axis=1)[:y.shape[0], :y.shape[1]].astype(np.float64) - 128
+        v = np.repeat(np.repeat(v, 2, axis=0), 2, axis=1)[:y.shape[0], :y.shape[1]].astype(np.float64) - 128
+        if full_range:
+            luma, chroma_scale = y.astype(np.float64), 2.0
+        else:
+            luma, chroma_scale = (y.astype(np.float64) - 16) * 255 / 219, 255 / 112
+        kg = 1 - kr - kb
+        r = luma + v * chroma_scale * (1 - kr)
+        b = luma + u * chroma_scale * (1 - kb)
+        g = luma - (u * chroma_scale * (1 - kb) * kb + v * chroma_scale * (1 - kr) * kr) / kg
+        return np.clip(np.rint(np.stack([b, g, r], axis=-1)), 0, 255).astype(np.int16)
+
+    try:
+        with VideoCapture(video_path, pixel_format="yuv420p") as yuv_capture, \
+             VideoCapture(video_path) as bgr_capture, \
+             VideoCapture(video_path, pixel_format="rgb24") as rgb_capture:
+            kr, kb = matrices.get(int(bgr_capture.get(CAP_PROP_COLORSPACE)), (0.299, 0.114))
+            full_range = int(bgr_capture.get(CAP_PROP_COLOR_RANGE)) == 2
+            for i in range(frame_total):
+                _, (y, u, v) = yuv_capture.read()
+                _, bgr = bgr_capture.read()
+                _, rgb = rgb_capture.read()
+                assert bgr.shape == y.shape + (3,), f"Frame {i}: BGR frame has shape {bgr.shape}"
+                assert np.array_equal(rgb, bgr[:, :, ::-1]), f"Frame {i}: RGB24 frame is not the channel-swapped BGR24 frame"
+
+                diff = np.abs(bgr.astype(np.int16) - reference(y, u, v, kr, kb, full_range)).max()
+                assert diff <= 2, f"Frame {i}: BGR frame differs from the {kr, kb} {'full' if full_range else 'limited'} range reference by {diff}"
+
+        # Unscaled crop converts the same region of the frame
+        with VideoCapture(video_path) as capture:
+            _, full_bgr = capture.read()
+        frame_height, frame_width = full_bgr.shape[:2]
+        x, y = frame_width // 4 & ~1, frame_height // 4 & ~1
+        w, h = frame_width // 2 & ~1, frame_height // 3 & ~1
+        with VideoCapture(video_path, crop=(x, y, w, h)) as capture:
+            success, bgr = capture.read()
+            assert success and np.array_equal(bgr, full_bgr[y:y + h, x:x + w]), "Cropped BGR frame differs from the full frame region"
+
+        print(f"✓ Color conversion test passed")
+        return True
+
+    except Exception as e:
+        print(f"✗ Error in color conversion test: {e}")
+        import traceback
+        traceback.print_exc()
+        return False
+
+
 def test_fps_benchmark(video_path, width=640, height=640):
     """Test FPS performance benchmark"""
     print(f"\n=== Testing FPS Performance ===")
@@ -224,6 +1473,31 @@ def main():
     all_passed &= test_video_reading(video_path)
     all_passed &= test_context_manager(video_path)
     all_passed &= test_manual_reading(video_path)
+    all_passed &= test_prefetch_reading(video_path)
+    all_passed &= test_batch_reading(video_path)
+    all_passed &= test_read_into(video_path)
+    all_passed &= test_tensor_output(video_path)
+    all_passed &= test_pixel_formats(video_path)
+    all_passed &= test_seeking(video_path)
+    all_passed &= test_frame_index(video_path)
+    all_passed &= test_frame_subsampling(video_path)
+    all_passed &= test_live_mode(video_path)
+    all_passed &= test_reconnect(video_path)
+    all_passed &= test_capture_group(video_path)
+    all_passed &= test_pipelined_conversion(video_path)
+    all_passed &= test_threaded_reading(video_path)
+    all_passed &= test_steady_state_allocations(video_path)
+    all_passed &= test_async_reading(video_path)
+    all_passed &= test_crop(video_path)
+    all_passed &= test_lowres_decoding(video_path)
+    all_passed &= test_memory_input(video_path)
+    all_passed &= test_fast_open(video_path)
+    all_passed &= test_reopen(video_path)
+    all_passed &= test_renditions(video_path)
+    all_passed &= test_shared_memory(video_path)
+    all_passed &= test_stats(video_path)
+    all_passed &= test_thread_options(video_path)
+    all_passed &= test_color_convert(video_path)
     all_passed &= test_fps_benchmark(video_path)
     
     # Summary